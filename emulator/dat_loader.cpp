@@ -0,0 +1,353 @@
+#include "dat_loader.h"
+
+#include <iostream>
+#include <charconv>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+const char BINARY_MAGIC[8] = {'R', 'V', 'D', 'A', 'T', 'B', 'N', '1'};
+const uint32_t BINARY_VERSION = 1;
+
+struct BinaryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t frameCount;
+    uint64_t pointCount;
+    uint64_t sourceBytes;     // Size of the .dat it was made from (0 = unknown)
+    int64_t sourceMtimeNs;    // Its modification time
+};
+
+static_assert(sizeof(BinaryHeader) == 48, "binary header is 48 bytes");
+static_assert(sizeof(DatFrame) == 40, "frames are 40 bytes");
+static_assert(sizeof(DatPoint) == 12, "points are 3 floats");
+
+// Roughly the shortest text one point takes ("1.5,2.5,3.5;" and up)
+const size_t MIN_TEXT_BYTES_PER_POINT = 24;
+
+bool statFile(const std::string& path, uint64_t& bytes, int64_t& mtimeNs)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    bytes = static_cast<uint64_t>(st.st_size);
+    mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    return true;
+}
+
+// --------------------------------------------------------------------
+// Parse one float at p, skipping leading blanks and a '+' like std::stof.
+// Advances p past the number; false if there is none.
+// --------------------------------------------------------------------
+inline bool parseFloat(const char*& p, const char* end, float& value)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        ++p;
+    }
+    if (p < end && *p == '+') {
+        ++p;
+    }
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    p = result.ptr;
+    return true;
+}
+
+// Skip blanks, then expect sep
+inline bool expect(const char*& p, const char* end, char sep)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        ++p;
+    }
+    if (p < end && *p == sep) {
+        ++p;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+DatFile::DatFile()
+    : frames_(nullptr), points_(nullptr), frameCount_(0), pointCount_(0), skippedLines_(0),
+      mapping_(nullptr), mappedBytes_(0)
+{
+}
+
+DatFile::~DatFile()
+{
+    reset();
+}
+
+void DatFile::reset()
+{
+    if (mapping_ != nullptr) {
+        munmap(mapping_, mappedBytes_);
+        mapping_ = nullptr;
+        mappedBytes_ = 0;
+    }
+    ownedFrames_.clear();
+    ownedPoints_.clear();
+    frames_ = nullptr;
+    points_ = nullptr;
+    frameCount_ = 0;
+    pointCount_ = 0;
+    skippedLines_ = 0;
+}
+
+bool DatFile::mapFile(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Error: cannot open data file " << path << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        std::cerr << "Error: cannot stat data file " << path << ": " << strerror(errno) << "\n";
+        close(fd);
+        return false;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return true;   // Empty file: no frames
+    }
+
+    size_t bytes = static_cast<size_t>(st.st_size);
+    void* mapping = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);   // The mapping keeps the file open
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Error: cannot map data file " << path << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    madvise(mapping, bytes, MADV_SEQUENTIAL);
+
+    mapping_ = mapping;
+    mappedBytes_ = bytes;
+    return true;
+}
+
+bool DatFile::load(const std::string& path)
+{
+    reset();
+    if (!mapFile(path)) {
+        return false;
+    }
+    if (mapping_ == nullptr) {
+        return true;
+    }
+
+    if (mappedBytes_ >= sizeof(BINARY_MAGIC) && memcmp(mapping_, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0) {
+        return useBinary(path);
+    }
+
+    // Text: parse out of the mapping, then drop it
+    const char* text = static_cast<const char*>(mapping_);
+    bool ok = parseText(text, text + mappedBytes_);
+    munmap(mapping_, mappedBytes_);
+    mapping_ = nullptr;
+    mappedBytes_ = 0;
+    return ok;
+}
+
+bool DatFile::useBinary(const std::string& path)
+{
+    BinaryHeader header;
+    if (mappedBytes_ < sizeof(header)) {
+        std::cerr << "Error: truncated binary data file " << path << "\n";
+        reset();
+        return false;
+    }
+    memcpy(&header, mapping_, sizeof(header));
+
+    const uint8_t* base = static_cast<const uint8_t*>(mapping_);
+    size_t framesBytes = static_cast<size_t>(header.frameCount) * sizeof(DatFrame);
+    size_t pointsBytes = static_cast<size_t>(header.pointCount) * sizeof(DatPoint);
+    if (header.version != BINARY_VERSION ||
+        mappedBytes_ != sizeof(header) + framesBytes + pointsBytes) {
+        std::cerr << "Error: binary data file " << path << " has the wrong version or size\n";
+        reset();
+        return false;
+    }
+
+    frames_ = reinterpret_cast<const DatFrame*>(base + sizeof(header));
+    points_ = reinterpret_cast<const DatPoint*>(base + sizeof(header) + framesBytes);
+    frameCount_ = static_cast<size_t>(header.frameCount);
+    pointCount_ = static_cast<size_t>(header.pointCount);
+
+    for (size_t i = 0; i < frameCount_; ++i) {
+        if (frames_[i].firstPoint + frames_[i].pointCount > pointCount_) {
+            std::cerr << "Error: binary data file " << path << " is corrupt\n";
+            reset();
+            return false;
+        }
+    }
+    // Streamed front to back from here on
+    madvise(mapping_, mappedBytes_, MADV_SEQUENTIAL);
+    return true;
+}
+
+bool DatFile::loadPreferBinary(const std::string& datPath)
+{
+    std::string binaryPath = binaryPathFor(datPath);
+    uint64_t sourceBytes = 0;
+    int64_t sourceMtimeNs = 0;
+    uint64_t binaryBytes = 0;
+    int64_t binaryMtimeNs = 0;
+
+    if (statFile(binaryPath, binaryBytes, binaryMtimeNs) && binaryBytes >= sizeof(BinaryHeader)) {
+        // Only if it was made from the .dat as it is now (or the .dat is gone)
+        bool haveSource = statFile(datPath, sourceBytes, sourceMtimeNs);
+        int fd = open(binaryPath.c_str(), O_RDONLY | O_CLOEXEC);
+        BinaryHeader header;
+        bool fresh = fd >= 0 && pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                     memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0 &&
+                     (!haveSource || (header.sourceBytes == sourceBytes && header.sourceMtimeNs == sourceMtimeNs));
+        if (fd >= 0) {
+            close(fd);
+        }
+        if (fresh && load(binaryPath)) {
+            return true;
+        }
+    }
+    return load(datPath);
+}
+
+bool DatFile::saveBinary(const std::string& path, const std::string& sourcePath) const
+{
+    BinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.version = BINARY_VERSION;
+    header.frameCount = frameCount_;
+    header.pointCount = pointCount_;
+    if (!sourcePath.empty() && !statFile(sourcePath, header.sourceBytes, header.sourceMtimeNs)) {
+        header.sourceBytes = 0;
+        header.sourceMtimeNs = 0;
+    }
+
+    // Write to a temporary name and rename, so a reader never sees half a file
+    std::string tempPath = path + ".tmp";
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: cannot create " << tempPath << ": " << strerror(errno) << "\n";
+        return false;
+    }
+
+    struct Part {
+        const void* data;
+        size_t bytes;
+    };
+    const Part parts[] = {
+        {&header, sizeof(header)},
+        {frames_, frameCount_ * sizeof(DatFrame)},
+        {points_, pointCount_ * sizeof(DatPoint)}
+    };
+    for (const Part& part : parts) {
+        const char* p = static_cast<const char*>(part.data);
+        size_t left = part.bytes;
+        while (left > 0) {
+            ssize_t written = write(fd, p, left);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "Error: cannot write " << tempPath << ": " << strerror(errno) << "\n";
+                close(fd);
+                unlink(tempPath.c_str());
+                return false;
+            }
+            p += written;
+            left -= static_cast<size_t>(written);
+        }
+    }
+
+    if (close(fd) != 0 || rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error: cannot write " << path << ": " << strerror(errno) << "\n";
+        unlink(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::string DatFile::binaryPathFor(const std::string& datPath)
+{
+    size_t dot = datPath.rfind('.');
+    size_t slash = datPath.rfind('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return datPath + ".bin";
+    }
+    return datPath.substr(0, dot) + ".bin";
+}
+
+bool DatFile::parseText(const char* begin, const char* end)
+{
+    ownedPoints_.reserve(static_cast<size_t>(end - begin) / MIN_TEXT_BYTES_PER_POINT);
+
+    const char* line = begin;
+    while (line < end) {
+        const char* newline = static_cast<const char*>(memchr(line, '\n', static_cast<size_t>(end - line)));
+        const char* lineEnd = newline != nullptr ? newline : end;
+
+        // Blank lines (or a lone '\r') are skipped silently, like the old reader
+        const char* p = line;
+        while (p < lineEnd && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            ++p;
+        }
+        if (p < lineEnd && !parseLine(line, lineEnd)) {
+            skippedLines_++;
+        }
+        line = lineEnd + 1;
+    }
+
+    frames_ = ownedFrames_.data();
+    points_ = ownedPoints_.data();
+    frameCount_ = ownedFrames_.size();
+    pointCount_ = ownedPoints_.size();
+    return true;
+}
+
+bool DatFile::parseLine(const char* begin, const char* end)
+{
+    // Pose: six comma-separated floats up to the first ';'
+    DatFrame frame;
+    const char* p = begin;
+    float* pose[6] = {&frame.posX, &frame.posY, &frame.posZ, &frame.rotX, &frame.rotY, &frame.rotZ};
+    for (int i = 0; i < 6; ++i) {
+        if (!parseFloat(p, end, *pose[i]) || (i < 5 && !expect(p, end, ','))) {
+            return false;
+        }
+    }
+    const char* semicolon = static_cast<const char*>(memchr(p, ';', static_cast<size_t>(end - p)));
+    if (semicolon == nullptr) {
+        return false;
+    }
+    p = semicolon + 1;
+
+    // Points: "x,y,z" separated by ';'; incomplete ones are skipped
+    frame.firstPoint = ownedPoints_.size();
+    while (p < end) {
+        const char* tokenEnd = static_cast<const char*>(memchr(p, ';', static_cast<size_t>(end - p)));
+        if (tokenEnd == nullptr) {
+            tokenEnd = end;
+        }
+        DatPoint point;
+        const char* q = p;
+        if (parseFloat(q, tokenEnd, point.x) && expect(q, tokenEnd, ',') &&
+            parseFloat(q, tokenEnd, point.y) && expect(q, tokenEnd, ',') &&
+            parseFloat(q, tokenEnd, point.z)) {
+            ownedPoints_.push_back(point);
+        }
+        p = tokenEnd + 1;
+    }
+    frame.pointCount = static_cast<uint32_t>(ownedPoints_.size() - frame.firstPoint);
+    ownedFrames_.push_back(frame);
+    return true;
+}
@@ -0,0 +1,93 @@
+#ifndef DAT_LOADER_H
+#define DAT_LOADER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// --------------------------------------------------------------------
+// One LiDAR point, laid out like the emulator's LidarPoint (3 floats).
+// --------------------------------------------------------------------
+struct DatPoint {
+    float x;
+    float y;
+    float z;
+};
+
+// --------------------------------------------------------------------
+// One line of a rover .dat file: the pose and where its points are.
+// --------------------------------------------------------------------
+struct DatFrame {
+    uint64_t firstPoint;   // Index of the first point in DatFile::points()
+    uint32_t pointCount;
+    float posX, posY, posZ;
+    float rotX, rotY, rotZ;
+};
+
+// --------------------------------------------------------------------
+// Whole rover data file in two flat arrays (frames and points).
+//
+// Text files (posX,posY,posZ,rotX,rotY,rotZ; x,y,z; x,y,z; ...) are
+// memory-mapped and parsed in place with std::from_chars: no getline, no
+// per-token strings. saveBinary() writes the arrays as they are to a
+// compact file; loading that maps it and uses it without parsing or
+// copying, so the emulator can stream frames straight from the page cache.
+//
+// Binary layout (this machine's byte order):
+//   header (48 bytes: magic "RVDATBN1", version, frame and point counts,
+//   size and mtime of the .dat it came from), DatFrame[frames], DatPoint[points]
+// --------------------------------------------------------------------
+class DatFile {
+public:
+    DatFile();
+    ~DatFile();
+
+    // Owns a mapping: no copies
+    DatFile(const DatFile&) = delete;
+    DatFile& operator=(const DatFile&) = delete;
+
+    // Load a text or binary file (told apart by the binary magic).
+    // Returns false with a message on stderr if it cannot be read.
+    bool load(const std::string& path);
+
+    // Load datPath's binary copy (binaryPathFor) if it was made from the
+    // current datPath, otherwise parse datPath itself.
+    bool loadPreferBinary(const std::string& datPath);
+
+    // Write frames and points in the binary format; sourcePath (optional)
+    // is the .dat it was made from, recorded for loadPreferBinary().
+    bool saveBinary(const std::string& path, const std::string& sourcePath = "") const;
+
+    // Binary copy of a .dat file: same path with the extension replaced by .bin
+    static std::string binaryPathFor(const std::string& datPath);
+
+    size_t frameCount() const { return frameCount_; }
+    const DatFrame& frame(size_t index) const { return frames_[index]; }
+    const DatPoint* points(const DatFrame& frame) const { return points_ + frame.firstPoint; }
+    size_t pointCount() const { return pointCount_; }
+
+    // Text lines that could not be parsed (skipped)
+    size_t skippedLines() const { return skippedLines_; }
+    bool isBinary() const { return mapping_ != nullptr; }
+
+private:
+    void reset();
+    bool mapFile(const std::string& path);
+    bool parseText(const char* begin, const char* end);
+    bool parseLine(const char* begin, const char* end);
+    bool useBinary(const std::string& path);
+
+    std::vector<DatFrame> ownedFrames_;    // Parsed from text
+    std::vector<DatPoint> ownedPoints_;
+    const DatFrame* frames_;               // Owned arrays or the mapping
+    const DatPoint* points_;
+    size_t frameCount_;
+    size_t pointCount_;
+    size_t skippedLines_;
+
+    void* mapping_;
+    size_t mappedBytes_;
+};
+
+#endif // DAT_LOADER_H
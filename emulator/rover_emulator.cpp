@@ -1,5 +1,4 @@
 #include <iostream>
-#include <fstream>
 #include <string>
 #include <vector>
 #include <chrono>
@@ -9,10 +8,12 @@
 #include <cstdlib>
 #include <arpa/inet.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <random>
 
 #include "rover_profiles.h"
+#include "dat_loader.h"
 
 #define LOOPBACK_ADDR "127.0.0.1"
 
@@ -47,22 +48,93 @@ ssize_t sendUDP(int sock, const void* data, size_t dataSize, int port)
 }
 
 // --------------------------------------------------------------------
-// Helper: splits a string by delimiter (returns vector of tokens).
+// Sends several buffers to one port on localhost, up to 64 per sendmmsg
+// call (one sendto per buffer where sendmmsg is not available).
+// Returns the number of datagrams sent.
 // --------------------------------------------------------------------
-std::vector<std::string> splitString(const std::string& s, char delim)
+size_t sendUDPBatch(int sock, std::vector<struct iovec>& buffers, int port)
 {
-    std::vector<std::string> tokens;
-    size_t start = 0;
-    while (true) {
-        size_t pos = s.find(delim, start);
-        if (pos == std::string::npos) {
-            tokens.push_back(s.substr(start));
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = inet_addr(LOOPBACK_ADDR);
+
+    size_t sent = 0;
+#ifdef __linux__
+    const size_t batch = 64;
+    struct mmsghdr messages[batch];
+    while (sent < buffers.size()) {
+        size_t count = std::min(batch, buffers.size() - sent);
+        std::memset(messages, 0, sizeof(messages[0]) * count);
+        for (size_t i = 0; i < count; ++i) {
+            messages[i].msg_hdr.msg_name = &addr;
+            messages[i].msg_hdr.msg_namelen = sizeof(addr);
+            messages[i].msg_hdr.msg_iov = &buffers[sent + i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        int n = sendmmsg(sock, messages, static_cast<unsigned int>(count), 0);
+        if (n <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(n);
+    }
+#else
+    for (const struct iovec& buffer : buffers) {
+        if (sendto(sock, buffer.iov_base, buffer.iov_len, 0,
+                   reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
             break;
         }
-        tokens.push_back(s.substr(start, pos - start));
-        start = pos + 1;
+        sent++;
     }
-    return tokens;
+#endif
+    return sent;
+}
+
+// --------------------------------------------------------------------
+// Reads every pending 1-byte button command (non-blocking); the newest
+// one wins. Returns true if at least one arrived.
+// --------------------------------------------------------------------
+bool receiveCommands(int cmdSock, uint8_t& buttonStates)
+{
+    bool received = false;
+    uint8_t cmdByte = 0;
+    while (recv(cmdSock, &cmdByte, 1, MSG_DONTWAIT) == 1) {
+        buttonStates = cmdByte;
+        received = true;
+    }
+    return received;
+}
+
+// --------------------------------------------------------------------
+// Stress-test settings (defaults reproduce the normal emulator).
+// --------------------------------------------------------------------
+struct StressOptions {
+    double rateHz = 10.0;         // Frames per second
+    int pointMultiplier = 1;      // Each point sent this many times (jittered copies)
+    bool loop = false;            // Start over at the end of the data
+    double durationSec = 0.0;     // Stop after this long (0 = end of data)
+    double dropRate = 0.0;        // Probability a LiDAR chunk is not sent
+    double reorderRate = 0.0;     // Probability a chunk swaps with one of the next 4
+    double duplicateRate = 0.0;   // Probability a chunk is sent twice
+};
+
+// --------------------------------------------------------------------
+// Reads the value after a "--flag value" argument; false if missing.
+// --------------------------------------------------------------------
+bool flagValue(int argc, char** argv, int& i, double& value)
+{
+    if (i + 1 >= argc) {
+        std::cerr << "Error: " << argv[i] << " needs a value\n";
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtod(argv[++i], &end);
+    if (end == argv[i] || *end != '\0') {
+        std::cerr << "Error: bad value for " << argv[i - 1] << ": " << argv[i] << "\n";
+        return false;
+    }
+    return true;
 }
 
 // --------------------------------------------------------------------
@@ -111,96 +183,93 @@ struct VehicleTelem {
 };
 #pragma pack(pop)
 
-// --------------------------------------------------------------------
-// parseLine: Given a single line from the data file, parse the pose
-// and the list of LiDAR points.
-//
-// Format: posX,posY,posZ,rotX,rotY,rotZ; x1,y1,z1; x2,y2,z2; ...
-// --------------------------------------------------------------------
-bool parseLine(const std::string& line,
-               float& posX, float& posY, float& posZ,
-               float& rotX, float& rotY, float& rotZ,
-               std::vector<LidarPoint>& cloud)
-{
-    // 1) Split at the first semicolon to separate "pose" from "points"
-    size_t semicolonPos = line.find(';');
-    if (semicolonPos == std::string::npos) {
-        std::cerr << "Invalid line (no semicolon): " << line << std::endl;
-        return false;
-    }
-
-    std::string posePart = line.substr(0, semicolonPos);
-    std::string pointsPart = line.substr(semicolonPos + 1);
-
-    // 2) Parse the pose part (posX,posY,posZ,rotX,rotY,rotZ)
-    {
-        std::vector<std::string> poseTokens = splitString(posePart, ',');
-        if (poseTokens.size() < 6) {
-            std::cerr << "Invalid pose part: " << posePart << std::endl;
-            return false;
-        }
-        posX = std::stof(poseTokens[0]);
-        posY = std::stof(poseTokens[1]);
-        posZ = std::stof(poseTokens[2]);
-        rotX = std::stof(poseTokens[3]);
-        rotY = std::stof(poseTokens[4]);
-        rotZ = std::stof(poseTokens[5]);
-    }
-
-    // 3) Parse the rest of the line for points, each separated by ';'
-    std::vector<std::string> pointTokens = splitString(pointsPart, ';');
-    cloud.clear();
-    cloud.reserve(pointTokens.size());
-
-    for (const auto& pt : pointTokens) {
-        // Each pt is "x,y,z"
-        std::vector<std::string> coords = splitString(pt, ',');
-        if (coords.size() < 3) {
-            // Possibly last empty token?
-            continue;
-        }
-        LidarPoint p;
-        p.x = std::stof(coords[0]);
-        p.y = std::stof(coords[1]);
-        p.z = std::stof(coords[2]);
-        cloud.push_back(p);
-    }
-
-    return true;
-}
+// The loader's points are sent as they are
+static_assert(sizeof(DatPoint) == sizeof(LidarPoint), "DatPoint must match LidarPoint");
 
 int main(int argc, char** argv)
 {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <ROVER_ID>\n";
+        std::cerr << "Usage: " << argv[0] << " <ROVER_ID> [--no-noise] [--convert] [stress options]\n";
+        std::cerr << "  --convert          write the rover's data as a binary file (streamed from then on) and exit\n";
+        std::cerr << "Stress options:\n";
+        std::cerr << "  --rate HZ          frames per second (default 10)\n";
+        std::cerr << "  --points N         send every point N times (jittered copies)\n";
+        std::cerr << "  --loop             start over at the end of the data\n";
+        std::cerr << "  --duration S       stop after S seconds\n";
+        std::cerr << "  --drop P           drop LiDAR chunks with probability P\n";
+        std::cerr << "  --reorder P        swap chunks with a nearby later one with probability P\n";
+        std::cerr << "  --duplicate P      send chunks twice with probability P\n";
+        std::cerr << "ROVER_ID 1-5 use the listed profiles; 6-999 are synthetic rovers on ports 9000+N, 10000+N, 11000+N\n";
         return 1;
     }
     std::string roverID = argv[1];
 
-    // Look up the rover's profile
-    auto it = g_roverProfiles.find(roverID);
-    if (it == g_roverProfiles.end()) {
+    // Look up the rover's profile (generated for synthetic rovers)
+    RoverProfile profile;
+    if (!findRoverProfile(roverID, profile)) {
         std::cerr << "Error: No profile found for rover ID: " << roverID << "\n";
         return 1;
     }
-    RoverProfile profile = it->second;
 
     bool noNoise = false;
+    bool convert = false;
+    StressOptions stress;
     for (int i = 2; i < argc; i++) {
-        if (std::string(argv[i]) == "--no-noise") {
+        std::string arg = argv[i];
+        double value = 0.0;
+        if (arg == "--no-noise") {
             noNoise = true;
+        } else if (arg == "--convert") {
+            convert = true;
+        } else if (arg == "--loop") {
+            stress.loop = true;
+        } else if (arg == "--rate" || arg == "--points" || arg == "--duration" ||
+                   arg == "--drop" || arg == "--reorder" || arg == "--duplicate") {
+            if (!flagValue(argc, argv, i, value)) {
+                return 1;
+            }
+            if (arg == "--rate") stress.rateHz = value;
+            else if (arg == "--points") stress.pointMultiplier = static_cast<int>(value);
+            else if (arg == "--duration") stress.durationSec = value;
+            else if (arg == "--drop") stress.dropRate = value;
+            else if (arg == "--reorder") stress.reorderRate = value;
+            else stress.duplicateRate = value;
+        } else {
+            std::cerr << "Error: unknown option " << arg << "\n";
+            return 1;
         }
     }
+    if (stress.rateHz <= 0.0 || stress.pointMultiplier < 1) {
+        std::cerr << "Error: --rate must be positive and --points at least 1\n";
+        return 1;
+    }
 
     static std::default_random_engine rng(std::random_device{}());
     std::normal_distribution<float> dist(0.0f, 0.5f);
 
-    // Open the data file
-    std::ifstream fin(profile.dataFile);
-    if (!fin.is_open()) {
-        std::cerr << "Error: cannot open data file: " << profile.dataFile << "\n";
+    // Load the whole data file up front (binary copy if there is a current one)
+    DatFile data;
+    auto loadStart = std::chrono::steady_clock::now();
+    bool loaded = convert ? data.load(profile.dataFile) : data.loadPreferBinary(profile.dataFile);
+    if (!loaded) {
         return 1;
     }
+    std::chrono::duration<double> loadTime = std::chrono::steady_clock::now() - loadStart;
+    std::cout << "Rover " << roverID << ": " << data.frameCount() << " frames, " << data.pointCount()
+              << " points loaded from " << (data.isBinary() ? "binary copy of " : "") << profile.dataFile
+              << " in " << loadTime.count() << " s\n";
+    if (data.skippedLines() > 0) {
+        std::cerr << "Skipped " << data.skippedLines() << " lines that failed to parse.\n";
+    }
+
+    if (convert) {
+        std::string binaryPath = DatFile::binaryPathFor(profile.dataFile);
+        if (!data.saveBinary(binaryPath, profile.dataFile)) {
+            return 1;
+        }
+        std::cout << "Wrote " << binaryPath << "\n";
+        return 0;
+    }
 
     // Create UDP sockets for sending pose & LiDAR
     int udpSockPose  = createUDPSocket();
@@ -227,29 +296,50 @@ int main(int argc, char** argv)
 
     uint8_t buttonStates = 0;
 
-    const double freqHz = 10.0;
-    const std::chrono::milliseconds loopDelayMs((int)(1000.0 / freqHz));
+    // Frames are scheduled on a fixed grid, so slow frames do not shift the rest
+    const std::chrono::nanoseconds period(static_cast<int64_t>(1e9 / stress.rateHz));
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    std::uniform_real_distribution<float> jitter(-0.05f, 0.05f);
 
     auto startTime = std::chrono::steady_clock::now();
+    auto nextFrame = startTime;
+
+    // Per-frame buffers, reused: points to send, chunk packets, send order
+    std::vector<LidarPoint> cloud;
+    std::vector<LidarPacket> packets;
+    std::vector<size_t> order;
+    std::vector<struct iovec> buffers;
 
-    // Read line by line
-    std::string line;
-    while (true) {
-        if (!std::getline(fin, line)) {
-            // End of file
+    size_t framesSent = 0, chunksSent = 0, chunksDropped = 0, chunksReordered = 0, chunksDuplicated = 0;
+    size_t framesLate = 0;
+
+    for (size_t frameIndex = 0; frameIndex < data.frameCount(); ++frameIndex) {
+        std::chrono::duration<double> running = std::chrono::steady_clock::now() - startTime;
+        if (stress.durationSec > 0.0 && running.count() >= stress.durationSec) {
             break;
         }
-        if (line.empty()) {
-            continue;
-        }
-
-        float posX=0, posY=0, posZ=0;
-        float rotX=0, rotY=0, rotZ=0;
-        std::vector<LidarPoint> cloud;
 
-        if (!parseLine(line, posX, posY, posZ, rotX, rotY, rotZ, cloud)) {
-            std::cerr << "Failed to parse line.\n";
-            continue;
+        const DatFrame& frame = data.frame(frameIndex);
+        float posX = frame.posX, posY = frame.posY, posZ = frame.posZ;
+        float rotX = frame.rotX, rotY = frame.rotY, rotZ = frame.rotZ;
+        const LidarPoint* points = reinterpret_cast<const LidarPoint*>(data.points(frame));
+        size_t totalPoints = frame.pointCount;
+
+        // Denser clouds: extra copies of each point, a few cm apart
+        if (stress.pointMultiplier > 1) {
+            cloud.clear();
+            for (size_t i = 0; i < frame.pointCount; ++i) {
+                cloud.push_back(points[i]);
+                for (int copy = 1; copy < stress.pointMultiplier; ++copy) {
+                    cloud.push_back({points[i].x + jitter(rng), points[i].y + jitter(rng), points[i].z + jitter(rng)});
+                }
+            }
+        } else if (!noNoise) {
+            cloud.assign(points, points + frame.pointCount);
+        }
+        if (stress.pointMultiplier > 1 || !noNoise) {
+            points = cloud.data();
+            totalPoints = cloud.size();
         }
 
         // Inject noise if !noNoise:
@@ -286,13 +376,12 @@ int main(int argc, char** argv)
         sendUDP(udpSockPose, &posePacket, sizeof(posePacket), profile.posePort);
 
         // 3) Break the LiDAR cloud into chunks of size <= MAX_LIDAR_POINTS_PER_PACKET
-        size_t totalPoints = cloud.size();
         size_t totalChunks = (totalPoints + MAX_LIDAR_POINTS_PER_PACKET - 1) / MAX_LIDAR_POINTS_PER_PACKET;
+        packets.resize(totalChunks);
 
         // For each chunk, build a LidarPacket
         for (size_t chunkIndex = 0; chunkIndex < totalChunks; ++chunkIndex) {
-            LidarPacket packet;
-            std::memset(&packet, 0, sizeof(packet));
+            LidarPacket& packet = packets[chunkIndex];
 
             packet.header.timestamp = timestamp;
             packet.header.chunkIndex = static_cast<uint32_t>(chunkIndex);
@@ -303,40 +392,77 @@ int main(int argc, char** argv)
             size_t endIdx = std::min(startIdx + MAX_LIDAR_POINTS_PER_PACKET, totalPoints);
             size_t numPts = endIdx - startIdx;
             packet.header.pointsInThisChunk = static_cast<uint32_t>(numPts);
+            std::memcpy(packet.points, points + startIdx, numPts * sizeof(LidarPoint));
+        }
 
-            for (size_t i = 0; i < numPts; ++i) {
-                packet.points[i] = cloud[startIdx + i];
+        // Send order, with injected faults: local reordering, drops, duplicates
+        order.clear();
+        for (size_t chunkIndex = 0; chunkIndex < totalChunks; ++chunkIndex) {
+            order.push_back(chunkIndex);
+        }
+        if (stress.reorderRate > 0.0) {
+            for (size_t i = 0; i + 1 < order.size(); ++i) {
+                if (chance(rng) < stress.reorderRate) {
+                    size_t j = std::min(order.size() - 1, i + 1 + static_cast<size_t>(chance(rng) * 4.0));
+                    std::swap(order[i], order[j]);
+                    chunksReordered++;
+                }
             }
-
-            // Send the packet over the LiDAR port
-            size_t packetSize = sizeof(LidarPacketHeader) + (numPts * sizeof(LidarPoint));
-            sendUDP(udpSockLidar, &packet, packetSize, profile.lidarPort);
         }
-
-        // 6) Check for incoming button command on cmdSock (non-blocking)
-        uint8_t cmdByte = 0;
-        ssize_t n = recv(cmdSock, &cmdByte, 1, MSG_DONTWAIT);
-        if (n == 1) {
-            // Update buttonStates with newly received bits
-            buttonStates = cmdByte;
+        buffers.clear();
+        for (size_t chunkIndex : order) {
+            if (stress.dropRate > 0.0 && chance(rng) < stress.dropRate) {
+                chunksDropped++;
+                continue;
+            }
+            const LidarPacket& packet = packets[chunkIndex];
+            size_t packetSize = sizeof(LidarPacketHeader) + (packet.header.pointsInThisChunk * sizeof(LidarPoint));
+            buffers.push_back({const_cast<LidarPacket*>(&packet), packetSize});
+            if (stress.duplicateRate > 0.0 && chance(rng) < stress.duplicateRate) {
+                buffers.push_back(buffers.back());
+                chunksDuplicated++;
+            }
         }
+
+        // Send the packets over the LiDAR port
+        chunksSent += sendUDPBatch(udpSockLidar, buffers, profile.lidarPort);
+
+        // 6) Pick up button commands that arrived during the frame
+        receiveCommands(cmdSock, buttonStates);
         VehicleTelem telem;
         telem.timestamp    = timestamp;
         telem.buttonStates = buttonStates;
 
         int telemPort = profile.telemPort;
         sendUDP(udpSockTelem, &telem, sizeof(telem), telemPort);
+        framesSent++;
 
-        // 4) Sleep the remainder of the 10 Hz cycle
-        std::this_thread::sleep_for(loopDelayMs);
+        if (stress.loop && frameIndex + 1 == data.frameCount()) {
+            frameIndex = static_cast<size_t>(-1);   // Next iteration starts at frame 0
+        }
+
+        // 4) Sleep the remainder of the cycle; a frame that overran starts the grid again
+        nextFrame += period;
+        auto afterSend = std::chrono::steady_clock::now();
+        if (afterSend > nextFrame) {
+            framesLate++;
+            nextFrame = afterSend;
+        } else {
+            std::this_thread::sleep_until(nextFrame);
+        }
     }
 
+    std::chrono::duration<double> total = std::chrono::steady_clock::now() - startTime;
+    std::cout << "Rover " << roverID << ": " << framesSent << " frames (" << framesSent / total.count()
+              << " Hz), " << chunksSent << " chunks sent, " << chunksDropped << " dropped, "
+              << chunksReordered << " reordered, " << chunksDuplicated << " duplicated, "
+              << framesLate << " frames late\n";
+
     // Clean up
     close(udpSockPose);
     close(udpSockLidar);
     close(udpSockTelem);
     close(cmdSock);
-    fin.close();
 
     std::cout << "Finished streaming rover " << roverID << " data.\n";
     return 0;
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <map>
+#include <cstdlib>
 
 // --------------------------------------------------------------------
 // Rover's "profile" data:
@@ -30,4 +31,28 @@ static std::map<std::string, RoverProfile> g_roverProfiles = {
     { "5", { "data/rover5.dat", 9005, 10005, 11005, 8005} }
 };
 
+// --------------------------------------------------------------------
+// Profile of any rover ID: the listed ones as above; others (synthetic
+// rovers for stress tests) get ports 9000+N, 10000+N, 11000+N, 8000+N
+// and replay one of the five data files. IDs must be 1..999.
+// --------------------------------------------------------------------
+inline bool findRoverProfile(const std::string& roverID, RoverProfile& profile)
+{
+    auto it = g_roverProfiles.find(roverID);
+    if (it != g_roverProfiles.end()) {
+        profile = it->second;
+        return true;
+    }
+
+    char* end = nullptr;
+    long id = std::strtol(roverID.c_str(), &end, 10);
+    if (end == roverID.c_str() || *end != '\0' || id < 1 || id > 999) {
+        return false;
+    }
+    int n = static_cast<int>(id);
+    profile = { "data/rover" + std::to_string((n - 1) % 5 + 1) + ".dat",
+                9000 + n, 10000 + n, 11000 + n, 8000 + n };
+    return true;
+}
+
 #endif // ROVER_PROFILES_H
\ No newline at end of file
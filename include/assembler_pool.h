@@ -0,0 +1,128 @@
+#ifndef ASSEMBLER_POOL_H
+#define ASSEMBLER_POOL_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include "lidar_assembler.h"
+#include "ingest_reactor.h"
+#include "spsc_ring.h"
+
+// One LidarAssembler shard per rover, each driven by its own worker thread
+//
+// The pool is the IngestHandler for LiDAR streams: onLidar() runs on the
+// reactor thread, copies the chunk into a preallocated inbox slot of the
+// rover's shard and wakes its worker. Rovers never share assembler state,
+// so scans with equal timestamps from different rovers cannot mix and
+// shards scale across cores. Workers are pinned to consecutive cores.
+//
+// Threading: addRover() before start(); onLidar() for a rover from one
+// thread (normally the reactor); getCompleteScan() for a rover from one
+// consumer thread. Statistics can be read from any thread.
+class AssemblerPool : public IngestHandler {
+public:
+    struct Config {
+        LidarAssembler::Config assembler;   // Per-shard assembler (roverId is set per shard)
+        size_t inboxDepth;                  // Chunks queued per shard before dropping
+        double idlePollMs;                  // Worker wake-up interval while idle (expiry)
+        bool pinWorkers;                    // Pin each worker to its own core
+        unsigned firstCore;                 // Core of the first worker (reactor keeps the ones below)
+
+        Config() : inboxDepth(256), idlePollMs(1.0), pinWorkers(true), firstCore(1) {}
+    };
+
+    // Totals over every shard
+    struct Stats {
+        size_t rovers;
+        size_t chunksReceived;
+        size_t scansCompleted;
+        size_t droppedChunks;         // Rejected by an assembler
+        size_t droppedScans;          // Evicted from a full scan queue
+        size_t partialScansEmitted;
+        size_t staleScans;
+        size_t inboxDrops;            // Chunks dropped because a worker fell behind
+        size_t unknownRoverChunks;    // Chunks for a rover without a shard
+
+        Stats() : rovers(0), chunksReceived(0), scansCompleted(0), droppedChunks(0),
+                  droppedScans(0), partialScansEmitted(0), staleScans(0), inboxDrops(0),
+                  unknownRoverChunks(0) {}
+    };
+
+    AssemblerPool();
+    explicit AssemblerPool(const Config& config);
+    ~AssemblerPool();
+
+    // Disable copy (owns threads)
+    AssemblerPool(const AssemblerPool&) = delete;
+    AssemblerPool& operator=(const AssemblerPool&) = delete;
+
+    // Create the shard for a rover (before start); false if it already exists
+    bool addRover(uint32_t roverId);
+
+    // Add a shard for every rover in g_roverProfiles
+    void addRoversFromProfiles();
+
+    // Launch one worker per shard / join them (stop() also runs on destruction)
+    void start();
+    void stop();
+    bool isRunning() const { return running_; }
+
+    // IngestHandler: hand a chunk to its rover's shard (never blocks)
+    void onLidar(uint32_t roverId, const LidarPacket& packet, uint64_t arrivalNs) override;
+
+    // Get the oldest complete scan of a rover; false if none (or unknown rover)
+    bool getCompleteScan(uint32_t roverId, ScanHandle& scan);
+
+    // Direct access to a rover's assembler (nullptr if unknown)
+    LidarAssembler* getAssembler(uint32_t roverId);
+
+    size_t getRoverCount() const { return shards_.size(); }
+    std::vector<uint32_t> getRoverIds() const;
+    Stats getStats() const;
+
+private:
+    // Chunk waiting for a worker
+    struct InboxEntry {
+        LidarPacket packet;
+        uint64_t arrivalNs;
+    };
+
+    struct Shard {
+        uint32_t roverId;
+        std::unique_ptr<LidarAssembler> assembler;
+
+        // Inbox: entries circulate reactor -> worker (filled) -> reactor (free)
+        std::vector<InboxEntry> entries;
+        SpscRing<uint32_t> filled;
+        SpscRing<uint32_t> free;
+
+        std::thread worker;
+        std::atomic<bool> sleeping;
+        std::mutex wakeMutex;
+        std::condition_variable wakeCond;
+
+        std::atomic<size_t> inboxDrops;
+
+        Shard(uint32_t id, const Config& config);
+    };
+
+    void workerLoop(Shard& shard, unsigned core);
+
+    Shard* findShard(uint32_t roverId) const {
+        return roverId < byRover_.size() ? byRover_[roverId] : nullptr;
+    }
+
+    Config config_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::vector<Shard*> byRover_;            // Indexed by rover ID
+    std::atomic<bool> stopRequested_;
+    bool running_;
+    std::atomic<size_t> unknownRoverChunks_;
+};
+
+#endif // ASSEMBLER_POOL_H
@@ -0,0 +1,168 @@
+#ifndef CHUNK_PIPELINE_H
+#define CHUNK_PIPELINE_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "udp_packet_structures.h"
+#include "ingest_reactor.h"
+#include "lidar_assembler.h"
+#include "pose_history.h"
+#include "latency_stats.h"
+
+// One LiDAR chunk in world coordinates
+// points is only valid during ChunkSink::onWorldChunk()
+struct WorldChunk {
+    uint32_t roverId;
+    double scanTimestamp;
+    uint32_t chunkIndex;
+    uint32_t totalChunks;
+    const glm::vec3* points;
+    size_t pointCount;
+    uint64_t arrivalNs;      // Kernel receive time of the chunk (CLOCK_REALTIME ns)
+};
+
+// Downstream stage (terrain, renderer) fed chunk by chunk
+// Called on the pipeline's thread; implementations must not block.
+class ChunkSink {
+public:
+    virtual ~ChunkSink() = default;
+
+    virtual void onWorldChunk(const WorldChunk& chunk) = 0;
+
+    // Every chunk of a scan has been delivered (or the scan was given up as
+    // partial); scan holds bookkeeping only, no points
+    virtual void onScanComplete(uint32_t roverId, const ScanHandle& scan) {
+        (void)roverId; (void)scan;
+    }
+};
+
+// Streaming georeferencing: each chunk goes to world coordinates on arrival
+//
+// Instead of waiting for a whole scan and transforming it in one batch, the
+// pipeline looks up the rover pose for the chunk's scan timestamp in a
+// PoseHistory, transforms the chunk's points with the batch kernel and hands
+// them to the sink straight away. A bookkeeping-only LidarAssembler per
+// rover still tracks completeness and statistics.
+//
+// Chunks are only transformed with a pose interpolated around their
+// timestamp. A chunk newer than every pose waits in a bounded per-rover
+// queue until a later pose arrives; one older than every pose is dropped.
+// Scan completions queue behind waiting chunks, so onScanComplete still
+// follows the scan's chunks; each holds an arena slot, so past
+// pendingScans of them the oldest waiting chunks are dropped to let one
+// through. Duplicate chunks are skipped.
+//
+// Use it as the IngestHandler for pose and LiDAR streams; everything runs
+// on the reactor thread and nothing allocates after addRover().
+class ChunkPipeline : public IngestHandler {
+public:
+    struct Config {
+        size_t poseHistoryCapacity;          // Poses kept per rover
+        size_t pendingChunks;                // Chunks (and scan completions) per rover waiting for a pose
+        size_t pendingScans;                 // Scan completions (arena slots) held behind them
+        LidarAssembler::Config assembler;    // Bookkeeping (retainPoints is forced off)
+
+        Config() : poseHistoryCapacity(256), pendingChunks(256), pendingScans(1) {}
+    };
+
+    // Statistics (only written by the pipeline thread)
+    struct Stats {
+        size_t chunksTransformed;
+        size_t pointsTransformed;
+        size_t chunksDeferred;       // Waited for a pose newer than the chunk
+        size_t chunksDroppedPose;    // Older than every pose, or pushed out of a full queue
+        size_t duplicateChunks;      // Already received for the scan; skipped
+        size_t unknownRoverChunks;
+
+        Stats() : chunksTransformed(0), pointsTransformed(0), chunksDeferred(0),
+                  chunksDroppedPose(0), duplicateChunks(0), unknownRoverChunks(0) {}
+    };
+
+    explicit ChunkPipeline(ChunkSink& sink);
+    ChunkPipeline(ChunkSink& sink, const Config& config);
+
+    // Disable copy (sink reference, per-rover state)
+    ChunkPipeline(const ChunkPipeline&) = delete;
+    ChunkPipeline& operator=(const ChunkPipeline&) = delete;
+
+    // Create state for a rover; false if it already exists
+    bool addRover(uint32_t roverId);
+
+    // Record ChunkToWorld latency per rover (nullptr disables)
+    // Recorder must outlive the pipeline
+    void setLatencyRecorder(LatencyRecorder* recorder) { latency_ = recorder; }
+
+    // IngestHandler
+    void onPose(uint32_t roverId, const PosePacket& pose, uint64_t arrivalNs) override;
+    void onLidar(uint32_t roverId, const LidarPacket& packet, uint64_t arrivalNs) override;
+
+    // Expire stale scans of every rover; call periodically when idle
+    void poll();
+
+    const PoseHistory* getPoseHistory(uint32_t roverId) const;
+    const LidarAssembler* getAssembler(uint32_t roverId) const;
+    const Stats& getStats() const { return stats_; }
+
+private:
+    // Chunk waiting for a pose, or (scan valid) a scan completion queued
+    // behind waiting chunks
+    struct Pending {
+        LidarPacket packet;
+        uint64_t arrivalNs;
+        ScanHandle scan;
+
+        Pending() : arrivalNs(0) {}
+    };
+
+    struct RoverState {
+        uint32_t roverId;
+        PoseHistory poses;
+        LidarAssembler assembler;
+        double lastCompleteTimestamp;    // Newest scan completed (NaN before the first)
+
+        // FIFO ring of pending entries, preallocated
+        std::vector<Pending> pending;
+        size_t pendingHead;
+        size_t pendingCount;
+        size_t pendingScans;             // Scan completions among them
+
+        RoverState(uint32_t id, const Config& config);
+    };
+
+    RoverState* findRover(uint32_t roverId) const {
+        return roverId < byRover_.size() ? byRover_[roverId] : nullptr;
+    }
+
+    // Transform a chunk with an interpolated pose and pass it to the sink
+    void forwardChunk(RoverState& rover, const LidarPacket& packet, uint64_t arrivalNs,
+                      const glm::mat4& transform);
+
+    // Pass scans the assembler finished to the sink (queued behind pending chunks)
+    void drainScans(RoverState& rover);
+
+    // Append to the pending queue; a full queue gives up its oldest entry
+    Pending& pushPending(RoverState& rover);
+
+    // Remove the oldest pending entry without waiting for its pose: a
+    // chunk is dropped, a scan completion delivered
+    void givePendingUp(RoverState& rover);
+
+    // Deliver pending entries in order until a chunk still lacks a pose
+    void drainPending(RoverState& rover);
+
+    // Remove the entry at the front of the pending queue
+    void popPending(RoverState& rover);
+
+    ChunkSink& sink_;
+    Config config_;
+    std::vector<std::unique_ptr<RoverState>> rovers_;
+    std::vector<RoverState*> byRover_;           // Indexed by rover ID
+    std::vector<glm::vec3> worldPoints_;          // One chunk of scratch
+    LatencyRecorder* latency_;
+    Stats stats_;
+};
+
+#endif // CHUNK_PIPELINE_H
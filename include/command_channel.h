@@ -0,0 +1,150 @@
+#ifndef COMMAND_CHANNEL_H
+#define COMMAND_CHANNEL_H
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <netinet/in.h>
+#include "ingest_reactor.h"
+#include "latency_stats.h"
+#include "spsc_ring.h"
+
+// Button commands to rovers, confirmed by their telemetry echo
+//
+// send() writes the 1-byte button bitmask to the rover's command port and
+// keeps it outstanding until a VehicleTelem from that rover carries the
+// same bits. The time from the first send to the kernel arrival of that
+// telemetry is the command round trip, recorded per rover as
+// LatencyStage::CommandRoundTrip. An unconfirmed command is resent every
+// ackTimeoutNs, up to maxRetries times, then given up. Rovers echo
+// commands in their per-frame telemetry (every 100 ms at 10 Hz), so the
+// default of 250 ms lets an echo arrive before the command is resent. A
+// newer command to the same rover supersedes the outstanding one. When
+// the rover already reports the commanded bits an echo cannot be told
+// apart from older telemetry, so the command is confirmed by the next
+// telemetry without a round trip being recorded.
+//
+// It is an IngestHandler that forwards every packet downstream, so it can
+// sit in front of the pipeline on the reactor. send(), poll() and the
+// handler methods run on the reactor thread; request() queues a command
+// from one other thread (e.g. the UI) for the next poll().
+class CommandChannel : public IngestHandler {
+public:
+    struct Config {
+        uint64_t ackTimeoutNs;       // Resend when not confirmed within this
+        uint32_t maxRetries;         // Resends before giving up
+        size_t requestDepth;         // Commands request() can queue between polls
+        std::string address;         // IPv4 address the rovers listen on
+
+        Config() : ackTimeoutNs(250000000), maxRetries(3), requestDepth(256), address("127.0.0.1") {}
+    };
+
+    // Statistics (only written by the reactor thread)
+    struct Stats {
+        size_t commands;             // Accepted by send()
+        size_t datagramsSent;        // First sends and resends
+        size_t retries;
+        size_t confirmed;
+        size_t unmeasured;           // Confirmed without a round trip (bits were already set)
+        size_t superseded;           // Replaced by a newer command before confirmation
+        size_t failed;               // Given up after maxRetries
+        size_t sendErrors;
+
+        Stats() : commands(0), datagramsSent(0), retries(0), confirmed(0), unmeasured(0),
+                  superseded(0), failed(0), sendErrors(0) {}
+    };
+
+    // Command state of one rover
+    struct Status {
+        bool pending;                // A command waits for its echo
+        uint8_t requested;           // Newest commanded bits
+        bool hasTelemetry;
+        uint8_t reported;            // Bits in the newest telemetry
+        uint32_t attempts;           // Datagrams sent for the newest command
+        uint64_t lastRoundTripNs;    // Newest measured round trip (0: none yet)
+
+        Status() : pending(false), requested(0), hasTelemetry(false), reported(0), attempts(0),
+                   lastRoundTripNs(0) {}
+    };
+
+    // downstream (optional) receives every packet after it is checked;
+    // it must outlive this object
+    explicit CommandChannel(IngestHandler* downstream = nullptr);
+    CommandChannel(IngestHandler* downstream, const Config& config);
+    ~CommandChannel();
+
+    // Disable copy (owns the socket)
+    CommandChannel(const CommandChannel&) = delete;
+    CommandChannel& operator=(const CommandChannel&) = delete;
+
+    // Check if the socket was created and the address parsed
+    bool isValid() const { return socket_ >= 0; }
+
+    // Start tracking a rover (its cmdPort); false if it already exists
+    bool addRover(const RoverPorts& ports);
+
+    // Record round trips per rover (nullptr disables)
+    // Recorder must outlive the channel
+    void setLatencyRecorder(LatencyRecorder* recorder) { latency_ = recorder; }
+
+    // Send a button bitmask to a rover and track it until echoed
+    // Returns false for an unknown rover or if the datagram was not sent
+    bool send(uint32_t roverId, uint8_t buttons);
+
+    // Queue send(roverId, buttons) for the next poll(); safe from one thread
+    // other than the reactor's. Returns false if the queue is full
+    bool request(uint32_t roverId, uint8_t buttons);
+
+    // Send queued requests and resend or give up overdue commands; call
+    // from the reactor loop at least every few milliseconds
+    void poll();
+
+    // IngestHandler
+    void onPose(uint32_t roverId, const PosePacket& pose, uint64_t arrivalNs) override;
+    void onLidar(uint32_t roverId, const LidarPacket& packet, uint64_t arrivalNs) override;
+    void onTelemetry(uint32_t roverId, const VehicleTelem& telem, uint64_t arrivalNs) override;
+
+    // Current state of a rover's commands; false for an unknown rover
+    bool getStatus(uint32_t roverId, Status& status) const;
+
+    size_t getPendingCount() const { return pendingCount_; }
+    size_t getRequestsDropped() const { return requestsDropped_.load(std::memory_order_relaxed); }
+    const Stats& getStats() const { return stats_; }
+
+private:
+    struct Rover {
+        uint32_t roverId;
+        struct sockaddr_in destination;
+        Status status;
+        bool measurable;             // The echo can be told apart from older telemetry
+        uint64_t firstSentNs;        // CLOCK_REALTIME of the first send (round trip start)
+        uint64_t deadlineNs;         // CLOCK_MONOTONIC time of the next resend
+    };
+
+    Rover* findRover(uint32_t roverId) const {
+        return roverId < byRover_.size() ? byRover_[roverId] : nullptr;
+    }
+
+    // Send the rover's requested bits once
+    bool transmit(Rover& rover);
+
+    // The outstanding command is no longer waited for
+    void settle(Rover& rover);
+
+    IngestHandler* downstream_;
+    Config config_;
+    int socket_;
+    struct in_addr address_;
+    std::vector<std::unique_ptr<Rover>> rovers_;
+    std::vector<Rover*> byRover_;                // Indexed by rover ID
+    size_t pendingCount_;
+    SpscRing<uint64_t> requests_;                // roverId << 8 | buttons
+    std::atomic<size_t> requestsDropped_;
+    LatencyRecorder* latency_;
+    Stats stats_;
+};
+
+#endif // COMMAND_CHANNEL_H
@@ -0,0 +1,193 @@
+#ifndef HEIGHT_MAP_H
+#define HEIGHT_MAP_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+class TileStore;
+
+// Tiled 2.5D height map of everything the rovers have scanned
+//
+// The mapped area is a square grid of fixed-size tiles centred on the world
+// origin. Tiles are allocated the first time a point lands in them, so
+// memory grows with covered ground and is bounded by the area. Every cell
+// keeps min/max height and fuses its observations into a running mean and
+// variance (Welford, O(1) per point, no raw history). Past maxFusedHits the
+// mean becomes a moving average, so dug or dumped ground is still tracked.
+//
+// A tile is listed by takeDirtyTiles() only when one of its cells is new or
+// its fused height moved since it last did by more than changeThreshold and
+// changeSigmas standard errors, so noise on ground that has converged does
+// not cause re-meshing or uploads.
+//
+// With a tile store (openStore), tiles beyond residentBudgetMB are evicted
+// least-recently-used first to a memory-mapped file and paged back in on
+// access; reopening the file later resumes the map without replaying data.
+// Tile pointers returned by the accessors are then only valid until the
+// next call that may page in a tile (insert, getTile, cellAt).
+//
+// Not thread-safe: one thread inserts and collects dirty tiles.
+class HeightMap {
+public:
+    // Which world axis is height (Transform yaws about Y, so Y is up by default)
+    enum class UpAxis : uint8_t { Y, Z };
+
+    struct Config {
+        float cellSize;          // World units per cell edge
+        uint32_t tileCells;      // Cells per tile edge
+        float extent;            // Side of the mapped square, centred on the origin
+        UpAxis upAxis;
+        float measurementSigma;  // Expected height noise of inserted points (confidence prior)
+        float changeThreshold;   // Height change that marks a cell's tile dirty...
+        float changeSigmas;      // ...and more than this many standard errors of the cell
+        uint32_t maxFusedHits;   // Fusion window; older observations fade after this
+        size_t residentBudgetMB; // With a tile store: tiles kept in memory (0 = all; at least 4 tiles)
+
+        Config() : cellSize(0.5f), tileCells(64), extent(1000.0f), upAxis(UpAxis::Y),
+                   measurementSigma(0.5f), changeThreshold(0.05f), changeSigmas(3.0f),
+                   maxFusedHits(64), residentBudgetMB(0) {}
+    };
+
+    // Accumulated heights of one cell (hits == 0: never observed)
+    struct Cell {
+        float minHeight;
+        float maxHeight;
+        float meanHeight;        // Fused height estimate
+        float m2;                // Sum of squared deviations from the mean (Welford)
+        float reportedHeight;    // meanHeight when the cell last dirtied its tile
+        uint32_t hits;           // Observations so far
+    };
+
+    // tileCells x tileCells cells, row-major (row = second ground axis)
+    struct Tile {
+        int32_t tileX;
+        int32_t tileY;
+        uint32_t version;        // Bumped each time the tile becomes dirty
+        bool dirty;
+        std::unique_ptr<Cell[]> cells;
+    };
+
+    struct Stats {
+        size_t pointsInserted;
+        size_t pointsOutOfBounds;
+        size_t cellChanges;      // Points that created a cell or moved it past the change threshold
+        size_t tilesAllocated;   // Tiles with data, in memory or in the store
+        size_t tilesResident;
+        size_t tilesPagedIn;     // Loaded back from the store
+        size_t tilesEvicted;     // Moved out to the store
+        size_t memoryBytes;      // Resident tiles plus the tile table
+
+        Stats() : pointsInserted(0), pointsOutOfBounds(0), cellChanges(0), tilesAllocated(0),
+                  tilesResident(0), tilesPagedIn(0), tilesEvicted(0), memoryBytes(0) {}
+    };
+
+    HeightMap();
+    explicit HeightMap(const Config& config);
+    ~HeightMap();
+
+    // Disable copy (owns tiles)
+    HeightMap(const HeightMap&) = delete;
+    HeightMap& operator=(const HeightMap&) = delete;
+
+    // Accumulate world-space points; returns points inside the mapped area
+    size_t insert(const glm::vec3* points, size_t count);
+    size_t insert(const std::vector<glm::vec3>& points) { return insert(points.data(), points.size()); }
+
+    // Page tiles to/from a memory-mapped file. A file left by an earlier
+    // session with the same layout is resumed: its tiles come back on first
+    // access and are all listed as dirty. Call before inserting; false on
+    // error (the map then stays memory-only).
+    bool openStore(const std::string& path);
+    bool hasStore() const { return store_ != nullptr; }
+
+    // Write every changed resident tile to the store and sync it to disk
+    // (also done on destruction); false without a store or on error
+    bool flush();
+
+    // Move the indices of tiles changed since the last call into out
+    // (out is cleared first) and clear their dirty flags
+    void takeDirtyTiles(std::vector<uint32_t>& out);
+
+    // Tile by index (from takeDirtyTiles) or tile coordinates; nullptr if
+    // never touched or out of range. Pages the tile in if it was evicted.
+    const Tile* getTile(uint32_t index) const { return index < tiles_.size() ? residentTile(index) : nullptr; }
+    const Tile* getTile(int32_t tileX, int32_t tileY) const;
+
+    // Cell under a ground position; nullptr if outside or never touched
+    const Cell* cellAt(float groundX, float groundY) const;
+
+    // Sample variance of the heights fused into a cell (0 below two hits)
+    float cellVariance(const Cell& cell) const;
+
+    // Standard error of a cell's fused height; measurementSigma acts as one
+    // prior observation so a single hit reports measurementSigma
+    float cellStdError(const Cell& cell) const;
+
+    // 0 (one observation) .. 1 (fused height exact), from the standard error
+    float cellConfidence(const Cell& cell) const;
+
+    // World-space ground position of a tile's first cell corner
+    glm::vec2 tileOrigin(const Tile& tile) const;
+
+    // Ground coordinates (the two non-up axes) of a world point
+    glm::vec2 groundOf(const glm::vec3& point) const {
+        return config_.upAxis == UpAxis::Y ? glm::vec2(point.x, point.z) : glm::vec2(point.x, point.y);
+    }
+    float heightOf(const glm::vec3& point) const {
+        return config_.upAxis == UpAxis::Y ? point.y : point.z;
+    }
+
+    const Config& getConfig() const { return config_; }
+    uint32_t getTilesPerSide() const { return tilesPerSide_; }
+    uint32_t getTileCount() const { return static_cast<uint32_t>(tiles_.size()); }
+    const Stats& getStats() const { return stats_; }
+
+    // Drop every tile
+    void clear();
+
+private:
+    static const uint32_t NONE = UINT32_MAX;
+
+    // Tile to insert into (allocated or paged in as needed)
+    Tile& tileFor(uint32_t index);
+
+    // Resident tile, paging it in from the store; nullptr if it has no data
+    // Paging is caching, so the const accessors may do it
+    Tile* residentTile(uint32_t index) const;
+
+    std::unique_ptr<Tile> makeTile(uint32_t index) const;
+    void makeResident(uint32_t index, std::unique_ptr<Tile> tile) const;
+    void storeTile(uint32_t index, const Tile& tile) const;
+    void evictOverBudget(uint32_t keep) const;
+    void evict(uint32_t index) const;
+
+    // LRU list over resident tiles (most recent at the head)
+    void lruUnlink(uint32_t index) const;
+    void lruPushFront(uint32_t index) const;
+    void touch(uint32_t index) const;
+    void updateMemoryStats() const;
+
+    Config config_;
+    float invCellSize_;
+    float origin_;                          // Ground coordinate of cell 0 on both axes
+    uint32_t cellsPerSide_;
+    uint32_t tilesPerSide_;
+    size_t tileBytes_;                      // Memory of one resident tile
+    size_t budgetTiles_;                    // Resident limit with a store (0 = none)
+    mutable std::vector<std::unique_ptr<Tile>> tiles_;   // tilesPerSide^2, row-major; null if not resident
+    mutable std::vector<uint8_t> unsaved_;               // Per tile: changed since last written to the store
+    mutable std::vector<uint32_t> lruPrev_;
+    mutable std::vector<uint32_t> lruNext_;
+    mutable uint32_t lruHead_;
+    mutable uint32_t lruTail_;
+    mutable std::unique_ptr<Tile> spare_;               // Last evicted tile, reused by the next page-in
+    std::unique_ptr<TileStore> store_;
+    std::vector<uint32_t> dirtyTiles_;
+    mutable Stats stats_;
+};
+
+#endif // HEIGHT_MAP_H
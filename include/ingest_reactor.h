@@ -0,0 +1,161 @@
+#ifndef INGEST_REACTOR_H
+#define INGEST_REACTOR_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include "udp_receiver.h"
+#include "udp_packet_structures.h"
+#include "latency_stats.h"
+
+// Which stream a socket carries
+enum class StreamKind : uint8_t {
+    Pose,
+    Lidar,
+    Telemetry
+};
+
+// Ports used by one rover (see emulator/rover_profiles.h)
+struct RoverPorts {
+    uint32_t roverId;
+    uint16_t posePort;
+    uint16_t lidarPort;
+    uint16_t telemPort;
+    uint16_t cmdPort;        // Button commands go the other way (CommandChannel)
+};
+
+// Receives decoded packets for one or more rovers
+// Called on the reactor thread; implementations must not block.
+// arrivalNs is the kernel receive time (CLOCK_REALTIME ns).
+class IngestHandler {
+public:
+    virtual ~IngestHandler() = default;
+
+    virtual void onPose(uint32_t roverId, const PosePacket& pose, uint64_t arrivalNs) {
+        (void)roverId; (void)pose; (void)arrivalNs;
+    }
+    virtual void onLidar(uint32_t roverId, const LidarPacket& packet, uint64_t arrivalNs) {
+        (void)roverId; (void)packet; (void)arrivalNs;
+    }
+    virtual void onTelemetry(uint32_t roverId, const VehicleTelem& telem, uint64_t arrivalNs) {
+        (void)roverId; (void)telem; (void)arrivalNs;
+    }
+};
+
+class PacketRecorder;
+
+// Validates raw datagrams and decodes them for an IngestHandler
+// Shared by IngestReactor and PacketReplayer so live and replayed data go
+// through the same checks. Packets are decoded into scratch members.
+class PacketDecoder {
+public:
+    // Decode a datagram of the given stream and hand it to handler
+    // Returns false (handler not called) if the size did not match the format
+    bool dispatch(StreamKind kind, uint32_t roverId, const uint8_t* data, size_t length,
+                  uint64_t arrivalNs, IngestHandler& handler);
+
+private:
+    PosePacket pose_;
+    LidarPacket lidar_;
+    VehicleTelem telem_;
+};
+
+// Single-threaded ingest loop for all rover sockets
+// Every socket is registered edge-triggered in one epoll set, so the thread
+// sleeps in epoll_wait while idle and drains sockets with recvmmsg on wake-up.
+class IngestReactor {
+public:
+    // Statistics (only written by the reactor thread)
+    struct Stats {
+        size_t wakeups;              // epoll_wait returns with events
+        size_t datagrams;            // Datagrams read from sockets
+        size_t posePackets;
+        size_t lidarPackets;
+        size_t telemPackets;
+        size_t malformedPackets;     // Size did not match the stream's format
+
+        Stats() : wakeups(0), datagrams(0), posePackets(0), lidarPackets(0),
+                  telemPackets(0), malformedPackets(0) {}
+    };
+
+    // batchSize: datagrams per recvmmsg call
+    // maxBatchesPerWake: cap per socket per wake-up so one busy rover
+    // cannot starve the others (leftovers are serviced on the next pass)
+    explicit IngestReactor(size_t batchSize = 64, size_t maxBatchesPerWake = 4);
+    ~IngestReactor();
+
+    // Disable copy constructor and assignment
+    IngestReactor(const IngestReactor&) = delete;
+    IngestReactor& operator=(const IngestReactor&) = delete;
+
+    // Open and register the pose, LiDAR and telemetry sockets of a rover
+    // Handler must outlive the reactor. Returns false if any socket failed,
+    // in which case none of the rover's sockets stay registered.
+    bool addRover(const RoverPorts& ports, IngestHandler& handler);
+
+    // Record kernel-arrival -> dispatch latency per rover (nullptr disables)
+    // Recorder must outlive the reactor
+    void setLatencyRecorder(LatencyRecorder* recorder) { latency_ = recorder; }
+
+    // Append every datagram, malformed ones included, to a packet log
+    // (nullptr disables). Recorder must outlive the reactor
+    void setPacketRecorder(PacketRecorder* recorder) { recorder_ = recorder; }
+
+    // Port layout of every rover in g_roverProfiles
+    static std::vector<RoverPorts> portsFromProfiles();
+
+    // Port layout of rovers 1..count, synthetic ones included
+    // (emulator --rovers / findRoverProfile)
+    static std::vector<RoverPorts> portsForRovers(uint32_t count);
+
+    // Wait up to timeoutMs (-1 = forever) and dispatch everything that is ready
+    // Returns number of datagrams dispatched
+    size_t pollOnce(int timeoutMs);
+
+    // Loop on pollOnce() until stop() is called
+    void run();
+
+    // Wake the reactor and make run() return (safe from any thread)
+    void stop();
+
+    // Check if epoll and wake descriptors were created
+    bool isValid() const { return epollFd_ >= 0 && wakeFd_ >= 0; }
+
+    size_t getRoverCount() const { return roverCount_; }
+    const Stats& getStats() const { return stats_; }
+
+private:
+    // One registered socket
+    struct Source {
+        std::unique_ptr<UDPReceiver> receiver;
+        uint32_t roverId;
+        StreamKind kind;
+        IngestHandler* handler;
+        bool pending;                // Still had data when the wake-up cap hit
+    };
+
+    bool addSource(uint16_t port, uint32_t roverId, StreamKind kind, IngestHandler& handler);
+
+    // Read up to maxBatchesPerWake_ batches; returns true if drained (EAGAIN)
+    bool drainSource(Source& source, size_t& dispatched);
+
+    // Validate one datagram and hand it to the source's handler
+    void dispatch(Source& source, const uint8_t* data, size_t length, uint64_t arrivalNs);
+
+    int epollFd_;
+    int wakeFd_;                               // eventfd used by stop()
+    std::vector<Source> sources_;
+    std::vector<size_t> pendingSources_;       // Indices with unread data
+    ReceiveBatch batch_;
+    size_t maxBatchesPerWake_;
+    size_t roverCount_;
+    std::atomic<bool> stopRequested_;
+    LatencyRecorder* latency_;
+    PacketRecorder* recorder_;
+    Stats stats_;
+    PacketDecoder decoder_;
+};
+
+#endif // INGEST_REACTOR_H
@@ -0,0 +1,99 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <atomic>
+#include <memory>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+#include <ctime>
+
+// Current CLOCK_REALTIME in nanoseconds
+// Same clock as SO_TIMESTAMPNS, so kernel arrival times can be compared to it
+inline uint64_t realtimeNowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// Current CLOCK_MONOTONIC in nanoseconds, for deadlines and timeouts
+inline uint64_t steadyNowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// Pipeline stages we attribute latency to
+enum class LatencyStage : uint8_t {
+    Receive,          // Kernel arrival -> packet dispatched to its handler
+    Assembly,         // First chunk arrival -> scan complete
+    Transform,        // Scan complete -> world coordinates ready
+    Render,           // World coordinates ready -> frame submitted
+    EndToEnd,         // First chunk arrival -> frame submitted
+    ChunkToWorld,     // Chunk arrival -> chunk in world coordinates (pipelined mode)
+    CommandRoundTrip, // Button command sent -> its bits echoed in telemetry
+    Count
+};
+
+const char* latencyStageName(LatencyStage stage);
+
+// Fixed-size log-linear histogram of nanosecond latencies
+// Each power of two is split into SUB_BUCKETS linear buckets (~12% error).
+// record() is lock-free and may be called from any thread.
+class LatencyHistogram {
+public:
+    static const size_t SUB_BUCKET_BITS = 3;
+    static const size_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    LatencyHistogram();
+
+    // Disable copy (buckets are atomics)
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(uint64_t nanoseconds) noexcept;
+
+    // Upper bound of the bucket holding the given percentile (0-100)
+    uint64_t percentile(double pct) const;
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+    void reset();
+
+private:
+    static size_t bucketIndex(uint64_t value) noexcept;
+    static uint64_t bucketUpperBound(size_t index);
+
+    std::atomic<uint64_t> buckets_[BUCKET_COUNT];
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> max_;
+};
+
+// Histograms per rover and per stage, preallocated so recording never locks
+class LatencyRecorder {
+public:
+    // Rover IDs 0..maxRoverId are tracked; larger IDs are ignored
+    explicit LatencyRecorder(uint32_t maxRoverId = 64);
+
+    void record(uint32_t roverId, LatencyStage stage, uint64_t nanoseconds) noexcept;
+
+    // Record now - startNs, ignoring clocks that went backwards
+    void recordSince(uint32_t roverId, LatencyStage stage, uint64_t startNs) noexcept;
+
+    const LatencyHistogram* histogram(uint32_t roverId, LatencyStage stage) const;
+
+    // Print p50/p99/max in milliseconds for every non-empty histogram
+    void dump(std::ostream& out) const;
+
+    void reset();
+
+private:
+    static const size_t STAGE_COUNT = static_cast<size_t>(LatencyStage::Count);
+
+    uint32_t maxRoverId_;
+    std::unique_ptr<LatencyHistogram[]> histograms_;   // [roverId][stage]
+};
+
+#endif // LATENCY_STATS_H
@@ -1,71 +1,180 @@
 #ifndef LIDAR_ASSEMBLER_H
 #define LIDAR_ASSEMBLER_H
 
-#include <map>
 #include <vector>
-#include <mutex>
-#include <chrono>
+#include <memory>
+#include <atomic>
+#include <cstdint>
 #include "udp_packet_structures.h"
+#include "scan_arena.h"
+#include "spsc_ring.h"
+#include "timer_wheel.h"
 
 // Assembles LiDAR chunks into complete scans
+// Chunks are written directly into preallocated ScanArena slots, so steady
+// state ingest performs no heap allocations.
+//
+// With emitPartialScans enabled, a scan that is still missing chunks is
+// emitted anyway once its deadline passes (no chunk for partialDeadlineMs)
+// or a newer scan starts, so one lost datagram does not cost a whole frame.
+// Check ScanHandle::completeness()/hasChunk() to tell partial scans apart.
+//
+// With retainPoints off the assembler only tracks chunk bitmaps, point
+// counts and statistics: used when chunks are transformed and consumed as
+// they arrive (see ChunkPipeline), so scan handles carry no points.
+//
+// Every partial scan has a timer on a hashed timer wheel, re-armed per chunk.
+// Expiry runs incrementally inside addPacket()/poll() and only touches the
+// scans that actually timed out; otherwise discarded scans are counted in
+// getStaleScans().
+//
+// Threading: addPacket() and poll() belong to one producer
+// (network) thread, getCompleteScan() to one consumer (processing) thread.
+// Complete scans cross between them on a lock-free SPSC ring; when the
+// consumer falls behind the oldest queued scan is dropped. Statistics can
+// be read from any thread.
 class LidarAssembler {
 public:
-    // Container for a complete LiDAR scan
+    // Sizing of the preallocated storage
+    struct Config {
+        size_t arenaSlots;           // Must cover partials + queue + scans held by consumers
+        uint32_t maxChunksPerScan;   // Larger scans are dropped
+        size_t maxPartialScans;      // Scans assembled concurrently
+        size_t queueDepth;           // Complete scans waiting for the consumer
+        bool emitPartialScans;       // Emit incomplete scans instead of waiting forever
+        double partialDeadlineMs;    // Quiet time after the last chunk before emitting
+        float minCompleteness;       // Emit only if at least this fraction arrived
+        double staleScanTimeoutMs;   // Quiet time before discarding (emitPartialScans off)
+        uint32_t roverId;            // Stamped on every scan (ScanInfo::roverId)
+        bool retainPoints;           // false: bookkeeping only (chunks consumed elsewhere)
+
+        Config() : arenaSlots(16), maxChunksPerScan(256), maxPartialScans(4), queueDepth(8),
+                   emitPartialScans(false), partialDeadlineMs(5.0), minCompleteness(0.5f),
+                   staleScanTimeoutMs(2000.0), roverId(0), retainPoints(true) {}
+    };
+
+    // Container for a complete LiDAR scan (owning copy of the points)
     struct CompleteScan {
+        uint32_t roverId;
         double timestamp;
         std::vector<LidarPoint> points;
         size_t totalChunks;
-        
-        CompleteScan() : timestamp(0), totalChunks(0) {}
+        uint64_t firstChunkArrivalNs;   // Arrival of first chunk received (CLOCK_REALTIME ns)
+        uint64_t lastChunkArrivalNs;    // Arrival of the chunk that completed the scan
+
+        CompleteScan() : roverId(0), timestamp(0), totalChunks(0),
+                         firstChunkArrivalNs(0), lastChunkArrivalNs(0) {}
+
+        // Time spent waiting for the remaining chunks of this scan
+        uint64_t assemblyLatencyNs() const { return lastChunkArrivalNs - firstChunkArrivalNs; }
     };
-    
-    // Container for chunks being assembled
+
+    // Scan being assembled in an arena slot
     struct PartialScan {
         double timestamp;
-        std::map<uint32_t, std::vector<LidarPoint>> chunks;  // chunkIndex -> points
-        uint32_t totalChunks;
-        std::chrono::steady_clock::time_point lastUpdateTime;
-        
-        PartialScan() : timestamp(0), totalChunks(0) {}
+        uint32_t slot;               // ScanArena::INVALID_SLOT when unused
+        uint64_t lastUpdateNs;       // steadyNowNs() of the last chunk
+
+        PartialScan() : timestamp(0), slot(ScanArena::INVALID_SLOT), lastUpdateNs(0) {}
     };
-    
+
     LidarAssembler();
-    ~LidarAssembler() = default;
-    
+    explicit LidarAssembler(const Config& config);
+    ~LidarAssembler();
+
+    // Disable copy (owns arena slots)
+    LidarAssembler(const LidarAssembler&) = delete;
+    LidarAssembler& operator=(const LidarAssembler&) = delete;
+
     // Add a received LiDAR packet to the assembler
-    // Returns true if this completes a scan
-    bool addPacket(const LidarPacket& packet);
-    
+    // arrivalNs: kernel receive time (CLOCK_REALTIME ns), 0 = use current time
+    // Returns true if a scan was queued (this one completed, or a partial
+    // scan was emitted)
+    bool addPacket(const LidarPacket& packet, uint64_t arrivalNs = 0);
+
+    // Expire partial scans whose deadline passed (emitted or discarded per
+    // emitPartialScans); call periodically when no packets arrive.
+    // Returns true if a scan was queued.
+    bool poll();
+
+    // True if the chunk's bit is already set in a scan still being
+    // assembled (a duplicate); completed scans are not searched
+    bool hasChunk(double timestamp, uint32_t chunkIndex) const;
+
     // Check if a complete scan is available
     bool hasCompleteScan() const;
-    
-    // Get and remove the oldest complete scan
+
+    // Get and remove the oldest complete scan as a zero-copy arena view
     // Returns false if no complete scan available
+    bool getCompleteScan(ScanHandle& scan);
+
+    // Same, but copies the points into an owning CompleteScan
     bool getCompleteScan(CompleteScan& scan);
-    
-    // Clean up old partial scans that haven't been completed
-    // (e.g., due to dropped packets)
-    void cleanupStaleScans(double maxAgeSeconds = 2.0);
-    
+
     // Get statistics
-    size_t getPartialScanCount() const;
-    size_t getCompleteScanCount() const;
-    size_t getTotalChunksReceived() const { return totalChunksReceived_; }
-    size_t getTotalScansCompleted() const { return totalScansCompleted_; }
-    
+    size_t getPartialScanCount() const { return activePartials_.load(std::memory_order_relaxed); }
+    size_t getCompleteScanCount() const { return completeScans_.size(); }
+    size_t getTotalChunksReceived() const { return totalChunksReceived_.load(std::memory_order_relaxed); }
+    size_t getTotalScansCompleted() const { return totalScansCompleted_.load(std::memory_order_relaxed); }
+    size_t getDroppedChunks() const { return droppedChunks_.load(std::memory_order_relaxed); }
+    size_t getDroppedScans() const { return droppedScans_.load(std::memory_order_relaxed); }
+    size_t getPartialScansEmitted() const { return partialScansEmitted_.load(std::memory_order_relaxed); }
+    size_t getStaleScans() const { return staleScans_.load(std::memory_order_relaxed); }
+    size_t getQueueHighWaterMark() const { return queueHighWater_.load(std::memory_order_relaxed); }
+    size_t getQueueDepth() const { return completeScans_.capacity(); }
+    const ScanArena& getArena() const { return *arena_; }
+    uint32_t getRoverId() const { return config_.roverId; }
+
 private:
-    // Partial scans being assembled (key: timestamp)
-    std::map<double, PartialScan> partialScans_;
-    
-    // Complete scans ready for retrieval
-    std::vector<CompleteScan> completeScans_;
-    
-    // Thread safety
-    mutable std::mutex mutex_;
-    
+    // Find the partial scan for a timestamp, or start one in a fresh slot
+    // Sets started when a new scan was opened
+    PartialScan* findOrStartScan(double timestamp, uint32_t totalChunks, bool& started);
+
+    // Fire the timers of scans past their deadline
+    bool expireScans(uint64_t nowNs);
+
+    // Emit (or drop) every scan older than timestamp
+    bool emitOlderScans(double timestamp);
+
+    // Queue an incomplete scan if complete enough, otherwise discard it
+    bool emitPartialScan(PartialScan& partial);
+
+    // Return a partial scan's slot to the arena
+    void abandonScan(PartialScan& partial);
+
+    // Timer wheel ID of a partial scan entry
+    uint32_t timerId(const PartialScan& partial) const {
+        return static_cast<uint32_t>(&partial - partialScans_.data());
+    }
+
+    // Close gaps left by short chunks so points are contiguous
+    void compactScan(uint32_t slot);
+
+    // Queue a complete scan for the consumer (drop-oldest when full)
+    void publishScan(uint32_t slot);
+
+    Config config_;
+    std::shared_ptr<ScanArena> arena_;
+
+    // Partial scans being assembled (producer only, searched by timestamp)
+    std::vector<PartialScan> partialScans_;
+
+    // Expiry deadline per partial scan entry (producer only)
+    TimerWheel expiry_;
+    uint64_t timeoutNs_;
+
+    // Arena slots of complete scans ready for retrieval (producer -> consumer)
+    SpscRing<uint32_t> completeScans_;
+
     // Statistics
-    size_t totalChunksReceived_;
-    size_t totalScansCompleted_;
+    std::atomic<size_t> activePartials_;
+    std::atomic<size_t> totalChunksReceived_;
+    std::atomic<size_t> totalScansCompleted_;
+    std::atomic<size_t> droppedChunks_;      // Invalid, oversized or no free slot
+    std::atomic<size_t> droppedScans_;       // Complete scans evicted from a full queue
+    std::atomic<size_t> partialScansEmitted_;  // Incomplete scans queued after their deadline
+    std::atomic<size_t> staleScans_;         // Incomplete scans discarded (timed out or evicted)
+    std::atomic<size_t> queueHighWater_;     // Most scans ever queued at once
 };
 
 #endif // LIDAR_ASSEMBLER_H
@@ -0,0 +1,187 @@
+#ifndef PACKET_LOG_H
+#define PACKET_LOG_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include "ingest_reactor.h"
+
+// Append-only binary log of received datagrams
+//
+// File layout (this machine's byte order):
+//   FileHeader (16 bytes: magic "RVPKTLG1", format version)
+//   Records, back to back: RecordHeader (16 bytes) + length payload bytes
+// Payloads are the datagrams exactly as received, so replay reproduces
+// malformed packets too. A record cut short by a crash ends the log; it is
+// cut off when the log is next opened for appending.
+struct PacketLogRecord {
+    uint64_t arrivalNs;    // Receive time (CLOCK_REALTIME ns)
+    uint32_t roverId;
+    uint16_t length;       // Payload bytes
+    uint8_t kind;          // StreamKind
+    uint8_t reserved;
+};
+
+// Writes records from the reactor thread without blocking it
+//
+// record() copies into the active buffer; a full buffer is handed to a
+// writer thread and the spare one becomes active. If the writer is still
+// busy with the previous buffer, records are dropped (counted) rather than
+// stalling ingest.
+//
+// Threading: record() from one thread; statistics from any thread.
+class PacketRecorder {
+public:
+    struct Config {
+        size_t bufferBytes;      // Per buffer (two are allocated)
+
+        Config() : bufferBytes(4 * 1024 * 1024) {}
+    };
+
+    struct Stats {
+        size_t records;          // Accepted into a buffer
+        size_t bytes;            // Record bytes accepted, headers included
+        size_t droppedRecords;   // Writer still busy with the other buffer
+        size_t writeErrors;
+
+        Stats() : records(0), bytes(0), droppedRecords(0), writeErrors(0) {}
+    };
+
+    PacketRecorder();
+    explicit PacketRecorder(const Config& config);
+    ~PacketRecorder();
+
+    // Disable copy (owns the writer thread)
+    PacketRecorder(const PacketRecorder&) = delete;
+    PacketRecorder& operator=(const PacketRecorder&) = delete;
+
+    // Open path for appending, creating it if missing; a record cut short
+    // at the end is truncated away first. False (message on stderr) on
+    // error or if the file is not a packet log
+    bool open(const std::string& path);
+
+    // Write out everything buffered and close the file
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+
+    // Append one datagram (never blocks; no-op when closed)
+    void record(uint32_t roverId, StreamKind kind, const uint8_t* data, size_t length, uint64_t arrivalNs);
+
+    Stats getStats() const;
+
+private:
+    void writerLoop();
+    bool writeAll(const uint8_t* data, size_t length);
+
+    Config config_;
+    int fd_;
+    std::vector<uint8_t> buffers_[2];
+    size_t active_;                       // Buffer record() fills
+    size_t used_;                         // Bytes used in the active buffer
+
+    // Hand-off to the writer (protected by mutex_)
+    std::thread writer_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    size_t fullBytes_;                    // Bytes in the other buffer to write (0 = none)
+    bool writing_;
+    bool stopWriter_;
+
+    std::atomic<size_t> records_;
+    std::atomic<size_t> bytes_;
+    std::atomic<size_t> droppedRecords_;
+    std::atomic<size_t> writeErrors_;
+};
+
+// Feeds a packet log into IngestHandlers at recorded pace, a multiple of
+// it, or as fast as possible
+//
+// The log is memory-mapped; every record is validated and decoded by the
+// same PacketDecoder the reactor uses, then handed to the handler of its
+// rover. Handlers are called on the thread that runs run().
+//
+// Pacing follows the gap between consecutive records, so a clock that
+// stepped back while recording replays as no wait, and the pause between
+// appended sessions is cut to maxGapNs.
+class PacketReplayer {
+public:
+    struct Config {
+        // true: handlers see the replay time as arrival time, so latency
+        // measured downstream is of this run; false: recorded arrival times
+        bool restampArrivals;
+        uint64_t maxGapNs;       // Longest wait between two records when paced
+
+        Config() : restampArrivals(true), maxGapNs(1000000000ull) {}
+    };
+
+    // Counts of the last run()
+    struct Stats {
+        size_t records;          // Handed to a handler
+        size_t posePackets;
+        size_t lidarPackets;
+        size_t telemPackets;
+        size_t malformedPackets; // Size did not match the stream's format
+        size_t unknownRover;     // No handler for the record's rover
+        double runSeconds;       // Wall time
+        double maxLagMs;         // Furthest behind schedule (paced runs)
+        size_t gapsClamped;      // Arrival went backwards or jumped past maxGapNs
+
+        Stats() : records(0), posePackets(0), lidarPackets(0), telemPackets(0),
+                  malformedPackets(0), unknownRover(0), runSeconds(0.0), maxLagMs(0.0),
+                  gapsClamped(0) {}
+    };
+
+    PacketReplayer();
+    explicit PacketReplayer(const Config& config);
+    ~PacketReplayer();
+
+    // Disable copy (owns the mapping)
+    PacketReplayer(const PacketReplayer&) = delete;
+    PacketReplayer& operator=(const PacketReplayer&) = delete;
+
+    // Map a log; false (message on stderr) on error or if not a packet log
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return base_ != nullptr; }
+
+    // Handler for one rover's records / for every rover without its own
+    // Handlers must outlive the replayer
+    void addRover(uint32_t roverId, IngestHandler& handler);
+    void setDefaultHandler(IngestHandler& handler) { defaultHandler_ = &handler; }
+
+    // Replay the whole log; speed 1 = recorded pace, N = N times faster,
+    // 0 = as fast as possible. Returns records handed to handlers.
+    size_t run(double speed = 1.0);
+
+    // Make run() return after the current record (safe from any thread)
+    void stop() { stopRequested_.store(true, std::memory_order_release); }
+
+    // Records in the log and the time a 1x paced replay of them takes
+    // (gaps clamped as in run())
+    size_t getRecordCount() const { return recordCount_; }
+    uint64_t getDurationNs() const { return durationNs_; }
+    const Stats& getStats() const { return stats_; }
+
+private:
+    IngestHandler* findHandler(uint32_t roverId) const;
+
+    Config config_;
+    const uint8_t* base_;
+    size_t mappedBytes_;
+    size_t endOffset_;                     // End of the last complete record
+    size_t recordCount_;
+    uint64_t firstArrivalNs_;
+    uint64_t durationNs_;
+    std::vector<IngestHandler*> handlers_; // Indexed by rover ID
+    IngestHandler* defaultHandler_;
+    PacketDecoder decoder_;
+    std::atomic<bool> stopRequested_;
+    Stats stats_;
+};
+
+#endif // PACKET_LOG_H
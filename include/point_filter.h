@@ -0,0 +1,94 @@
+#ifndef POINT_FILTER_H
+#define POINT_FILTER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "udp_packet_structures.h"
+
+// Per-scan voxel-grid downsampling with outlier rejection
+//
+// Sits between scan assembly and terrain integration (the viewer's
+// RenderFeed filters each scan's world points before HeightMap::insert).
+// Points are binned into a voxel grid (scratch hash table, reused across
+// scans) and each voxel becomes one point: the centroid of every point in
+// its 3x3x3 neighbourhood. That averages out sensor noise without the bias
+// a single voxel's centroid gets where noise pushes part of the surface
+// into the next voxel. A voxel is dropped as an outlier when its neighbourhood
+// holds fewer than minNeighbors points, or (optionally) fewer than
+// mean - stddevMultiplier * stddev over the scan.
+//
+// Works in place on the flat point array: the centroids are written over
+// the first points. Nothing is allocated per point; scratch grows only
+// when a scan is larger than any before it.
+//
+// With reductionFactor set, the voxel size is adjusted after every scan so
+// that roughly 1 / reductionFactor of the points are kept.
+//
+// Not thread-safe: use one filter per thread.
+class PointFilter {
+public:
+    struct Config {
+        float voxelSize;           // Starting (or fixed) voxel edge
+        uint32_t minNeighbors;     // Points needed in the 3x3x3 neighbourhood, own voxel included
+        float stddevMultiplier;    // > 0: also drop voxels below mean - k * stddev
+        float reductionFactor;     // > 0: steer voxelSize to keep count / reductionFactor points
+        float minVoxelSize;        // Bounds for the adaptive voxel size
+        float maxVoxelSize;
+        size_t expectedPoints;     // Scratch reserved up front (largest expected scan)
+
+        Config() : voxelSize(0.5f), minNeighbors(3), stddevMultiplier(0.0f), reductionFactor(0.0f),
+                   minVoxelSize(0.05f), maxVoxelSize(5.0f), expectedPoints(20000) {}
+    };
+
+    struct Stats {
+        size_t scansFiltered;
+        size_t pointsIn;
+        size_t pointsOut;
+        size_t outliersRemoved;    // Input points in rejected voxels
+
+        Stats() : scansFiltered(0), pointsIn(0), pointsOut(0), outliersRemoved(0) {}
+    };
+
+    PointFilter();
+    explicit PointFilter(const Config& config);
+
+    // Filter count points in place; returns the number kept (points[0..n))
+    // Non-finite points are discarded.
+    size_t filter(LidarPoint* points, size_t count);
+
+    // Same, resizing the vector (e.g. CompleteScan::points)
+    void filter(std::vector<LidarPoint>& points) {
+        points.resize(filter(points.data(), points.size()));
+    }
+
+    // Voxel size the next scan will use
+    float getVoxelSize() const { return voxelSize_; }
+    const Config& getConfig() const { return config_; }
+    const Stats& getStats() const { return stats_; }
+
+private:
+    struct Voxel {
+        int32_t x, y, z;           // Voxel coordinates
+        uint32_t count;
+        float sumX, sumY, sumZ;
+        uint32_t neighbors;        // Points in the 3x3x3 neighbourhood
+        float nearX, nearY, nearZ; // Their coordinate sums
+    };
+
+    static const uint64_t EMPTY_KEY = ~0ull;
+
+    // Voxel index for coordinates, or UINT32_MAX
+    uint32_t findVoxel(int32_t x, int32_t y, int32_t z) const;
+    void resetTable(size_t count);
+
+    Config config_;
+    float voxelSize_;
+    std::vector<Voxel> voxels_;         // In order of first point, so output keeps scan order
+    std::vector<uint64_t> keys_;        // Open addressing over packed voxel coordinates
+    std::vector<uint32_t> indices_;     // Voxel index per hash slot
+    uint32_t shift_;                    // 64 - log2(table size)
+    Stats stats_;
+};
+
+#endif // POINT_FILTER_H
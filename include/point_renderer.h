@@ -0,0 +1,138 @@
+#ifndef POINT_RENDERER_H
+#define POINT_RENDERER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+// Point clouds of every rover, drawn from persistently mapped GPU rings
+//
+// Each rover owns a fixed-capacity vertex buffer created with
+// glBufferStorage and mapped once (GL_MAP_PERSISTENT_BIT | COHERENT).
+// append() copies only new points into the ring behind the write head, so
+// upload cost follows the incoming point rate, not the size of the cloud.
+// When a ring is full the oldest points are overwritten. Below OpenGL 4.4
+// (macOS stops at 4.1) the ring is a plain buffer and append() writes the
+// same ranges with glBufferSubData instead.
+//
+// The ring is split into segments. The segment ahead of the write head is
+// never drawn, so the GPU has at least one segment of slack before it is
+// overwritten; one fence per frame records when a segment was last drawn
+// and is waited on (normally already signalled) before writing into it.
+// Each rover is drawn with one glMultiDrawArrays call (two ranges when the
+// visible part of the ring wraps).
+//
+// Requires OpenGL 4.1. Everything runs on the thread that owns the GL
+// context; nothing allocates after addRover().
+class PointRenderer {
+public:
+    struct Config {
+        size_t pointsPerRover;      // Ring capacity per rover
+        uint32_t segments;          // Fencing granularity (at least 2)
+        uint32_t framesInFlight;    // Frames the GPU may lag behind (fence ring)
+        float pointSize;
+
+        Config() : pointsPerRover(4 * 1024 * 1024), segments(8), framesInFlight(3), pointSize(2.0f) {}
+    };
+
+    // Counters of the last finished frame (beginFrame() .. draw())
+    struct FrameStats {
+        uint64_t frame;
+        size_t uploadBytes;         // Written into the rings
+        size_t pointsUploaded;
+        size_t pointsDrawn;
+        size_t drawCalls;
+        size_t pointsOverwritten;   // Oldest points replaced in full rings
+        size_t fenceWaits;          // Fences that had not signalled when needed
+        double fenceWaitMs;
+
+        FrameStats() : frame(0), uploadBytes(0), pointsUploaded(0), pointsDrawn(0), drawCalls(0),
+                       pointsOverwritten(0), fenceWaits(0), fenceWaitMs(0.0) {}
+    };
+
+    PointRenderer();
+    explicit PointRenderer(const Config& config);
+    ~PointRenderer();
+
+    // Disable copy (owns GL objects)
+    PointRenderer(const PointRenderer&) = delete;
+    PointRenderer& operator=(const PointRenderer&) = delete;
+
+    // Compile the shader and pick the upload path for the context's GL
+    // version; needs a current GL context. Returns false with a message on
+    // stderr on failure
+    bool initialize();
+
+    // Create and map the ring of a rover (after initialize); false if it
+    // already exists or the buffer could not be created
+    bool addRover(uint32_t roverId, const glm::vec3& color);
+
+    // Start counting a new frame
+    void beginFrame();
+
+    // Copy points to the end of the rover's ring. Returns points written
+    // (0 for an unknown rover)
+    size_t append(uint32_t roverId, const glm::vec3* points, size_t count);
+
+    // Draw every rover and fence the frame
+    void draw(const glm::mat4& viewProjection);
+
+    // Drop every point (rings stay allocated)
+    void clear();
+
+    size_t getRoverCount() const { return rovers_.size(); }
+    size_t getTotalPoints() const;
+    size_t getCapacity() const { return rovers_.size() * config_.pointsPerRover; }
+    bool isPersistent() const { return persistent_; }   // Mapped rings (GL 4.4), else glBufferSubData
+    const FrameStats& getFrameStats() const { return lastFrame_; }
+
+private:
+    struct RoverRing {
+        uint32_t roverId;
+        glm::vec3 color;
+        GLuint vao;
+        GLuint buffer;
+        glm::vec3* mapped;                   // Persistent mapping of the whole buffer (nullptr below GL 4.4)
+        uint64_t written;                    // Points ever appended (head = written % capacity)
+        std::vector<uint64_t> lastDrawn;     // Per segment: last frame that drew it
+
+        RoverRing(uint32_t id, const glm::vec3& rgb);
+        ~RoverRing();
+
+        RoverRing(const RoverRing&) = delete;
+        RoverRing& operator=(const RoverRing&) = delete;
+    };
+
+    RoverRing* findRover(uint32_t roverId) const {
+        return roverId < byRover_.size() ? byRover_[roverId] : nullptr;
+    }
+
+    // Points of a ring that are drawn (all but the segment being overwritten)
+    size_t visibleCount(const RoverRing& ring) const;
+
+    // Make sure the GPU is done with every frame up to and including frame
+    void waitForFrame(uint64_t frame);
+
+    Config config_;
+    bool persistent_;                        // glBufferStorage available (GL 4.4)
+    size_t segmentPoints_;
+    std::vector<std::unique_ptr<RoverRing>> rovers_;
+    std::vector<RoverRing*> byRover_;        // Indexed by rover ID
+
+    GLuint program_;
+    GLint viewProjectionLocation_;
+    GLint colorLocation_;
+    GLint pointSizeLocation_;
+
+    std::vector<GLsync> fences_;             // Indexed by frame % framesInFlight
+    uint64_t frame_;                         // Frame being recorded (starts at 1)
+    uint64_t completedFrame_;                // Every frame up to here is done on the GPU
+
+    FrameStats current_;
+    FrameStats lastFrame_;
+};
+
+#endif // POINT_RENDERER_H
@@ -0,0 +1,75 @@
+#ifndef POSE_HISTORY_H
+#define POSE_HISTORY_H
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "udp_packet_structures.h"
+
+// How a pose was found for a timestamp
+enum class PoseMatch : uint8_t {
+    Interpolated,   // Between two stored poses (or exactly on one)
+    HeldNewest,     // Newer than every pose: newest pose used as-is
+    HeldOldest,     // Older than every pose: oldest pose used as-is
+    None            // History is empty
+};
+
+// Recent poses of one rover, for georeferencing LiDAR by timestamp
+//
+// Poses are kept in timestamp order in a fixed ring (oldest overwritten).
+// lookup() interpolates between the two poses around a timestamp: position
+// linearly, rotation by quaternion slerp. Timestamps at or just behind the
+// newest pose (the usual case for a live chunk) are answered in O(1);
+// anything older is a binary search over the ring.
+//
+// Not thread-safe: feed and query it from one thread (e.g. the reactor).
+class PoseHistory {
+public:
+    // One stored pose (rotation converted once, on insert)
+    struct Entry {
+        double timestamp;
+        glm::vec3 position;
+        glm::quat rotation;
+    };
+
+    explicit PoseHistory(size_t capacity = 256);
+
+    // Insert a pose; out-of-order poses are placed by timestamp, a pose with
+    // an existing timestamp replaces it. Poses older than the whole (full)
+    // ring are dropped.
+    void addPose(const PosePacket& pose);
+
+    // World transform at timestamp (same convention as Transform::poseToMatrix)
+    // transform is left untouched when None is returned
+    PoseMatch lookup(double timestamp, glm::mat4& transform) const;
+
+    // Interpolated position/rotation at timestamp
+    PoseMatch lookup(double timestamp, glm::vec3& position, glm::quat& rotation) const;
+
+    bool empty() const { return count_ == 0; }
+    size_t size() const { return count_; }
+    size_t capacity() const { return entries_.size(); }
+    double getNewestTimestamp() const { return count_ > 0 ? at(count_ - 1).timestamp : 0.0; }
+    double getOldestTimestamp() const { return count_ > 0 ? at(0).timestamp : 0.0; }
+    size_t getOutOfOrderPoses() const { return outOfOrderPoses_; }
+
+    void clear() { count_ = 0; head_ = 0; }
+
+private:
+    // Logical index 0 = oldest
+    const Entry& at(size_t index) const { return entries_[(head_ + index) % entries_.size()]; }
+    Entry& at(size_t index) { return entries_[(head_ + index) % entries_.size()]; }
+
+    // First logical index with timestamp > t (count_ if none)
+    size_t upperBound(double timestamp) const;
+
+    std::vector<Entry> entries_;
+    size_t head_;                 // Physical index of the oldest entry
+    size_t count_;
+    size_t outOfOrderPoses_;
+};
+
+#endif // POSE_HISTORY_H
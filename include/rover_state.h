@@ -0,0 +1,116 @@
+#ifndef ROVER_STATE_H
+#define ROVER_STATE_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "udp_packet_structures.h"
+#include "ingest_reactor.h"
+#include "scan_arena.h"
+#include "triple_buffer.h"
+
+// Everything the render loop needs to know about one rover
+struct RoverSnapshot {
+    uint32_t roverId;
+    bool hasPose;
+    glm::mat4 pose;                 // Transform::poseToMatrix() of the newest pose
+    double poseTimestamp;
+    uint64_t poseArrivalNs;
+    bool hasTelemetry;
+    uint8_t buttonStates;           // From the newest VehicleTelem
+    double telemTimestamp;
+    ScanHandle scan;                // Newest published scan (invalid before the first)
+    uint64_t vehicleUpdates;        // Poses + telemetry packets published so far
+    uint64_t scanUpdates;           // Scans published so far
+
+    RoverSnapshot() : roverId(0), hasPose(false), pose(1.0f), poseTimestamp(0.0), poseArrivalNs(0),
+                      hasTelemetry(false), buttonStates(0), telemTimestamp(0.0),
+                      vehicleUpdates(0), scanUpdates(0) {}
+};
+
+// Latest per-rover state, handed to the render thread without locks
+//
+// Pose and telemetry arrive on the ingest thread (this is an IngestHandler
+// that forwards every packet to a downstream handler, e.g. ChunkPipeline)
+// and scans are published by one processing thread. Each goes into its own
+// TripleBuffer per rover, so there is exactly one writer per buffer and the
+// reader never waits: a slow frame only skips intermediate states, and a
+// burst of packets never delays a frame.
+//
+// Threading: addRover() before any packet; onPose()/onTelemetry() from one
+// ingest thread; publishScan() from one processing thread; getSnapshot()
+// from one render thread. Each rover holds up to three scan handles (one per
+// buffer copy), plus one per snapshot the reader keeps, which must be
+// allowed for in the assembler's arenaSlots (defaults: 4 partial + 8 queued
+// + 3 here leave one of 16 slots for a snapshot).
+class RoverStateBuffer : public IngestHandler {
+public:
+    // downstream (optional) receives every packet after it is recorded;
+    // it must outlive this object
+    explicit RoverStateBuffer(IngestHandler* downstream = nullptr);
+
+    // Disable copy (per-rover buffers)
+    RoverStateBuffer(const RoverStateBuffer&) = delete;
+    RoverStateBuffer& operator=(const RoverStateBuffer&) = delete;
+
+    // Create the buffers of a rover; false if it already exists
+    bool addRover(uint32_t roverId);
+
+    // IngestHandler (ingest thread)
+    void onPose(uint32_t roverId, const PosePacket& pose, uint64_t arrivalNs) override;
+    void onLidar(uint32_t roverId, const LidarPacket& packet, uint64_t arrivalNs) override;
+    void onTelemetry(uint32_t roverId, const VehicleTelem& telem, uint64_t arrivalNs) override;
+
+    // Processing thread: make scan the rover's newest; false for an unknown rover
+    bool publishScan(uint32_t roverId, const ScanHandle& scan);
+
+    // Render thread: newest state of a rover (wait-free); false if unknown.
+    // The snapshot shares the scan, so keep it no longer than needed.
+    bool getSnapshot(uint32_t roverId, RoverSnapshot& snapshot);
+
+    std::vector<uint32_t> getRoverIds() const;
+
+private:
+    struct VehicleState {
+        bool hasPose;
+        glm::mat4 pose;
+        double poseTimestamp;
+        uint64_t poseArrivalNs;
+        bool hasTelemetry;
+        uint8_t buttonStates;
+        double telemTimestamp;
+        uint64_t updates;
+
+        VehicleState() : hasPose(false), pose(1.0f), poseTimestamp(0.0), poseArrivalNs(0),
+                         hasTelemetry(false), buttonStates(0), telemTimestamp(0.0), updates(0) {}
+    };
+
+    struct ScanState {
+        ScanHandle scan;
+        uint64_t updates;
+
+        ScanState() : updates(0) {}
+    };
+
+    struct Rover {
+        uint32_t roverId;
+        VehicleState latestVehicle;              // Ingest thread's working copy
+        uint64_t scansPublished;                 // Processing thread's counter
+        TripleBuffer<VehicleState> vehicle;
+        TripleBuffer<ScanState> scan;
+
+        explicit Rover(uint32_t id) : roverId(id), scansPublished(0) {}
+    };
+
+    Rover* findRover(uint32_t roverId) const {
+        return roverId < byRover_.size() ? byRover_[roverId] : nullptr;
+    }
+
+    IngestHandler* downstream_;
+    std::vector<std::unique_ptr<Rover>> rovers_;
+    std::vector<Rover*> byRover_;                // Indexed by rover ID
+};
+
+#endif // ROVER_STATE_H
@@ -0,0 +1,139 @@
+#ifndef SCAN_ARENA_H
+#define SCAN_ARENA_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include "udp_packet_structures.h"
+
+// Metadata of the scan held in one arena slot
+struct ScanInfo {
+    uint32_t roverId;               // Rover that produced the scan
+    double timestamp;
+    uint32_t totalChunks;
+    uint32_t chunksReceived;
+    size_t pointCount;              // Valid points at the front of the slot once emitted
+    uint64_t firstChunkArrivalNs;   // Arrival of first chunk received (CLOCK_REALTIME ns)
+    uint64_t lastChunkArrivalNs;    // Arrival of the last chunk received
+
+    ScanInfo() : roverId(0), timestamp(0), totalChunks(0), chunksReceived(0), pointCount(0),
+                 firstChunkArrivalNs(0), lastChunkArrivalNs(0) {}
+};
+
+// Recycled, preallocated storage for LiDAR scans
+// Each slot holds room for maxChunksPerScan full chunks, a chunk completion
+// bitmap and per-chunk point counts. Chunks are written straight to their
+// chunkIndex offset, so assembling a scan never allocates. Slots are
+// reference counted and return to the free list when the last user releases.
+class ScanArena {
+public:
+    static const uint32_t INVALID_SLOT = UINT32_MAX;
+
+    // storePoints = false keeps only bitmaps, counts and info (bookkeeping)
+    ScanArena(size_t slotCount, uint32_t maxChunksPerScan, bool storePoints = true);
+
+    // Disable copy (handles point into this arena)
+    ScanArena(const ScanArena&) = delete;
+    ScanArena& operator=(const ScanArena&) = delete;
+
+    // Take a free slot with one reference and cleared bitmap/info
+    // Returns INVALID_SLOT if every slot is in use
+    uint32_t acquire();
+
+    // Reference counting (thread-safe)
+    void addRef(uint32_t slot) noexcept;
+    void release(uint32_t slot);
+
+    // Slot storage (points are nullptr without storePoints)
+    LidarPoint* points(uint32_t slot) { return storesPoints() ? &points_[slot * pointsPerSlot_] : nullptr; }
+    const LidarPoint* points(uint32_t slot) const { return storesPoints() ? &points_[slot * pointsPerSlot_] : nullptr; }
+    uint64_t* chunkBitmap(uint32_t slot) { return &bitmaps_[slot * bitmapWords_]; }
+    const uint64_t* chunkBitmap(uint32_t slot) const { return &bitmaps_[slot * bitmapWords_]; }
+    uint16_t* chunkPointCounts(uint32_t slot) { return &chunkCounts_[slot * maxChunksPerScan_]; }
+    ScanInfo& info(uint32_t slot) { return infos_[slot]; }
+    const ScanInfo& info(uint32_t slot) const { return infos_[slot]; }
+
+    bool storesPoints() const { return !points_.empty(); }
+    uint32_t getMaxChunksPerScan() const { return maxChunksPerScan_; }
+    size_t getSlotCount() const { return infos_.size(); }
+    size_t getFreeSlotCount() const;
+
+    // Total bytes preallocated for slot storage
+    size_t getMemoryBytes() const;
+
+private:
+    uint32_t maxChunksPerScan_;
+    size_t pointsPerSlot_;
+    size_t bitmapWords_;
+
+    std::vector<LidarPoint> points_;       // slotCount * maxChunks * MAX_LIDAR_POINTS_PER_PACKET
+    std::vector<uint64_t> bitmaps_;        // slotCount * bitmapWords
+    std::vector<uint16_t> chunkCounts_;    // slotCount * maxChunks
+    std::vector<ScanInfo> infos_;
+    std::unique_ptr<std::atomic<uint32_t>[]> refCounts_;
+
+    // Free list (reserved to slotCount, never reallocates)
+    mutable std::mutex freeMutex_;
+    std::vector<uint32_t> freeSlots_;
+};
+
+// Shared, read-only view of an assembled scan in a ScanArena
+// Copying a handle adds a reference; the slot is recycled when the last
+// handle is destroyed or reset.
+class ScanHandle {
+public:
+    ScanHandle() : slot_(ScanArena::INVALID_SLOT) {}
+
+    // Adopts one reference already held on slot
+    ScanHandle(std::shared_ptr<ScanArena> arena, uint32_t slot)
+        : arena_(std::move(arena)), slot_(slot) {}
+
+    ~ScanHandle() { reset(); }
+
+    ScanHandle(const ScanHandle& other);
+    ScanHandle& operator=(const ScanHandle& other);
+    ScanHandle(ScanHandle&& other) noexcept;
+    ScanHandle& operator=(ScanHandle&& other) noexcept;
+
+    // Drop our reference (slot returns to the pool if we were the last)
+    void reset();
+
+    bool valid() const { return arena_ != nullptr; }
+
+    const ScanInfo& info() const { return arena_->info(slot_); }
+    uint32_t roverId() const { return info().roverId; }
+    double timestamp() const { return info().timestamp; }
+    uint32_t totalChunks() const { return info().totalChunks; }
+    uint32_t chunksReceived() const { return info().chunksReceived; }
+    uint64_t firstChunkArrivalNs() const { return info().firstChunkArrivalNs; }
+    uint64_t lastChunkArrivalNs() const { return info().lastChunkArrivalNs; }
+
+    // Fraction of chunks received (1.0 for a complete scan)
+    float completeness() const {
+        return totalChunks() > 0 ? static_cast<float>(chunksReceived()) / totalChunks() : 0.0f;
+    }
+    bool isComplete() const { return chunksReceived() == totalChunks(); }
+
+    // Contiguous points of the scan, in chunk order
+    // (nullptr if the assembler only keeps bookkeeping; pointCount() still valid)
+    const LidarPoint* points() const { return arena_->points(slot_); }
+    size_t pointCount() const { return info().pointCount; }
+
+    // Chunk received bitmap, bit i of word i/64 set when chunk i arrived
+    // ((totalChunks + 63) / 64 words; clear bits are the missing chunks)
+    const uint64_t* chunkBitmap() const { return arena_->chunkBitmap(slot_); }
+    bool hasChunk(uint32_t chunkIndex) const {
+        return (chunkBitmap()[chunkIndex / 64] >> (chunkIndex % 64)) & 1;
+    }
+
+    uint32_t getSlot() const { return slot_; }
+
+private:
+    std::shared_ptr<ScanArena> arena_;
+    uint32_t slot_;
+};
+
+#endif // SCAN_ARENA_H
@@ -0,0 +1,105 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <cstddef>
+
+// Bounded lock-free single-producer/single-consumer ring
+//
+// Elements are small trivially copyable values (indices, handles) stored in
+// atomics, which lets the producer drop the oldest element when the ring is
+// full: producer and consumer both claim the tail element with a CAS, and
+// whoever wins owns it. Neither side ever blocks or allocates.
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SpscRing elements must be trivially copyable");
+
+public:
+    explicit SpscRing(size_t capacity)
+        : capacity_(capacity > 0 ? capacity : 1),
+          slots_(std::make_unique<std::atomic<T>[]>(capacity_)),
+          head_(0), tail_(0) {
+    }
+
+    // Disable copy (atomics)
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer: append value, or return false if the ring is full
+    bool push(T value) noexcept {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= capacity_) {
+            return false;
+        }
+        publish(head, value);
+        return true;
+    }
+
+    // Producer: append value, evicting the oldest element if the ring is full
+    // Returns true and sets dropped when an element was evicted
+    bool pushOverwrite(T value, T& dropped) noexcept {
+        size_t head = head_.load(std::memory_order_relaxed);
+        while (true) {
+            size_t tail = tail_.load(std::memory_order_acquire);
+            if (head - tail < capacity_) {
+                publish(head, value);
+                return false;
+            }
+
+            // Claim the oldest element; losing the race means the consumer
+            // just took it and there is room now
+            T oldest = slots_[tail % capacity_].load(std::memory_order_relaxed);
+            if (tail_.compare_exchange_strong(tail, tail + 1, std::memory_order_acq_rel)) {
+                dropped = oldest;
+                publish(head, value);
+                return true;
+            }
+        }
+    }
+
+    // Consumer: take the oldest element, or return false if empty
+    bool pop(T& value) noexcept {
+        while (true) {
+            size_t tail = tail_.load(std::memory_order_acquire);
+            if (tail == head_.load(std::memory_order_acquire)) {
+                return false;
+            }
+
+            // Read before claiming; if the producer evicted it meanwhile
+            // the CAS fails and we retry with the next element
+            T candidate = slots_[tail % capacity_].load(std::memory_order_relaxed);
+            if (tail_.compare_exchange_strong(tail, tail + 1, std::memory_order_acq_rel)) {
+                value = candidate;
+                return true;
+            }
+        }
+    }
+
+    // Approximate when called concurrently with push/pop
+    size_t size() const noexcept {
+        size_t tail = tail_.load(std::memory_order_acquire);
+        size_t head = head_.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+    size_t capacity() const noexcept { return capacity_; }
+
+private:
+    void publish(size_t head, T value) noexcept {
+        slots_[head % capacity_].store(value, std::memory_order_relaxed);
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    size_t capacity_;
+    std::unique_ptr<std::atomic<T>[]> slots_;
+
+    // Separate cache lines so producer and consumer do not false-share
+    alignas(64) std::atomic<size_t> head_;   // Next write position (producer)
+    alignas(64) std::atomic<size_t> tail_;   // Next read position (consumer, or producer on drop)
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,130 @@
+#ifndef TELEMETRY_MONITOR_H
+#define TELEMETRY_MONITOR_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "ingest_reactor.h"
+#include "timer_wheel.h"
+
+// Notified by TelemetryMonitor on the reactor thread; must not block
+class TelemetryListener {
+public:
+    virtual ~TelemetryListener() = default;
+
+    // Button bits differ from the rover's previous telemetry (all bits
+    // start cleared, so the first telemetry reports any bit that is set)
+    virtual void onButtonsChanged(uint32_t roverId, uint8_t previous, uint8_t current, uint64_t arrivalNs) {
+        (void)roverId; (void)previous; (void)current; (void)arrivalNs;
+    }
+
+    // First telemetry of a rover, or the first after its link was lost
+    virtual void onLinkUp(uint32_t roverId) {
+        (void)roverId;
+    }
+
+    // No telemetry for staleTimeoutMs; silentNs is the time since the last one
+    virtual void onLinkLost(uint32_t roverId, uint64_t silentNs) {
+        (void)roverId; (void)silentNs;
+    }
+};
+
+// Latest button state of every rover, with events only when it changes
+//
+// Sits on the shared ingest path as an IngestHandler that forwards every
+// packet downstream. Per-rover state is kept in dense arrays indexed by
+// the order rovers were added (one byte of buttons each), so a telemetry
+// packet costs a compare and a timer re-arm, and listeners are only called
+// when a bit flips or a link changes state. Each rover's link timer sits in
+// a TimerWheel re-armed by every packet; poll() only visits the buckets
+// that elapsed, so link checks do not scale with the number of rovers.
+//
+// Threading: addRover()/addListener() before packets arrive; everything
+// else on the reactor thread.
+class TelemetryMonitor : public IngestHandler {
+public:
+    struct Config {
+        double staleTimeoutMs;       // Link lost after this long without telemetry
+        uint32_t maxRovers;          // Link timers are preallocated
+
+        // 10 Hz telemetry: five packets in a row missing
+        Config() : staleTimeoutMs(500.0), maxRovers(1024) {}
+    };
+
+    // Statistics (only written by the reactor thread)
+    struct Stats {
+        size_t packets;
+        size_t buttonChanges;        // Packets whose bits differed from the previous ones
+        size_t linksLost;
+        size_t linksRestored;        // Link up again after being lost
+        size_t unknownRoverPackets;
+
+        Stats() : packets(0), buttonChanges(0), linksLost(0), linksRestored(0), unknownRoverPackets(0) {}
+    };
+
+    // downstream (optional) receives every packet after it is recorded;
+    // it must outlive this object
+    explicit TelemetryMonitor(IngestHandler* downstream = nullptr);
+    TelemetryMonitor(IngestHandler* downstream, const Config& config);
+
+    // Disable copy (listeners and per-rover state)
+    TelemetryMonitor(const TelemetryMonitor&) = delete;
+    TelemetryMonitor& operator=(const TelemetryMonitor&) = delete;
+
+    // Start tracking a rover; false if it already exists or maxRovers is reached
+    bool addRover(uint32_t roverId);
+
+    // Listener must outlive the monitor
+    void addListener(TelemetryListener& listener) { listeners_.push_back(&listener); }
+
+    // IngestHandler
+    void onPose(uint32_t roverId, const PosePacket& pose, uint64_t arrivalNs) override;
+    void onLidar(uint32_t roverId, const LidarPacket& packet, uint64_t arrivalNs) override;
+    void onTelemetry(uint32_t roverId, const VehicleTelem& telem, uint64_t arrivalNs) override;
+
+    // Report links that went silent; call periodically from the reactor loop
+    void poll();
+
+    // Newest button bits of a rover (0 for unknown or silent-so-far rovers)
+    uint8_t getButtons(uint32_t roverId) const {
+        uint32_t slot = findSlot(roverId);
+        return slot != NO_SLOT ? buttons_[slot] : 0;
+    }
+
+    bool isLinkUp(uint32_t roverId) const {
+        uint32_t slot = findSlot(roverId);
+        return slot != NO_SLOT && linkUp_[slot] != 0;
+    }
+
+    size_t getRoverCount() const { return roverIds_.size(); }
+    size_t getLinksUp() const { return linksUp_; }
+    const Stats& getStats() const { return stats_; }
+
+private:
+    static const uint32_t NO_SLOT = UINT32_MAX;
+
+    uint32_t findSlot(uint32_t roverId) const {
+        return roverId < slotOfRover_.size() ? slotOfRover_[roverId] : NO_SLOT;
+    }
+
+    // Fire the link timers due at nowNs (steadyNowNs() clock)
+    void checkLinks(uint64_t nowNs);
+
+    IngestHandler* downstream_;
+    Config config_;
+    uint64_t timeoutNs_;
+
+    // Per rover, indexed by slot (order of addRover)
+    std::vector<uint32_t> roverIds_;
+    std::vector<uint8_t> buttons_;
+    std::vector<uint8_t> linkUp_;
+    std::vector<uint64_t> lastSeenNs_;          // steadyNowNs() of the newest telemetry (0: never)
+
+    std::vector<uint32_t> slotOfRover_;         // Indexed by rover ID
+    std::vector<TelemetryListener*> listeners_;
+    TimerWheel linkTimers_;                     // Timer ID = slot
+    size_t linksUp_;
+    Stats stats_;
+};
+
+#endif // TELEMETRY_MONITOR_H
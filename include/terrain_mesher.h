@@ -0,0 +1,170 @@
+#ifndef TERRAIN_MESHER_H
+#define TERRAIN_MESHER_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include "height_map.h"
+
+// Incremental triangle meshing of a HeightMap on a pool of worker threads
+//
+// Each frame, beginFrame() (on the thread that owns the HeightMap) takes the
+// tiles changed since the last frame, copies their cells plus a one-cell
+// border from the neighbouring tiles, and hands them to the workers. Only
+// those tiles are re-triangulated. Workers write indexed meshes into a back
+// buffer; when the frame is done it is swapped with the front buffer, which
+// the render thread collects with takeFrame() without ever blocking on the
+// workers.
+//
+// A new frame is not started while the previous one is still being meshed
+// or has not been collected; the changed tiles simply wait for the next one.
+class TerrainMesher {
+public:
+    static const uint32_t FLOATS_PER_VERTEX = 6;   // position xyz, normal xyz
+    static const uint32_t LOD_LEVELS = 3;          // Full resolution, then quads of 2 and 4 cells
+
+    struct Config {
+        unsigned workerCount;       // Meshing threads (at least 1)
+        size_t maxTilesPerFrame;    // 0 = every changed tile; the rest carry over
+
+        Config() : workerCount(2), maxTilesPerFrame(0) {}
+    };
+
+    // Mesh of one tile: interleaved vertices and triangle list, ready to upload
+    // Cells never observed leave holes (no triangles)
+    //
+    // Coarser levels of detail share the vertices: level L joins every
+    // 2^L-th cell, with quads wherever all four corners were observed.
+    // lodError is how far (world units) the cells skipped by a level lie
+    // from its surface, for screen-space error LOD selection.
+    struct TileMesh {
+        uint32_t tileIndex;             // HeightMap tile index
+        uint32_t version;               // Tile version the mesh was built from
+        std::vector<float> vertices;    // FLOATS_PER_VERTEX per vertex, world space
+        std::vector<uint32_t> indices;  // 3 per triangle, counter-clockwise seen from above
+        std::vector<uint32_t> lodIndices;      // Levels 1.. back to back, same winding
+        uint32_t lodIndexCount[LOD_LEVELS];    // Level 0 is indices, the rest lodIndices
+        float lodError[LOD_LEVELS];            // Never decreasing with the level
+        glm::vec3 boundsMin;            // World-space box of the vertices
+        glm::vec3 boundsMax;            // (min > max when there are none)
+    };
+
+    struct FrameStats {
+        uint64_t frame;
+        size_t tilesRebuilt;
+        size_t tilesDeferred;       // Changed tiles left for a later frame
+        size_t triangles;
+        size_t vertices;
+        double snapshotMs;          // Copying tiles on the calling thread
+        double meshingMs;           // beginFrame() until the frame was published
+
+        FrameStats() : frame(0), tilesRebuilt(0), tilesDeferred(0), triangles(0), vertices(0),
+                       snapshotMs(0.0), meshingMs(0.0) {}
+    };
+
+    // Meshes rebuilt in one frame (replace earlier meshes of the same tiles)
+    struct MeshFrame {
+        FrameStats stats;
+        std::vector<TileMesh> tiles;
+    };
+
+    // Totals since construction
+    struct Stats {
+        size_t framesMeshed;
+        size_t framesSkipped;       // beginFrame() while busy or not collected
+        size_t tilesRebuilt;
+        size_t trianglesEmitted;
+
+        Stats() : framesMeshed(0), framesSkipped(0), tilesRebuilt(0), trianglesEmitted(0) {}
+    };
+
+    explicit TerrainMesher(HeightMap& map);
+    TerrainMesher(HeightMap& map, const Config& config);
+    ~TerrainMesher();
+
+    // Disable copy (owns threads)
+    TerrainMesher(const TerrainMesher&) = delete;
+    TerrainMesher& operator=(const TerrainMesher&) = delete;
+
+    // Launch / join the workers (stop() also runs on destruction)
+    void start();
+    void stop();
+    bool isRunning() const { return running_; }
+
+    // Start meshing the tiles changed since the last frame; returns tiles
+    // dispatched (0 if nothing changed, busy, or the last frame is uncollected)
+    // Call from the thread that inserts into the HeightMap.
+    size_t beginFrame();
+
+    // Render thread: take the newest finished frame; false if none is ready
+    // frame's old buffers are recycled for later frames
+    bool takeFrame(MeshFrame& frame);
+
+    // Block until the frame in flight (if any) is published
+    void waitIdle();
+
+    bool isBusy() const { return busy_.load(std::memory_order_acquire); }
+    size_t getPendingTiles() const { return pending_.size(); }
+    Stats getStats() const;
+
+private:
+    // Snapshot of one tile plus the first row/column of its +x/+y neighbours
+    struct Job {
+        uint32_t tileIndex;
+        uint32_t version;
+        glm::vec2 origin;                       // Ground position of cell (0, 0)
+        std::vector<HeightMap::Cell> cells;     // (tileCells + 1)^2, row-major
+    };
+
+    void queueTile(int32_t tileX, int32_t tileY);
+    void snapshot(const HeightMap::Tile& tile, Job& job) const;
+    void meshTile(const Job& job, TileMesh& mesh, std::vector<int32_t>& remap) const;
+    void workerLoop(unsigned worker);
+    void publish();
+
+    HeightMap& map_;
+    Config config_;
+
+    // Caller thread
+    std::vector<uint32_t> dirty_;
+    std::vector<uint32_t> pending_;             // Tiles waiting for a frame
+    std::vector<uint8_t> pendingMark_;          // Per tile: already in pending_
+    uint64_t frameCounter_;
+
+    // Current frame (written by the caller before dispatch, read by workers)
+    std::vector<Job> jobs_;
+    size_t jobCount_;
+    MeshFrame building_;
+    uint64_t frameStartNs_;
+    std::atomic<size_t> nextJob_;
+    std::atomic<unsigned> workersDone_;
+    std::atomic<size_t> frameTriangles_;
+    std::atomic<size_t> frameVertices_;
+    std::atomic<bool> busy_;
+
+    // Front buffer
+    std::mutex readyMutex_;
+    MeshFrame ready_;
+    bool readyFull_;
+    std::condition_variable idleCond_;
+
+    // Workers
+    std::vector<std::thread> workers_;
+    std::mutex workMutex_;
+    std::condition_variable workCond_;
+    uint64_t frameSeq_;
+    bool stopRequested_;
+    bool running_;
+
+    std::atomic<size_t> framesMeshed_;
+    std::atomic<size_t> framesSkipped_;
+    std::atomic<size_t> tilesRebuilt_;
+    std::atomic<size_t> trianglesEmitted_;
+};
+
+#endif // TERRAIN_MESHER_H
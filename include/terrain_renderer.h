@@ -0,0 +1,150 @@
+#ifndef TERRAIN_RENDERER_H
+#define TERRAIN_RENDERER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "terrain_mesher.h"
+
+// Tiled terrain drawn with one multi-draw-indirect call per frame
+//
+// Tile meshes from TerrainMesher are copied into one shared vertex buffer
+// and one shared index buffer (first-fit ranges, released when a tile is
+// re-meshed). Every frame each tile's bounding box is tested against the
+// camera frustum on the CPU, and visible tiles pick the coarsest level of
+// detail whose error projects to at most maxPixelError on screen. The
+// visible tiles become DrawElementsIndirect commands drawn with a single
+// glMultiDrawElementsIndirect, so the draw call count does not grow with
+// the number of tiles. Below OpenGL 4.3 (macOS stops at 4.1) the same
+// commands are drawn one glDrawElementsBaseVertex call each.
+//
+// Requires OpenGL 4.1. Everything runs on the thread that owns the GL
+// context; destroy the renderer before the context.
+class TerrainRenderer {
+public:
+    struct Config {
+        size_t vertexCapacity;      // Vertices held by all tiles together
+        size_t indexCapacity;       // Indices (every level of detail) of all tiles
+        float maxPixelError;        // Screen-space error allowed when picking a level
+        float minLevelCoverage;     // Coarser levels covering less of the tile are not used
+        HeightMap::UpAxis upAxis;   // Must match the HeightMap the meshes come from
+
+        // Defaults hold a fully scanned 1 km square at 0.5 m cells (~4.3 M
+        // vertices, ~33 M indices over all levels, ~250 MB in total)
+        Config() : vertexCapacity(4608 * 1024), indexCapacity(36 * 1024 * 1024), maxPixelError(2.0f),
+                   minLevelCoverage(0.9f), upAxis(HeightMap::UpAxis::Y) {}
+    };
+
+    // Counters of the last draw()
+    struct FrameStats {
+        size_t tiles;               // Tiles with triangles
+        size_t tilesVisible;
+        size_t tilesCulled;
+        size_t tilesPerLevel[TerrainMesher::LOD_LEVELS];
+        size_t triangles;           // Submitted in the frame's draws
+        size_t drawCalls;
+        double cullMs;              // Culling, LOD selection and command upload
+
+        FrameStats() : tiles(0), tilesVisible(0), tilesCulled(0), tilesPerLevel(), triangles(0),
+                       drawCalls(0), cullMs(0.0) {}
+    };
+
+    // Totals since construction
+    struct Stats {
+        size_t tilesUploaded;
+        size_t uploadBytes;
+        size_t tilesRejected;       // Did not fit in the shared buffers
+        size_t verticesUsed;
+        size_t indicesUsed;
+
+        Stats() : tilesUploaded(0), uploadBytes(0), tilesRejected(0), verticesUsed(0), indicesUsed(0) {}
+    };
+
+    TerrainRenderer();
+    explicit TerrainRenderer(const Config& config);
+    ~TerrainRenderer();
+
+    // Disable copy (owns GL objects)
+    TerrainRenderer(const TerrainRenderer&) = delete;
+    TerrainRenderer& operator=(const TerrainRenderer&) = delete;
+
+    // Compile the shader and allocate the buffers; needs a current GL
+    // context. Returns false with a message on stderr on failure
+    bool initialize();
+
+    // Replace the meshes of the tiles in a frame from TerrainMesher::takeFrame()
+    void upload(const TerrainMesher::MeshFrame& frame);
+
+    // Cull, pick levels and draw every visible tile. eye is the camera
+    // position, viewportHeight in pixels (for the screen-space error)
+    void draw(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& eye, float viewportHeight);
+
+    const FrameStats& getFrameStats() const { return frameStats_; }
+    const Stats& getStats() const { return stats_; }
+
+private:
+    // First-fit allocator of element ranges in a shared buffer
+    class RangeAllocator {
+    public:
+        explicit RangeAllocator(size_t capacity);
+        bool allocate(size_t count, size_t& offset);
+        void release(size_t offset, size_t count);
+        size_t used() const { return used_; }
+
+    private:
+        struct Range {
+            size_t offset;
+            size_t count;
+        };
+        std::vector<Range> free_;    // Sorted by offset, never adjacent
+        size_t used_;
+    };
+
+    struct TileSlot {
+        uint32_t tileIndex;
+        size_t vertexOffset;
+        size_t vertexCount;
+        size_t indexOffset;          // Level 0, then the coarser levels
+        size_t indexCount;
+        uint32_t levelFirst[TerrainMesher::LOD_LEVELS];   // Relative to indexOffset
+        uint32_t levelCount[TerrainMesher::LOD_LEVELS];
+        float levelError[TerrainMesher::LOD_LEVELS];
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+    };
+
+    // Matches the layout glMultiDrawElementsIndirect reads
+    struct DrawCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    void releaseSlot(size_t slot);
+
+    Config config_;
+    RangeAllocator vertexRanges_;
+    RangeAllocator indexRanges_;
+    std::vector<TileSlot> slots_;
+    std::vector<int32_t> slotOfTile_;        // Indexed by HeightMap tile index (-1: none)
+    std::vector<DrawCommand> commands_;      // Rebuilt every frame, capacity kept
+    std::vector<uint32_t> scratch_;          // One tile's indices, all levels
+
+    GLuint program_;
+    GLint viewProjectionLocation_;
+    GLuint vao_;
+    GLuint vertexBuffer_;
+    GLuint indexBuffer_;
+    GLuint commandBuffer_;
+    size_t commandCapacity_;
+    bool multiDrawIndirect_;                 // glMultiDrawElementsIndirect available (GL 4.3)
+
+    FrameStats frameStats_;
+    Stats stats_;
+};
+
+#endif // TERRAIN_RENDERER_H
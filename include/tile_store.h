@@ -0,0 +1,89 @@
+#ifndef TILE_STORE_H
+#define TILE_STORE_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Fixed-slot tile file, memory-mapped
+//
+// One slot per tile index, each page-aligned, after a small header and a
+// directory of per-tile entries. The file is created sparse, so only slots
+// that were written take disk space. Reopening an existing file only maps
+// it and reads the directory; tile data is paged in by the kernel when a
+// slot is touched.
+//
+// File layout (all little-endian, this machine's struct layout):
+//   [0, 4096)            FileHeader
+//   [4096, dataOffset)   Entry[tileCount]
+//   [dataOffset, ...)    tileCount slots of slotStride bytes
+class TileStore {
+public:
+    // Directory entry of one tile
+    struct Entry {
+        uint32_t present;        // 1 once the slot holds data
+        uint32_t version;        // Caller-defined (HeightMap: tile version)
+        uint8_t dirty;           // Caller-defined (HeightMap: dirty flag)
+        uint8_t reserved[7];
+    };
+
+    // Geometry a file is created for; reopening with a different one fails
+    struct Layout {
+        uint32_t tileCount;
+        uint32_t tileBytes;      // Payload per tile
+        uint64_t fingerprint;    // Caller-defined check of the payload format
+
+        Layout() : tileCount(0), tileBytes(0), fingerprint(0) {}
+    };
+
+    TileStore();
+    ~TileStore();
+
+    // Disable copy (owns the mapping)
+    TileStore(const TileStore&) = delete;
+    TileStore& operator=(const TileStore&) = delete;
+
+    // Open path, creating it if missing; false (message on stderr) on error
+    // or if an existing file was made for another layout
+    bool open(const std::string& path, const Layout& layout);
+    void close();
+    bool isOpen() const { return base_ != nullptr; }
+
+    // True if open() found an existing file
+    bool wasResumed() const { return resumed_; }
+
+    Entry& entry(uint32_t index) { return entries_[index]; }
+    const Entry& entry(uint32_t index) const { return entries_[index]; }
+
+    // Mapped payload of a slot (tileBytes long)
+    void* slot(uint32_t index) { return base_ + dataOffset_ + static_cast<size_t>(index) * slotStride_; }
+    const void* slot(uint32_t index) const { return base_ + dataOffset_ + static_cast<size_t>(index) * slotStride_; }
+
+    // Let the kernel drop a slot's pages from memory (contents stay in the file)
+    void release(uint32_t index);
+
+    // Forget every slot
+    void clear();
+
+    // Write everything to disk; false on error
+    bool sync();
+
+    const Layout& getLayout() const { return layout_; }
+    size_t getFileBytes() const { return fileBytes_; }
+    size_t getStoredTiles() const;
+
+private:
+    struct FileHeader;
+
+    std::string path_;
+    Layout layout_;
+    int fd_;
+    uint8_t* base_;
+    size_t fileBytes_;
+    size_t dataOffset_;
+    size_t slotStride_;
+    Entry* entries_;
+    bool resumed_;
+};
+
+#endif // TILE_STORE_H
@@ -0,0 +1,90 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+// Hashed timing wheel for a fixed set of timer IDs (0..timerCount-1)
+//
+// Each timer sits in the bucket of its deadline tick, in an intrusive
+// doubly-linked list, so schedule/cancel are O(1) and advance() only visits
+// the buckets that elapsed. Deadlines beyond one revolution stay in their
+// bucket until a later pass reaches them. Nothing allocates after construction.
+class TimerWheel {
+public:
+    static const uint32_t NONE = UINT32_MAX;
+
+    // tickNs: bucket width; slotCount * tickNs is one revolution
+    TimerWheel(size_t timerCount, size_t slotCount, uint64_t tickNs);
+
+    // Arm (or re-arm) a timer to fire at deadlineNs
+    void schedule(uint32_t id, uint64_t deadlineNs);
+
+    // Disarm a timer (no-op if not scheduled)
+    void cancel(uint32_t id);
+
+    bool isScheduled(uint32_t id) const { return entries_[id].scheduled; }
+    size_t size() const { return scheduledCount_; }
+
+    // Fire every timer with deadline <= nowNs, calling onExpire(id)
+    // Each timer is disarmed before its callback, which may re-schedule that
+    // same id but must not cancel other timers. Returns timers fired.
+    template <typename OnExpire>
+    size_t advance(uint64_t nowNs, OnExpire&& onExpire);
+
+private:
+    struct Entry {
+        uint64_t deadlineNs;
+        uint32_t prev;
+        uint32_t next;
+        uint32_t bucket;
+        bool scheduled;
+
+        Entry() : deadlineNs(0), prev(NONE), next(NONE), bucket(0), scheduled(false) {}
+    };
+
+    void unlink(uint32_t id);
+
+    std::vector<Entry> entries_;
+    std::vector<uint32_t> buckets_;     // Head entry per bucket
+    uint64_t tickNs_;
+    uint64_t nextTick_;                 // First tick not yet processed
+    size_t scheduledCount_;
+};
+
+template <typename OnExpire>
+size_t TimerWheel::advance(uint64_t nowNs, OnExpire&& onExpire) {
+    uint64_t nowTick = nowNs / tickNs_;
+    if (nowTick < nextTick_ || scheduledCount_ == 0) {
+        nextTick_ = std::max(nextTick_, nowTick + 1);
+        return 0;
+    }
+
+    // After a long gap every bucket is visited once, not once per tick
+    uint64_t ticks = nowTick - nextTick_ + 1;
+    if (ticks > buckets_.size()) {
+        ticks = buckets_.size();
+    }
+
+    size_t fired = 0;
+    for (uint64_t t = 0; t < ticks; ++t) {
+        size_t bucket = static_cast<size_t>((nextTick_ + t) % buckets_.size());
+        uint32_t id = buckets_[bucket];
+        while (id != NONE) {
+            uint32_t next = entries_[id].next;
+            if (entries_[id].deadlineNs <= nowNs) {
+                unlink(id);
+                fired++;
+                onExpire(id);
+            }
+            id = next;
+        }
+    }
+
+    nextTick_ = nowTick + 1;
+    return fired;
+}
+
+#endif // TIMER_WHEEL_H
@@ -7,7 +7,9 @@
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/euler_angles.hpp>
 #include <vector>
+#include <cstddef>
 #include "udp_packet_structures.h"
+#include "transform_kernels.h"
 
 class Transform {
 public:
@@ -31,6 +33,20 @@ public:
         const glm::mat4& transform,
         const std::vector<LidarPoint>& localPoints);
     
+    // Transform count points into a caller-provided buffer (SIMD, no allocation)
+    // worldPoints may alias localPoints
+    static void transformLidarPoints(const glm::mat4& transform,
+                                     const LidarPoint* localPoints, size_t count,
+                                     glm::vec3* worldPoints);
+    
+    // Same, writing separate x/y/z arrays (SoA)
+    static void transformLidarPointsSoA(const glm::mat4& transform,
+                                        const LidarPoint* localPoints, size_t count,
+                                        float* worldX, float* worldY, float* worldZ);
+    
+    // 3x4 affine part of a transform, for the batch kernels
+    static AffineTransform toAffine(const glm::mat4& transform);
+    
     // Utility: Convert degrees to radians
     static float degreesToRadians(float degrees) {
         return glm::radians(degrees);
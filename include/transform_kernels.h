@@ -0,0 +1,51 @@
+#ifndef TRANSFORM_KERNELS_H
+#define TRANSFORM_KERNELS_H
+
+#include <cstdint>
+#include <cstddef>
+#include "udp_packet_structures.h"
+
+// Batch point transform kernels (no GLM, no allocation)
+//
+// Points are transformed by the 3x4 affine part of a rigid transform:
+// world = R * local + t. The best kernel for the running CPU (AVX2+FMA,
+// SSE, or scalar) is chosen once at first use.
+
+// Row-major 3x4 affine matrix: world[r] = m[r][0]*x + m[r][1]*y + m[r][2]*z + m[r][3]
+struct AffineTransform {
+    float m[3][4];
+
+    // Identity transform
+    AffineTransform();
+};
+
+// Instruction set a kernel is written for
+enum class SimdLevel : uint8_t {
+    Scalar,
+    SSE,       // 4 points per step
+    AVX2       // 8 points per step, fused multiply-add
+};
+
+const char* simdLevelName(SimdLevel level);
+
+// Best level supported by this CPU (and build)
+SimdLevel detectSimdLevel();
+
+// Transform count points from in to out (AoS, same layout as LidarPoint)
+// out may equal in; any other overlap is not allowed
+void transformPoints(const AffineTransform& transform, const LidarPoint* in,
+                     size_t count, LidarPoint* out);
+
+// Transform count points and split them into x/y/z arrays (SoA)
+void transformPointsSoA(const AffineTransform& transform, const LidarPoint* in,
+                        size_t count, float* outX, float* outY, float* outZ);
+
+// Same, forcing a kernel (for tests and benchmarks)
+// A level the CPU does not support falls back to the best supported one
+void transformPoints(const AffineTransform& transform, const LidarPoint* in,
+                     size_t count, LidarPoint* out, SimdLevel level);
+void transformPointsSoA(const AffineTransform& transform, const LidarPoint* in,
+                        size_t count, float* outX, float* outY, float* outZ,
+                        SimdLevel level);
+
+#endif // TRANSFORM_KERNELS_H
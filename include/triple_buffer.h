@@ -0,0 +1,67 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Latest-value handoff between one writer and one reader thread
+//
+// Three copies of T: the writer fills its back copy and publishes it by
+// swapping it with the middle one; the reader swaps the middle copy into
+// its front copy when a newer one was published. Both swaps are a single
+// atomic exchange, so neither side ever waits for the other: a slow reader
+// only skips values, a fast writer never blocks. Values that were never
+// read are overwritten.
+//
+// T needs no special properties (it may own resources); each copy is only
+// ever touched by the side currently holding it. The writer's back copy
+// still holds the value published two writes ago, so overwrite it fully.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle_(1), front_(0), back_(2) {}
+
+    // Disable copy (atomics)
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer: the copy to fill before publish()
+    T& back() noexcept { return slots_[back_]; }
+
+    // Writer: make the back copy the newest value
+    void publish() noexcept {
+        back_ = middle_.exchange(static_cast<uint8_t>(back_ | FRESH), std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Writer: copy a value in and publish it
+    void publish(const T& value) {
+        back() = value;
+        publish();
+    }
+
+    // Reader: take the newest published value if there is one
+    // Returns true if front() changed
+    bool update() noexcept {
+        if ((middle_.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    // Reader: the value taken by the last update() (default T before any)
+    const T& front() const noexcept { return slots_[front_]; }
+
+private:
+    static const uint8_t INDEX_MASK = 0x3;
+    static const uint8_t FRESH = 0x4;       // Middle copy not taken by the reader yet
+
+    T slots_[3];
+
+    // Writer and reader indices on separate cache lines
+    alignas(64) std::atomic<uint8_t> middle_;
+    alignas(64) uint8_t front_;             // Reader only
+    alignas(64) uint8_t back_;              // Writer only
+};
+
+#endif // TRIPLE_BUFFER_H
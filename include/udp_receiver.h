@@ -4,9 +4,60 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <cstddef>
+#include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 
+// Largest datagram a batch slot can hold (LidarPacket is 1220 bytes)
+static const size_t MAX_DATAGRAM_SIZE = 2048;
+
+// Ancillary data space per datagram (one SO_TIMESTAMPNS timespec), in 8-byte words
+static const size_t RECEIVE_CONTROL_WORDS = 8;
+
+// Caller-owned ring of fixed-size datagram slots filled by receiveBatch().
+// All storage is allocated once in the constructor, so receiving into a
+// batch never touches the heap.
+class ReceiveBatch {
+public:
+    explicit ReceiveBatch(size_t capacity);
+    
+    // Disable copy (the kernel headers point into our own storage)
+    ReceiveBatch(const ReceiveBatch&) = delete;
+    ReceiveBatch& operator=(const ReceiveBatch&) = delete;
+    
+    // Number of slots available for one receiveBatch() call
+    size_t capacity() const { return capacity_; }
+    
+    // Number of datagrams filled by the last receiveBatch() call
+    size_t size() const { return count_; }
+    
+    // Access a received datagram (index < size())
+    const uint8_t* data(size_t index) const { return &storage_[index * MAX_DATAGRAM_SIZE]; }
+    size_t length(size_t index) const { return messages_[index].msg_len; }
+    const struct sockaddr_in& sender(size_t index) const { return senders_[index]; }
+    
+    // Arrival time (CLOCK_REALTIME ns): kernel timestamp when enabled on the
+    // receiver, otherwise the time receiveBatch() returned
+    uint64_t arrivalNs(size_t index) const { return arrivals_[index]; }
+    
+private:
+    friend class UDPReceiver;
+    
+    // Re-arm every header before handing the batch to the kernel
+    void prepare();
+    
+    size_t capacity_;
+    size_t count_;
+    std::vector<uint8_t> storage_;              // capacity * MAX_DATAGRAM_SIZE bytes
+    std::vector<struct iovec> iovecs_;          // One iovec per slot
+    std::vector<struct sockaddr_in> senders_;   // Sender address per slot
+    std::vector<struct mmsghdr> messages_;      // recvmmsg headers (lengths live here)
+    std::vector<uint64_t> control_;             // Ancillary data, RECEIVE_CONTROL_WORDS per slot
+    std::vector<uint64_t> arrivals_;            // Arrival time per slot
+};
+
 class UDPReceiver {
 public:
     // Constructor - creates socket and binds to port
@@ -22,27 +73,50 @@ public:
     // Set socket to non-blocking mode
     void setNonBlocking(bool nonBlocking);
     
+    // Set kernel receive buffer size (SO_RCVBUF) to absorb bursts
+    void setReceiveBufferSize(int bytes);
+    
+    // Ask the kernel to stamp each datagram on arrival (SO_TIMESTAMPNS)
+    void enableTimestamps(bool enable);
+    bool timestampsEnabled() const { return timestampsEnabled_; }
+    
     // Receive data from socket
     // Returns number of bytes received, or -1 if no data available (non-blocking)
     // or 0 on error
     ssize_t receive(void* buffer, size_t bufferSize);
     
+    // Receive up to batch.capacity() datagrams with a single recvmmsg call
+    // Returns number of datagrams received, or -1 if no data available
+    // (non-blocking) or 0 on error
+    int receiveBatch(ReceiveBatch& batch);
+    
     // Get last sender's address info
     std::string getLastSenderAddress() const;
     uint16_t getLastSenderPort() const;
     
+    // Arrival time of the last datagram from receive() (CLOCK_REALTIME ns)
+    uint64_t getLastArrivalNs() const { return lastArrivalNs_; }
+    
     // Check if socket is valid
     bool isValid() const { return socketFd_ >= 0; }
     
     // Get the port this receiver is bound to
     uint16_t getPort() const { return port_; }
     
+    // Get the underlying descriptor (for epoll registration)
+    int getFd() const { return socketFd_; }
+    
 private:
+    // Shared recvmmsg path for receive() and receiveBatch()
+    int receiveMessages(struct mmsghdr* messages, unsigned int count);
+    
     int socketFd_;                     // Socket file descriptor
     uint16_t port_;                    // Port we're listening on
     struct sockaddr_in serverAddr_;    // Our address
     struct sockaddr_in senderAddr_;    // Last sender's address
     socklen_t senderAddrLen_;          // Size of sender address structure
+    bool timestampsEnabled_;           // SO_TIMESTAMPNS is set
+    uint64_t lastArrivalNs_;           // Arrival time of last receive()
 };
 
 #endif // UDP_RECEIVER_H
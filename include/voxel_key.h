@@ -0,0 +1,42 @@
+#ifndef VOXEL_KEY_H
+#define VOXEL_KEY_H
+
+#include <cmath>
+#include <cstdint>
+
+// Integer grid coordinates packed into hash keys, shared by VoxelMap (block
+// coordinates) and PointFilter (voxel coordinates). Internal to those two.
+
+// Keys hold 21 bits per axis, so packed coordinates stay below 2^20
+const float VOXEL_KEY_RANGE = 1048576.0f;
+
+inline uint64_t packVoxelKey(int32_t x, int32_t y, int32_t z) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x) & 0x1FFFFFu) << 42) |
+           (static_cast<uint64_t>(static_cast<uint32_t>(y) & 0x1FFFFFu) << 21) |
+           static_cast<uint64_t>(static_cast<uint32_t>(z) & 0x1FFFFFu);
+}
+
+// Fibonacci hashing of a packed key into a table of 2^(64 - shift) slots
+inline uint32_t voxelKeySlot(uint64_t key, uint32_t shift) {
+    return static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ull) >> shift);
+}
+
+inline int32_t floorToInt(float value) {
+    int32_t i = static_cast<int32_t>(value);
+    return i - (static_cast<float>(i) > value ? 1 : 0);
+}
+
+// Grid coordinates of a point already divided by the cell size; false if
+// any axis is NaN or not below range in magnitude
+inline bool gridCoordinates(float fx, float fy, float fz, float range, int32_t v[3]) {
+    // Written so NaN fails too
+    if (!(std::fabs(fx) < range && std::fabs(fy) < range && std::fabs(fz) < range)) {
+        return false;
+    }
+    v[0] = floorToInt(fx);
+    v[1] = floorToInt(fy);
+    v[2] = floorToInt(fz);
+    return true;
+}
+
+#endif // VOXEL_KEY_H
@@ -0,0 +1,154 @@
+#ifndef VOXEL_MAP_H
+#define VOXEL_MAP_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Sparse voxel occupancy map with coarser levels of detail
+//
+// Space is cut into blocks of 8x8x8 voxels. Blocks live in one contiguous
+// pool per level and are found through an open-addressing hash keyed by
+// block coordinates, so there are no per-voxel heap nodes. Every voxel holds
+// a clamped occupancy log-odds (0 = never observed), quantised to one byte
+// in steps of 1/LOG_ODDS_SCALE so a block is 512 bytes.
+//
+// Level 0 has the configured voxel size; each further level doubles it.
+// A coarse voxel holds the maximum of its 8 children, kept up to date on
+// every insert, so a coarse level never hides an occupied fine voxel.
+//
+// Not thread-safe: one thread inserts and queries.
+class VoxelMap {
+public:
+    static const uint32_t BLOCK_SIZE = 8;                    // Voxels per block edge
+    static const uint32_t BLOCK_VOXELS = BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE;
+    static const uint32_t MAX_LEVELS = 8;
+    static constexpr float LOG_ODDS_SCALE = 16.0f;           // Quantisation steps per unit
+
+    struct Config {
+        float voxelSize;         // Level 0 voxel edge in world units
+        uint32_t levels;         // Level 0 plus coarser ones (1..MAX_LEVELS)
+        float hitLogOdds;        // Added per point landing in a voxel
+        float missLogOdds;       // Added per free-space observation (negative)
+        float minLogOdds;        // Clamp, so a voxel can change its mind quickly
+        float maxLogOdds;        // (both within +-127 / LOG_ODDS_SCALE)
+        float occupiedLogOdds;   // Occupied when log-odds is above this
+        uint32_t initialBlocks;  // Blocks reserved per level up front
+
+        Config() : voxelSize(0.2f), levels(3), hitLogOdds(0.85f), missLogOdds(-0.4f),
+                   minLogOdds(-2.0f), maxLogOdds(3.5f), occupiedLogOdds(0.0f),
+                   initialBlocks(1024) {}
+    };
+
+    // 8x8x8 voxels; index = (z * 8 + y) * 8 + x within the block
+    struct Block {
+        int32_t x, y, z;         // Block coordinates (voxel coordinates / 8)
+        int8_t logOdds[BLOCK_VOXELS];   // Quantised, see LOG_ODDS_SCALE
+    };
+
+    struct Stats {
+        size_t pointsInserted;
+        size_t missesInserted;
+        size_t pointsRejected;   // NaN or beyond the addressable range
+        size_t memoryBytes;      // Block pools plus hash tables, all levels
+
+        Stats() : pointsInserted(0), missesInserted(0), pointsRejected(0), memoryBytes(0) {}
+    };
+
+    VoxelMap();
+    explicit VoxelMap(const Config& config);
+
+    // Disable copy (large pools)
+    VoxelMap(const VoxelMap&) = delete;
+    VoxelMap& operator=(const VoxelMap&) = delete;
+
+    // Record occupied observations (e.g. Transform::transformLidarPoints output)
+    // Returns points accepted
+    size_t insert(const glm::vec3* points, size_t count);
+    size_t insert(const std::vector<glm::vec3>& points) { return insert(points.data(), points.size()); }
+
+    // Record free-space observations at the given positions
+    size_t insertMisses(const glm::vec3* points, size_t count);
+
+    // Log-odds of the voxel containing point at a level (0 if never observed)
+    float getLogOdds(const glm::vec3& point, uint32_t level = 0) const;
+    bool isOccupied(const glm::vec3& point, uint32_t level = 0) const {
+        return getLogOdds(point, level) > static_cast<float>(q_.occupied) / LOG_ODDS_SCALE;
+    }
+
+    // Call fn(center, voxelSize, logOdds) for every occupied voxel of a level
+    template <typename Fn>
+    void forEachOccupied(uint32_t level, Fn&& fn) const;
+
+    const Config& getConfig() const { return config_; }
+    uint32_t getLevelCount() const { return config_.levels; }
+    float getVoxelSize(uint32_t level) const { return levels_[level].voxelSize; }
+    size_t getBlockCount(uint32_t level) const { return levels_[level].blocks.size(); }
+    const std::vector<Block>& getBlocks(uint32_t level) const { return levels_[level].blocks; }
+    const Stats& getStats() const { return stats_; }
+
+    // Drop every block (pools and tables keep their capacity)
+    void clear();
+
+private:
+    struct Level {
+        float voxelSize;
+        float invVoxelSize;
+        std::vector<Block> blocks;          // Pool, indexed by the hash table
+        std::vector<uint64_t> keys;         // Open addressing, EMPTY_KEY when free
+        std::vector<uint32_t> indices;      // Block index per hash slot
+        uint32_t shift;                     // 64 - log2(table size)
+        uint64_t cachedKey;                 // Last block found (consecutive points)
+        uint32_t cachedIndex;
+    };
+
+    // Config log-odds in quantised steps
+    struct Quantised {
+        int32_t hit;
+        int32_t miss;
+        int32_t min;
+        int32_t max;
+        int32_t occupied;
+    };
+
+    static const uint64_t EMPTY_KEY = ~0ull;
+
+    // Block index for a key, or UINT32_MAX
+    uint32_t findBlock(const Level& level, uint64_t key) const;
+    uint32_t findOrAddBlock(Level& level, int32_t bx, int32_t by, int32_t bz);
+    void growTable(Level& level);
+
+    // Voxel coordinates of a point at a level; false if NaN or out of range
+    bool voxelOf(const glm::vec3& point, const Level& level, int32_t v[3]) const;
+
+    size_t integrate(const glm::vec3* points, size_t count, bool hit);
+    void updateVoxel(int32_t vx, int32_t vy, int32_t vz, bool hit);
+    void updateMemoryStats();
+
+    Config config_;
+    Quantised q_;
+    std::vector<Level> levels_;
+    Stats stats_;
+};
+
+template <typename Fn>
+void VoxelMap::forEachOccupied(uint32_t level, Fn&& fn) const {
+    const Level& lv = levels_[level];
+    for (const Block& block : lv.blocks) {
+        for (uint32_t i = 0; i < BLOCK_VOXELS; ++i) {
+            if (block.logOdds[i] <= q_.occupied) {
+                continue;
+            }
+            int32_t vx = block.x * static_cast<int32_t>(BLOCK_SIZE) + static_cast<int32_t>(i % BLOCK_SIZE);
+            int32_t vy = block.y * static_cast<int32_t>(BLOCK_SIZE) + static_cast<int32_t>((i / BLOCK_SIZE) % BLOCK_SIZE);
+            int32_t vz = block.z * static_cast<int32_t>(BLOCK_SIZE) + static_cast<int32_t>(i / (BLOCK_SIZE * BLOCK_SIZE));
+            glm::vec3 center((static_cast<float>(vx) + 0.5f) * lv.voxelSize,
+                             (static_cast<float>(vy) + 0.5f) * lv.voxelSize,
+                             (static_cast<float>(vz) + 0.5f) * lv.voxelSize);
+            fn(center, lv.voxelSize, static_cast<float>(block.logOdds[i]) / LOG_ODDS_SCALE);
+        }
+    }
+}
+
+#endif // VOXEL_MAP_H
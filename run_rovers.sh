@@ -1,16 +1,26 @@
 #!/bin/bash
 
-# Check if --no-noise is passed
-NOISE_FLAG=""
-if [[ "$1" == "--no-noise" ]]; then
-    NOISE_FLAG="--no-noise"
-fi
+# Usage: ./run_rovers.sh [--rovers N] [emulator options...]
+#   --rovers N   start rovers 1..N (default 5; IDs above 5 are synthetic)
+#   Everything else (--no-noise, --rate, --points, --loop, --duration,
+#   --drop, --reorder, --duplicate) is passed to every rover_emulator.
+ROVERS=5
+EMULATOR_ARGS=()
+while [[ $# -gt 0 ]]; do
+    if [[ "$1" == "--rovers" ]]; then
+        ROVERS="$2"
+        shift 2
+    else
+        EMULATOR_ARGS+=("$1")
+        shift
+    fi
+done
 
-# Start rover emulator instances for IDs 1-5
+# Start rover emulator instances for IDs 1-N
 PIDS=()
 
-for ID in {1..5}; do
-    ./rover_emulator "$ID" $NOISE_FLAG &  # Append the noise flag if specified
+for ((ID = 1; ID <= ROVERS; ID++)); do
+    ./rover_emulator "$ID" "${EMULATOR_ARGS[@]}" &
     PIDS+=($!)  # Store PID
 done
 
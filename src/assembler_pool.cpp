@@ -0,0 +1,193 @@
+#include "assembler_pool.h"
+#include "../emulator/rover_profiles.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <pthread.h>
+#include <sched.h>
+
+AssemblerPool::Shard::Shard(uint32_t id, const Config& config)
+    : roverId(id),
+      entries(std::max<size_t>(config.inboxDepth, 1)),
+      filled(entries.size()),
+      free(entries.size()),
+      sleeping(false),
+      inboxDrops(0) {
+    LidarAssembler::Config assemblerConfig = config.assembler;
+    assemblerConfig.roverId = id;
+    assembler = std::make_unique<LidarAssembler>(assemblerConfig);
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        free.push(static_cast<uint32_t>(i));
+    }
+}
+
+AssemblerPool::AssemblerPool() : AssemblerPool(Config()) {
+}
+
+AssemblerPool::AssemblerPool(const Config& config)
+    : config_(config), stopRequested_(false), running_(false), unknownRoverChunks_(0) {
+}
+
+AssemblerPool::~AssemblerPool() {
+    stop();
+}
+
+bool AssemblerPool::addRover(uint32_t roverId) {
+    if (running_ || findShard(roverId) != nullptr) {
+        return false;
+    }
+
+    shards_.push_back(std::make_unique<Shard>(roverId, config_));
+    if (roverId >= byRover_.size()) {
+        byRover_.resize(roverId + 1, nullptr);
+    }
+    byRover_[roverId] = shards_.back().get();
+    return true;
+}
+
+void AssemblerPool::addRoversFromProfiles() {
+    for (const auto& [id, profile] : g_roverProfiles) {
+        (void)profile;
+        addRover(static_cast<uint32_t>(std::stoul(id)));
+    }
+}
+
+void AssemblerPool::start() {
+    if (running_) return;
+
+    stopRequested_.store(false);
+    unsigned cores = std::thread::hardware_concurrency();
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        unsigned core = cores > 0 ? static_cast<unsigned>((config_.firstCore + i) % cores) : 0;
+        Shard& shard = *shards_[i];
+        shard.worker = std::thread(&AssemblerPool::workerLoop, this, std::ref(shard), core);
+    }
+    running_ = true;
+}
+
+void AssemblerPool::stop() {
+    if (!running_) return;
+
+    stopRequested_.store(true);
+    for (auto& shard : shards_) {
+        {
+            std::lock_guard<std::mutex> lock(shard->wakeMutex);
+            shard->wakeCond.notify_one();
+        }
+        shard->worker.join();
+    }
+    running_ = false;
+}
+
+void AssemblerPool::onLidar(uint32_t roverId, const LidarPacket& packet, uint64_t arrivalNs) {
+    Shard* shard = findShard(roverId);
+    if (shard == nullptr) {
+        unknownRoverChunks_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // No free entry: the worker is behind, shed load here rather than block
+    uint32_t index;
+    if (!shard->free.pop(index)) {
+        shard->inboxDrops.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Copy only the points the chunk actually carries
+    InboxEntry& entry = shard->entries[index];
+    uint32_t points = std::min<uint32_t>(packet.header.pointsInThisChunk,
+                                         MAX_LIDAR_POINTS_PER_PACKET);
+    entry.packet.header = packet.header;
+    memcpy(entry.packet.points, packet.points, points * sizeof(LidarPoint));
+    entry.arrivalNs = arrivalNs;
+    shard->filled.push(index);   // Cannot fail: entries and ring have equal size
+
+    // Pairs with the fence in workerLoop so a wake-up is never missed
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (shard->sleeping.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(shard->wakeMutex);
+        shard->wakeCond.notify_one();
+    }
+}
+
+void AssemblerPool::workerLoop(Shard& shard, unsigned core) {
+    std::string name = "asm-rover-" + std::to_string(shard.roverId);
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+
+    if (config_.pinWorkers) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(core, &cpus);
+        int result = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (result != 0) {
+            std::cerr << "Failed to pin assembler for rover " << shard.roverId
+                      << " to core " << core << ": " << strerror(result) << std::endl;
+        }
+    }
+
+    auto idle = std::chrono::duration<double, std::milli>(config_.idlePollMs);
+    LidarAssembler& assembler = *shard.assembler;
+
+    while (!stopRequested_.load(std::memory_order_relaxed)) {
+        uint32_t index;
+        bool worked = false;
+        while (shard.filled.pop(index)) {
+            const InboxEntry& entry = shard.entries[index];
+            assembler.addPacket(entry.packet, entry.arrivalNs);
+            shard.free.push(index);
+            worked = true;
+        }
+        if (worked) continue;
+
+        // Idle: expire stale scans, then sleep until a chunk or the next tick
+        assembler.poll();
+
+        std::unique_lock<std::mutex> lock(shard.wakeMutex);
+        shard.sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (shard.filled.empty() && !stopRequested_.load(std::memory_order_relaxed)) {
+            shard.wakeCond.wait_for(lock, idle);
+        }
+        shard.sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+bool AssemblerPool::getCompleteScan(uint32_t roverId, ScanHandle& scan) {
+    Shard* shard = findShard(roverId);
+    return shard != nullptr && shard->assembler->getCompleteScan(scan);
+}
+
+LidarAssembler* AssemblerPool::getAssembler(uint32_t roverId) {
+    Shard* shard = findShard(roverId);
+    return shard != nullptr ? shard->assembler.get() : nullptr;
+}
+
+std::vector<uint32_t> AssemblerPool::getRoverIds() const {
+    std::vector<uint32_t> ids;
+    ids.reserve(shards_.size());
+    for (const auto& shard : shards_) {
+        ids.push_back(shard->roverId);
+    }
+    return ids;
+}
+
+AssemblerPool::Stats AssemblerPool::getStats() const {
+    Stats stats;
+    stats.rovers = shards_.size();
+    stats.unknownRoverChunks = unknownRoverChunks_.load(std::memory_order_relaxed);
+
+    for (const auto& shard : shards_) {
+        const LidarAssembler& assembler = *shard->assembler;
+        stats.chunksReceived += assembler.getTotalChunksReceived();
+        stats.scansCompleted += assembler.getTotalScansCompleted();
+        stats.droppedChunks += assembler.getDroppedChunks();
+        stats.droppedScans += assembler.getDroppedScans();
+        stats.partialScansEmitted += assembler.getPartialScansEmitted();
+        stats.staleScans += assembler.getStaleScans();
+        stats.inboxDrops += shard->inboxDrops.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
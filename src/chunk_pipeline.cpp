@@ -0,0 +1,200 @@
+#include "chunk_pipeline.h"
+#include "transform.h"
+#include <algorithm>
+#include <limits>
+
+// Per-rover assembler that only keeps bookkeeping
+static LidarAssembler::Config bookkeepingConfig(const LidarAssembler::Config& base, uint32_t roverId) {
+    LidarAssembler::Config config = base;
+    config.roverId = roverId;
+    config.retainPoints = false;
+    return config;
+}
+
+ChunkPipeline::RoverState::RoverState(uint32_t id, const Config& config)
+    : roverId(id),
+      poses(config.poseHistoryCapacity),
+      assembler(bookkeepingConfig(config.assembler, id)),
+      lastCompleteTimestamp(std::numeric_limits<double>::quiet_NaN()),
+      pending(std::max<size_t>(config.pendingChunks, 1)),
+      pendingHead(0),
+      pendingCount(0),
+      pendingScans(0) {
+}
+
+ChunkPipeline::ChunkPipeline(ChunkSink& sink) : ChunkPipeline(sink, Config()) {
+}
+
+ChunkPipeline::ChunkPipeline(ChunkSink& sink, const Config& config)
+    : sink_(sink), config_(config), worldPoints_(MAX_LIDAR_POINTS_PER_PACKET), latency_(nullptr) {
+}
+
+bool ChunkPipeline::addRover(uint32_t roverId) {
+    if (findRover(roverId) != nullptr) {
+        return false;
+    }
+
+    rovers_.push_back(std::make_unique<RoverState>(roverId, config_));
+    if (roverId >= byRover_.size()) {
+        byRover_.resize(roverId + 1, nullptr);
+    }
+    byRover_[roverId] = rovers_.back().get();
+    return true;
+}
+
+void ChunkPipeline::onPose(uint32_t roverId, const PosePacket& pose, uint64_t arrivalNs) {
+    (void)arrivalNs;
+    RoverState* rover = findRover(roverId);
+    if (rover != nullptr) {
+        rover->poses.addPose(pose);
+        drainPending(*rover);
+    }
+}
+
+void ChunkPipeline::onLidar(uint32_t roverId, const LidarPacket& packet, uint64_t arrivalNs) {
+    RoverState* rover = findRover(roverId);
+    if (rover == nullptr) {
+        stats_.unknownRoverChunks++;
+        return;
+    }
+
+    // A duplicate would reach the sink twice, or reopen a scan that just
+    // completed as a new partial one
+    double timestamp = packet.header.timestamp;
+    if (timestamp == rover->lastCompleteTimestamp ||
+        rover->assembler.hasChunk(timestamp, packet.header.chunkIndex)) {
+        stats_.duplicateChunks++;
+        return;
+    }
+
+    // Bookkeeping first, so onScanComplete follows the scan's last chunk
+    bool queued = rover->assembler.addPacket(packet, arrivalNs);
+
+    // Chunks behind waiting ones wait too, so the sink sees arrival order
+    glm::mat4 transform;
+    PoseMatch match = rover->pendingCount > 0 ? PoseMatch::None
+                                              : rover->poses.lookup(timestamp, transform);
+    if (match == PoseMatch::Interpolated) {
+        forwardChunk(*rover, packet, arrivalNs, transform);
+    } else if (match == PoseMatch::HeldOldest) {
+        stats_.chunksDroppedPose++;
+    } else {
+        Pending& entry = pushPending(*rover);
+        entry.packet = packet;
+        entry.arrivalNs = arrivalNs;
+        stats_.chunksDeferred++;
+    }
+
+    if (queued) {
+        drainScans(*rover);
+    }
+}
+
+void ChunkPipeline::forwardChunk(RoverState& rover, const LidarPacket& packet, uint64_t arrivalNs,
+                                 const glm::mat4& transform) {
+    size_t count = std::min<size_t>(packet.header.pointsInThisChunk, MAX_LIDAR_POINTS_PER_PACKET);
+    Transform::transformLidarPoints(transform, packet.points, count, worldPoints_.data());
+
+    WorldChunk chunk;
+    chunk.roverId = rover.roverId;
+    chunk.scanTimestamp = packet.header.timestamp;
+    chunk.chunkIndex = packet.header.chunkIndex;
+    chunk.totalChunks = packet.header.totalChunks;
+    chunk.points = worldPoints_.data();
+    chunk.pointCount = count;
+    chunk.arrivalNs = arrivalNs;
+
+    if (latency_ != nullptr) {
+        latency_->recordSince(rover.roverId, LatencyStage::ChunkToWorld, arrivalNs);
+    }
+    sink_.onWorldChunk(chunk);
+
+    stats_.chunksTransformed++;
+    stats_.pointsTransformed += count;
+}
+
+void ChunkPipeline::poll() {
+    for (auto& rover : rovers_) {
+        if (rover->assembler.poll()) {
+            drainScans(*rover);
+        }
+    }
+}
+
+void ChunkPipeline::drainScans(RoverState& rover) {
+    ScanHandle scan;
+    while (rover.assembler.getCompleteScan(scan)) {
+        if (scan.isComplete()) {
+            rover.lastCompleteTimestamp = scan.timestamp();
+        }
+        if (rover.pendingCount > 0) {
+            pushPending(rover).scan = std::move(scan);
+            rover.pendingScans++;
+            while (rover.pendingScans > config_.pendingScans) {
+                givePendingUp(rover);
+            }
+        } else {
+            sink_.onScanComplete(rover.roverId, scan);
+        }
+    }
+}
+
+ChunkPipeline::Pending& ChunkPipeline::pushPending(RoverState& rover) {
+    if (rover.pendingCount == rover.pending.size()) {
+        givePendingUp(rover);
+    }
+    size_t index = (rover.pendingHead + rover.pendingCount) % rover.pending.size();
+    rover.pendingCount++;
+    return rover.pending[index];
+}
+
+void ChunkPipeline::givePendingUp(RoverState& rover) {
+    Pending& oldest = rover.pending[rover.pendingHead];
+    if (oldest.scan.valid()) {
+        sink_.onScanComplete(rover.roverId, oldest.scan);
+    } else {
+        stats_.chunksDroppedPose++;
+    }
+    popPending(rover);
+}
+
+void ChunkPipeline::drainPending(RoverState& rover) {
+    while (rover.pendingCount > 0) {
+        Pending& entry = rover.pending[rover.pendingHead];
+        if (entry.scan.valid()) {
+            sink_.onScanComplete(rover.roverId, entry.scan);
+        } else {
+            glm::mat4 transform;
+            PoseMatch match = rover.poses.lookup(entry.packet.header.timestamp, transform);
+            if (match == PoseMatch::HeldNewest || match == PoseMatch::None) {
+                return;  // Still ahead of every pose
+            }
+            if (match == PoseMatch::Interpolated) {
+                forwardChunk(rover, entry.packet, entry.arrivalNs, transform);
+            } else {
+                stats_.chunksDroppedPose++;
+            }
+        }
+        popPending(rover);
+    }
+}
+
+void ChunkPipeline::popPending(RoverState& rover) {
+    Pending& entry = rover.pending[rover.pendingHead];
+    if (entry.scan.valid()) {
+        entry.scan.reset();
+        rover.pendingScans--;
+    }
+    rover.pendingHead = (rover.pendingHead + 1) % rover.pending.size();
+    rover.pendingCount--;
+}
+
+const PoseHistory* ChunkPipeline::getPoseHistory(uint32_t roverId) const {
+    RoverState* rover = findRover(roverId);
+    return rover != nullptr ? &rover->poses : nullptr;
+}
+
+const LidarAssembler* ChunkPipeline::getAssembler(uint32_t roverId) const {
+    RoverState* rover = findRover(roverId);
+    return rover != nullptr ? &rover->assembler : nullptr;
+}
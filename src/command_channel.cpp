@@ -0,0 +1,186 @@
+#include "command_channel.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+CommandChannel::CommandChannel(IngestHandler* downstream) : CommandChannel(downstream, Config()) {
+}
+
+CommandChannel::CommandChannel(IngestHandler* downstream, const Config& config)
+    : downstream_(downstream),
+      config_(config),
+      socket_(-1),
+      pendingCount_(0),
+      requests_(config.requestDepth),
+      requestsDropped_(0),
+      latency_(nullptr) {
+    std::memset(&address_, 0, sizeof(address_));
+    if (inet_pton(AF_INET, config_.address.c_str(), &address_) != 1) {
+        std::cerr << "Error: bad rover command address " << config_.address << std::endl;
+        return;
+    }
+
+    socket_ = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (socket_ < 0) {
+        std::cerr << "Error creating command socket: " << strerror(errno) << std::endl;
+    }
+}
+
+CommandChannel::~CommandChannel() {
+    if (socket_ >= 0) {
+        close(socket_);
+    }
+}
+
+bool CommandChannel::addRover(const RoverPorts& ports) {
+    if (findRover(ports.roverId) != nullptr) {
+        return false;
+    }
+
+    auto rover = std::make_unique<Rover>();
+    rover->roverId = ports.roverId;
+    std::memset(&rover->destination, 0, sizeof(rover->destination));
+    rover->destination.sin_family = AF_INET;
+    rover->destination.sin_port = htons(ports.cmdPort);
+    rover->destination.sin_addr = address_;
+    rover->measurable = false;
+    rover->firstSentNs = 0;
+    rover->deadlineNs = 0;
+
+    if (ports.roverId >= byRover_.size()) {
+        byRover_.resize(ports.roverId + 1, nullptr);
+    }
+    byRover_[ports.roverId] = rover.get();
+    rovers_.push_back(std::move(rover));
+    return true;
+}
+
+bool CommandChannel::send(uint32_t roverId, uint8_t buttons) {
+    Rover* rover = findRover(roverId);
+    if (rover == nullptr) {
+        return false;
+    }
+
+    Status& status = rover->status;
+    if (status.pending) {
+        stats_.superseded++;
+        settle(*rover);
+    }
+    status.requested = buttons;
+    status.attempts = 0;
+    rover->measurable = !status.hasTelemetry || status.reported != buttons;
+    rover->firstSentNs = realtimeNowNs();
+    stats_.commands++;
+
+    // Tracked even if this send fails: poll() retries it
+    status.pending = true;
+    pendingCount_++;
+    return transmit(*rover);
+}
+
+bool CommandChannel::request(uint32_t roverId, uint8_t buttons) {
+    if (!requests_.push((static_cast<uint64_t>(roverId) << 8) | buttons)) {
+        requestsDropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void CommandChannel::poll() {
+    uint64_t queued = 0;
+    while (requests_.pop(queued)) {
+        send(static_cast<uint32_t>(queued >> 8), static_cast<uint8_t>(queued & 0xFF));
+    }
+    if (pendingCount_ == 0) {
+        return;
+    }
+
+    uint64_t now = steadyNowNs();
+    for (auto& rover : rovers_) {
+        if (!rover->status.pending || now < rover->deadlineNs) {
+            continue;
+        }
+        if (rover->status.attempts > config_.maxRetries) {
+            stats_.failed++;
+            settle(*rover);
+            continue;
+        }
+        stats_.retries++;
+        transmit(*rover);
+    }
+}
+
+void CommandChannel::onPose(uint32_t roverId, const PosePacket& pose, uint64_t arrivalNs) {
+    if (downstream_ != nullptr) {
+        downstream_->onPose(roverId, pose, arrivalNs);
+    }
+}
+
+void CommandChannel::onLidar(uint32_t roverId, const LidarPacket& packet, uint64_t arrivalNs) {
+    if (downstream_ != nullptr) {
+        downstream_->onLidar(roverId, packet, arrivalNs);
+    }
+}
+
+void CommandChannel::onTelemetry(uint32_t roverId, const VehicleTelem& telem, uint64_t arrivalNs) {
+    Rover* rover = findRover(roverId);
+    if (rover != nullptr) {
+        Status& status = rover->status;
+        status.hasTelemetry = true;
+        status.reported = telem.buttonStates;
+
+        // Telemetry that arrived before the first send cannot be its echo
+        if (status.pending && arrivalNs >= rover->firstSentNs) {
+            if (!rover->measurable) {
+                // Bits were already set: any later telemetry confirms them
+                stats_.unmeasured++;
+                stats_.confirmed++;
+                settle(*rover);
+            } else if (telem.buttonStates == status.requested) {
+                status.lastRoundTripNs = arrivalNs - rover->firstSentNs;
+                if (latency_ != nullptr) {
+                    latency_->record(roverId, LatencyStage::CommandRoundTrip, status.lastRoundTripNs);
+                }
+                stats_.confirmed++;
+                settle(*rover);
+            }
+        }
+    }
+    if (downstream_ != nullptr) {
+        downstream_->onTelemetry(roverId, telem, arrivalNs);
+    }
+}
+
+bool CommandChannel::getStatus(uint32_t roverId, Status& status) const {
+    Rover* rover = findRover(roverId);
+    if (rover == nullptr) {
+        return false;
+    }
+    status = rover->status;
+    return true;
+}
+
+bool CommandChannel::transmit(Rover& rover) {
+    rover.status.attempts++;
+    rover.deadlineNs = steadyNowNs() + config_.ackTimeoutNs;
+
+    uint8_t buttons = rover.status.requested;
+    ssize_t sent = socket_ >= 0
+        ? sendto(socket_, &buttons, 1, 0, reinterpret_cast<const sockaddr*>(&rover.destination),
+                 sizeof(rover.destination))
+        : -1;
+    if (sent != 1) {
+        stats_.sendErrors++;
+        return false;
+    }
+    stats_.datagramsSent++;
+    return true;
+}
+
+void CommandChannel::settle(Rover& rover) {
+    rover.status.pending = false;
+    pendingCount_--;
+}
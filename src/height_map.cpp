@@ -0,0 +1,385 @@
+#include "height_map.h"
+#include "tile_store.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+const uint32_t HeightMap::NONE;
+
+// Lower bound on the resident budget, so a tile and the neighbours read
+// with it (mesher border snapshot) do not evict each other
+static const size_t MIN_RESIDENT_TILES = 4;
+
+HeightMap::HeightMap() : HeightMap(Config()) {
+}
+
+HeightMap::HeightMap(const Config& config)
+    : config_(config), budgetTiles_(0), lruHead_(NONE), lruTail_(NONE) {
+    if (config_.cellSize <= 0.0f) config_.cellSize = 0.5f;
+    if (config_.tileCells == 0) config_.tileCells = 64;
+    if (config_.maxFusedHits < 2) config_.maxFusedHits = 2;
+
+    // Round the area up to whole tiles, centred on the origin
+    uint32_t cells = static_cast<uint32_t>(std::ceil(config_.extent / config_.cellSize));
+    tilesPerSide_ = std::max<uint32_t>((cells + config_.tileCells - 1) / config_.tileCells, 1);
+    cellsPerSide_ = tilesPerSide_ * config_.tileCells;
+    invCellSize_ = 1.0f / config_.cellSize;
+    origin_ = -0.5f * static_cast<float>(cellsPerSide_) * config_.cellSize;
+
+    const size_t tileCount = static_cast<size_t>(tilesPerSide_) * tilesPerSide_;
+    tileBytes_ = sizeof(Tile) + static_cast<size_t>(config_.tileCells) * config_.tileCells * sizeof(Cell);
+    tiles_.resize(tileCount);
+    unsaved_.resize(tileCount, 0);
+    lruPrev_.resize(tileCount, NONE);
+    lruNext_.resize(tileCount, NONE);
+    dirtyTiles_.reserve(tileCount);
+    updateMemoryStats();
+}
+
+HeightMap::~HeightMap() {
+    if (store_) {
+        flush();
+    }
+}
+
+bool HeightMap::openStore(const std::string& path) {
+    // The fingerprint ties the file to this cell format and map geometry
+    uint64_t fingerprint = sizeof(Cell);
+    for (uint64_t value : {static_cast<uint64_t>(config_.tileCells), static_cast<uint64_t>(tilesPerSide_),
+                           static_cast<uint64_t>(config_.upAxis)}) {
+        fingerprint = fingerprint * 1000003u + value;
+    }
+    uint32_t cellBits;
+    memcpy(&cellBits, &config_.cellSize, sizeof(cellBits));
+    fingerprint = fingerprint * 1000003u + cellBits;
+
+    TileStore::Layout layout;
+    layout.tileCount = static_cast<uint32_t>(tiles_.size());
+    layout.tileBytes = static_cast<uint32_t>(static_cast<size_t>(config_.tileCells) * config_.tileCells * sizeof(Cell));
+    layout.fingerprint = fingerprint;
+
+    auto store = std::make_unique<TileStore>();
+    if (!store->open(path, layout)) {
+        return false;
+    }
+    store_ = std::move(store);
+
+    if (config_.residentBudgetMB > 0) {
+        budgetTiles_ = std::max(config_.residentBudgetMB * 1024 * 1024 / tileBytes_, MIN_RESIDENT_TILES);
+    }
+
+    // Resume: stored tiles exist without being resident, and all need meshing
+    if (store_->wasResumed()) {
+        for (uint32_t index = 0; index < tiles_.size(); ++index) {
+            TileStore::Entry& entry = store_->entry(index);
+            if (!entry.present || tiles_[index]) {
+                continue;
+            }
+            stats_.tilesAllocated++;
+            if (!entry.dirty) {
+                entry.dirty = 1;
+                entry.version++;
+            }
+            dirtyTiles_.push_back(index);
+        }
+    }
+    evictOverBudget(NONE);
+    return true;
+}
+
+bool HeightMap::flush() {
+    if (!store_) {
+        return false;
+    }
+    for (uint32_t index = lruHead_; index != NONE; index = lruNext_[index]) {
+        if (unsaved_[index]) {
+            storeTile(index, *tiles_[index]);
+        }
+    }
+    return store_->sync();
+}
+
+size_t HeightMap::insert(const glm::vec3* points, size_t count) {
+    const uint32_t tileCells = config_.tileCells;
+    const float limit = static_cast<float>(cellsPerSide_);
+
+    const uint32_t window = config_.maxFusedHits;
+    const float threshold2 = config_.changeThreshold * config_.changeThreshold;
+    const float sigmas2 = config_.changeSigmas * config_.changeSigmas;
+    const float prior2 = config_.measurementSigma * config_.measurementSigma;
+
+    // Consecutive points are usually in the same tile
+    uint32_t cachedIndex = UINT32_MAX;
+    Tile* tile = nullptr;
+    size_t inserted = 0;
+    size_t changes = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec2 ground = groundOf(points[i]);
+        float height = heightOf(points[i]);
+        float fx = (ground.x - origin_) * invCellSize_;
+        float fy = (ground.y - origin_) * invCellSize_;
+
+        // Written so NaN fails too
+        if (!(fx >= 0.0f && fy >= 0.0f && fx < limit && fy < limit) || !std::isfinite(height)) {
+            continue;
+        }
+
+        uint32_t cellX = static_cast<uint32_t>(fx);
+        uint32_t cellY = static_cast<uint32_t>(fy);
+        uint32_t index = (cellY / tileCells) * tilesPerSide_ + cellX / tileCells;
+        if (index != cachedIndex) {
+            tile = &tileFor(index);
+            cachedIndex = index;
+        }
+
+        Cell& cell = tile->cells[(cellY % tileCells) * tileCells + cellX % tileCells];
+        bool changed;
+        if (cell.hits == 0) {
+            cell.minHeight = height;
+            cell.maxHeight = height;
+            cell.meanHeight = height;
+            cell.m2 = 0.0f;
+            cell.hits = 1;
+            changed = true;
+        } else {
+            cell.minHeight = std::min(cell.minHeight, height);
+            cell.maxHeight = std::max(cell.maxHeight, height);
+            cell.hits++;
+
+            // Welford; once the window is full, fade the oldest weight out
+            uint32_t n = std::min(cell.hits, window);
+            if (cell.hits > window) {
+                cell.m2 *= static_cast<float>(n - 1) / static_cast<float>(n);
+            }
+            float delta = height - cell.meanHeight;
+            cell.meanHeight += delta / static_cast<float>(n);
+            cell.m2 += delta * (height - cell.meanHeight);
+
+            // Squared, to avoid a sqrt per point: standard error^2 = (m2 + sigma^2) / n^2
+            float moved = cell.meanHeight - cell.reportedHeight;
+            float n2 = static_cast<float>(n) * static_cast<float>(n);
+            changed = moved * moved > std::max(threshold2, sigmas2 * (cell.m2 + prior2) / n2);
+        }
+
+        if (changed) {
+            cell.reportedHeight = cell.meanHeight;
+            changes++;
+            if (!tile->dirty) {
+                tile->dirty = true;
+                tile->version++;
+                dirtyTiles_.push_back(index);
+            }
+        }
+        inserted++;
+    }
+
+    stats_.pointsInserted += inserted;
+    stats_.pointsOutOfBounds += count - inserted;
+    stats_.cellChanges += changes;
+    return inserted;
+}
+
+HeightMap::Tile& HeightMap::tileFor(uint32_t index) {
+    Tile* tile = residentTile(index);
+    if (tile == nullptr) {
+        std::unique_ptr<Tile> fresh = makeTile(index);
+        const size_t cellCount = static_cast<size_t>(config_.tileCells) * config_.tileCells;
+        std::fill(fresh->cells.get(), fresh->cells.get() + cellCount, Cell());   // hits == 0
+        tile = fresh.get();
+        stats_.tilesAllocated++;
+        makeResident(index, std::move(fresh));
+    }
+    unsaved_[index] = 1;
+    return *tile;
+}
+
+HeightMap::Tile* HeightMap::residentTile(uint32_t index) const {
+    Tile* tile = tiles_[index].get();
+    if (tile != nullptr) {
+        touch(index);
+        return tile;
+    }
+    if (!store_ || !store_->entry(index).present) {
+        return nullptr;
+    }
+
+    // Page in: copy out of the mapping, then let the kernel drop those pages
+    const TileStore::Entry& entry = store_->entry(index);
+    std::unique_ptr<Tile> loaded = makeTile(index);
+    memcpy(loaded->cells.get(), store_->slot(index), store_->getLayout().tileBytes);
+    loaded->version = entry.version;
+    loaded->dirty = entry.dirty != 0;
+    store_->release(index);
+
+    tile = loaded.get();
+    unsaved_[index] = 0;
+    stats_.tilesPagedIn++;
+    makeResident(index, std::move(loaded));
+    return tile;
+}
+
+std::unique_ptr<HeightMap::Tile> HeightMap::makeTile(uint32_t index) const {
+    std::unique_ptr<Tile> tile = std::move(spare_);
+    if (!tile) {
+        tile = std::make_unique<Tile>();
+        tile->cells = std::make_unique<Cell[]>(static_cast<size_t>(config_.tileCells) * config_.tileCells);
+    }
+    tile->tileX = static_cast<int32_t>(index % tilesPerSide_);
+    tile->tileY = static_cast<int32_t>(index / tilesPerSide_);
+    tile->version = 0;
+    tile->dirty = false;
+    return tile;
+}
+
+void HeightMap::makeResident(uint32_t index, std::unique_ptr<Tile> tile) const {
+    tiles_[index] = std::move(tile);
+    lruPushFront(index);
+    stats_.tilesResident++;
+    evictOverBudget(index);
+    updateMemoryStats();
+}
+
+void HeightMap::storeTile(uint32_t index, const Tile& tile) const {
+    memcpy(store_->slot(index), tile.cells.get(), store_->getLayout().tileBytes);
+    TileStore::Entry& entry = store_->entry(index);
+    entry.version = tile.version;
+    entry.dirty = tile.dirty ? 1 : 0;
+    entry.present = 1;
+    unsaved_[index] = 0;
+}
+
+void HeightMap::evictOverBudget(uint32_t keep) const {
+    if (!store_ || budgetTiles_ == 0) {
+        return;
+    }
+    while (stats_.tilesResident > budgetTiles_ && lruTail_ != NONE && lruTail_ != keep) {
+        evict(lruTail_);
+    }
+}
+
+void HeightMap::evict(uint32_t index) const {
+    if (unsaved_[index]) {
+        storeTile(index, *tiles_[index]);
+    }
+    store_->release(index);
+    lruUnlink(index);
+    spare_ = std::move(tiles_[index]);
+    stats_.tilesResident--;
+    stats_.tilesEvicted++;
+    updateMemoryStats();
+}
+
+void HeightMap::lruUnlink(uint32_t index) const {
+    uint32_t prev = lruPrev_[index], next = lruNext_[index];
+    if (prev != NONE) lruNext_[prev] = next; else lruHead_ = next;
+    if (next != NONE) lruPrev_[next] = prev; else lruTail_ = prev;
+    lruPrev_[index] = lruNext_[index] = NONE;
+}
+
+void HeightMap::lruPushFront(uint32_t index) const {
+    lruPrev_[index] = NONE;
+    lruNext_[index] = lruHead_;
+    if (lruHead_ != NONE) lruPrev_[lruHead_] = index; else lruTail_ = index;
+    lruHead_ = index;
+}
+
+void HeightMap::touch(uint32_t index) const {
+    if (lruHead_ != index) {
+        lruUnlink(index);
+        lruPushFront(index);
+    }
+}
+
+void HeightMap::updateMemoryStats() const {
+    const size_t perIndex = sizeof(tiles_[0]) + sizeof(unsaved_[0]) + sizeof(lruPrev_[0]) + sizeof(lruNext_[0]);
+    stats_.memoryBytes = tiles_.size() * perIndex + stats_.tilesResident * tileBytes_;
+}
+
+void HeightMap::takeDirtyTiles(std::vector<uint32_t>& out) {
+    out.clear();
+    out.swap(dirtyTiles_);
+    for (uint32_t index : out) {
+        if (tiles_[index]) {
+            tiles_[index]->dirty = false;
+        } else {
+            store_->entry(index).dirty = 0;   // Evicted since it became dirty
+        }
+    }
+
+    // Keep the next list preallocated (out may have come in without capacity)
+    dirtyTiles_.reserve(tiles_.size());
+}
+
+const HeightMap::Tile* HeightMap::getTile(int32_t tileX, int32_t tileY) const {
+    if (tileX < 0 || tileY < 0 || tileX >= static_cast<int32_t>(tilesPerSide_) ||
+        tileY >= static_cast<int32_t>(tilesPerSide_)) {
+        return nullptr;
+    }
+    return residentTile(static_cast<uint32_t>(tileY) * tilesPerSide_ + static_cast<uint32_t>(tileX));
+}
+
+const HeightMap::Cell* HeightMap::cellAt(float groundX, float groundY) const {
+    float fx = (groundX - origin_) * invCellSize_;
+    float fy = (groundY - origin_) * invCellSize_;
+    const float limit = static_cast<float>(cellsPerSide_);
+    if (!(fx >= 0.0f && fy >= 0.0f && fx < limit && fy < limit)) {
+        return nullptr;
+    }
+
+    uint32_t cellX = static_cast<uint32_t>(fx);
+    uint32_t cellY = static_cast<uint32_t>(fy);
+    const uint32_t tileCells = config_.tileCells;
+    const Tile* tile = residentTile((cellY / tileCells) * tilesPerSide_ + cellX / tileCells);
+    if (tile == nullptr) {
+        return nullptr;
+    }
+
+    const Cell& cell = tile->cells[(cellY % tileCells) * tileCells + cellX % tileCells];
+    return cell.hits > 0 ? &cell : nullptr;
+}
+
+float HeightMap::cellVariance(const Cell& cell) const {
+    uint32_t n = std::min(cell.hits, config_.maxFusedHits);
+    return n > 1 ? cell.m2 / static_cast<float>(n - 1) : 0.0f;
+}
+
+float HeightMap::cellStdError(const Cell& cell) const {
+    if (cell.hits == 0) {
+        return config_.measurementSigma;
+    }
+    float n = static_cast<float>(std::min(cell.hits, config_.maxFusedHits));
+    float sigma2 = config_.measurementSigma * config_.measurementSigma;
+    float variance = (cell.m2 + sigma2) / n;
+    return std::sqrt(variance / n);
+}
+
+float HeightMap::cellConfidence(const Cell& cell) const {
+    if (config_.measurementSigma <= 0.0f) {
+        return cell.hits > 0 ? 1.0f : 0.0f;
+    }
+    return std::max(0.0f, 1.0f - cellStdError(cell) / config_.measurementSigma);
+}
+
+glm::vec2 HeightMap::tileOrigin(const Tile& tile) const {
+    float tileSize = static_cast<float>(config_.tileCells) * config_.cellSize;
+    return glm::vec2(origin_ + static_cast<float>(tile.tileX) * tileSize,
+                     origin_ + static_cast<float>(tile.tileY) * tileSize);
+}
+
+void HeightMap::clear() {
+    for (auto& tile : tiles_) {
+        tile.reset();
+    }
+    std::fill(unsaved_.begin(), unsaved_.end(), 0);
+    std::fill(lruPrev_.begin(), lruPrev_.end(), NONE);
+    std::fill(lruNext_.begin(), lruNext_.end(), NONE);
+    lruHead_ = lruTail_ = NONE;
+    if (store_) {
+        store_->clear();
+    }
+    dirtyTiles_.clear();
+    stats_.tilesAllocated = 0;
+    stats_.tilesResident = 0;
+    updateMemoryStats();
+}
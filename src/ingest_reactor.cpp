@@ -0,0 +1,289 @@
+#include "ingest_reactor.h"
+#include "packet_log.h"
+#include "../emulator/rover_profiles.h"
+#include <iostream>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+// epoll user data marking the stop() eventfd instead of a source index
+static const uint64_t WAKE_TOKEN = UINT64_MAX;
+
+// Events returned per epoll_wait call
+static const int MAX_EVENTS = 64;
+
+// Kernel buffer per socket, enough for several scans of LiDAR chunks
+static const int SOCKET_RCVBUF_BYTES = 4 * 1024 * 1024;
+
+IngestReactor::IngestReactor(size_t batchSize, size_t maxBatchesPerWake)
+    : epollFd_(-1), wakeFd_(-1), batch_(batchSize),
+      maxBatchesPerWake_(maxBatchesPerWake > 0 ? maxBatchesPerWake : 1),
+      roverCount_(0), stopRequested_(false), latency_(nullptr), recorder_(nullptr) {
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0) {
+        std::cerr << "Error creating epoll instance: " << strerror(errno) << std::endl;
+        return;
+    }
+    
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ < 0) {
+        std::cerr << "Error creating eventfd: " << strerror(errno) << std::endl;
+        return;
+    }
+    
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u64 = WAKE_TOKEN;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev) < 0) {
+        std::cerr << "Error registering eventfd: " << strerror(errno) << std::endl;
+    }
+}
+
+IngestReactor::~IngestReactor() {
+    // Receivers close their own sockets; epoll drops them automatically
+    if (wakeFd_ >= 0) close(wakeFd_);
+    if (epollFd_ >= 0) close(epollFd_);
+}
+
+bool IngestReactor::addRover(const RoverPorts& ports, IngestHandler& handler) {
+    if (!isValid()) return false;
+    
+    size_t firstSource = sources_.size();
+    bool ok = addSource(ports.posePort, ports.roverId, StreamKind::Pose, handler) &&
+              addSource(ports.lidarPort, ports.roverId, StreamKind::Lidar, handler) &&
+              addSource(ports.telemPort, ports.roverId, StreamKind::Telemetry, handler);
+    
+    // All or nothing: a half-registered rover would still deliver packets
+    if (!ok) {
+        while (sources_.size() > firstSource) {
+            epoll_ctl(epollFd_, EPOLL_CTL_DEL, sources_.back().receiver->getFd(), nullptr);
+            sources_.pop_back();   // Closes the socket
+        }
+        return false;
+    }
+    
+    roverCount_++;
+    return true;
+}
+
+std::vector<RoverPorts> IngestReactor::portsFromProfiles() {
+    std::vector<RoverPorts> result;
+    result.reserve(g_roverProfiles.size());
+    
+    for (const auto& [id, profile] : g_roverProfiles) {
+        RoverPorts ports;
+        ports.roverId = static_cast<uint32_t>(std::stoul(id));
+        ports.posePort = static_cast<uint16_t>(profile.posePort);
+        ports.lidarPort = static_cast<uint16_t>(profile.lidarPort);
+        ports.telemPort = static_cast<uint16_t>(profile.telemPort);
+        ports.cmdPort = static_cast<uint16_t>(profile.cmdPort);
+        result.push_back(ports);
+    }
+    
+    return result;
+}
+
+std::vector<RoverPorts> IngestReactor::portsForRovers(uint32_t count) {
+    std::vector<RoverPorts> result;
+    result.reserve(count);
+    
+    for (uint32_t id = 1; id <= count; ++id) {
+        RoverProfile profile;
+        if (!findRoverProfile(std::to_string(id), profile)) {
+            break;
+        }
+        RoverPorts ports;
+        ports.roverId = id;
+        ports.posePort = static_cast<uint16_t>(profile.posePort);
+        ports.lidarPort = static_cast<uint16_t>(profile.lidarPort);
+        ports.telemPort = static_cast<uint16_t>(profile.telemPort);
+        ports.cmdPort = static_cast<uint16_t>(profile.cmdPort);
+        result.push_back(ports);
+    }
+    
+    return result;
+}
+
+bool IngestReactor::addSource(uint16_t port, uint32_t roverId, StreamKind kind,
+                              IngestHandler& handler) {
+    auto receiver = std::make_unique<UDPReceiver>(port);
+    if (!receiver->isValid()) {
+        return false;
+    }
+    
+    // Edge-triggered epoll requires non-blocking reads until EAGAIN
+    receiver->setNonBlocking(true);
+    receiver->setReceiveBufferSize(SOCKET_RCVBUF_BYTES);
+    receiver->enableTimestamps(true);
+    
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.u64 = sources_.size();
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, receiver->getFd(), &ev) < 0) {
+        std::cerr << "Error registering port " << port << " with epoll: " 
+                  << strerror(errno) << std::endl;
+        return false;
+    }
+    
+    Source source;
+    source.receiver = std::move(receiver);
+    source.roverId = roverId;
+    source.kind = kind;
+    source.handler = &handler;
+    source.pending = false;
+    sources_.push_back(std::move(source));
+    
+    // Reserve up front so the poll loop never allocates
+    pendingSources_.reserve(sources_.size());
+    return true;
+}
+
+size_t IngestReactor::pollOnce(int timeoutMs) {
+    if (!isValid()) return 0;
+    
+    // Leftover work from the previous pass: just collect new readiness
+    int waitMs = pendingSources_.empty() ? timeoutMs : 0;
+    
+    struct epoll_event events[MAX_EVENTS];
+    int count = epoll_wait(epollFd_, events, MAX_EVENTS, waitMs);
+    if (count < 0) {
+        if (errno != EINTR) {
+            std::cerr << "Error in epoll_wait: " << strerror(errno) << std::endl;
+        }
+        return 0;
+    }
+    
+    if (count > 0) {
+        stats_.wakeups++;
+    }
+    
+    for (int i = 0; i < count; ++i) {
+        uint64_t token = events[i].data.u64;
+        if (token == WAKE_TOKEN) {
+            uint64_t value;
+            while (read(wakeFd_, &value, sizeof(value)) > 0) {}
+            continue;
+        }
+        
+        Source& source = sources_[token];
+        if (!source.pending) {
+            source.pending = true;
+            pendingSources_.push_back(token);
+        }
+    }
+    
+    // Service every ready socket once, round-robin; keep the ones that
+    // hit the per-wake cap for the next pass
+    size_t dispatched = 0;
+    size_t keep = 0;
+    for (size_t i = 0; i < pendingSources_.size(); ++i) {
+        Source& source = sources_[pendingSources_[i]];
+        if (drainSource(source, dispatched)) {
+            source.pending = false;
+        } else {
+            pendingSources_[keep++] = pendingSources_[i];
+        }
+    }
+    pendingSources_.resize(keep);
+    
+    return dispatched;
+}
+
+void IngestReactor::run() {
+    while (!stopRequested_.load(std::memory_order_acquire)) {
+        pollOnce(-1);
+    }
+}
+
+void IngestReactor::stop() {
+    stopRequested_.store(true, std::memory_order_release);
+    
+    uint64_t one = 1;
+    if (wakeFd_ >= 0 && write(wakeFd_, &one, sizeof(one)) < 0) {
+        std::cerr << "Error waking reactor: " << strerror(errno) << std::endl;
+    }
+}
+
+bool IngestReactor::drainSource(Source& source, size_t& dispatched) {
+    for (size_t b = 0; b < maxBatchesPerWake_; ++b) {
+        int received = source.receiver->receiveBatch(batch_);
+        if (received <= 0) {
+            // EAGAIN (-1) means drained; on error (0) stop retrying this wake
+            return true;
+        }
+        
+        stats_.datagrams += static_cast<size_t>(received);
+        for (size_t i = 0; i < batch_.size(); ++i) {
+            dispatch(source, batch_.data(i), batch_.length(i), batch_.arrivalNs(i));
+        }
+        dispatched += static_cast<size_t>(received);
+        
+        // A short batch means the queue was empty; edge-triggered epoll
+        // reports any datagram that arrives after this read
+        if (batch_.size() < batch_.capacity()) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+void IngestReactor::dispatch(Source& source, const uint8_t* data, size_t length,
+                             uint64_t arrivalNs) {
+    if (latency_ != nullptr) {
+        latency_->recordSince(source.roverId, LatencyStage::Receive, arrivalNs);
+    }
+    if (recorder_ != nullptr) {
+        recorder_->record(source.roverId, source.kind, data, length, arrivalNs);
+    }
+    
+    if (!decoder_.dispatch(source.kind, source.roverId, data, length, arrivalNs, *source.handler)) {
+        stats_.malformedPackets++;
+        return;
+    }
+    
+    switch (source.kind) {
+        case StreamKind::Pose:      stats_.posePackets++; break;
+        case StreamKind::Lidar:     stats_.lidarPackets++; break;
+        case StreamKind::Telemetry: stats_.telemPackets++; break;
+    }
+}
+
+bool PacketDecoder::dispatch(StreamKind kind, uint32_t roverId, const uint8_t* data, size_t length,
+                             uint64_t arrivalNs, IngestHandler& handler) {
+    switch (kind) {
+        case StreamKind::Pose:
+            if (length != sizeof(PosePacket)) return false;
+            memcpy(&pose_, data, sizeof(PosePacket));
+            handler.onPose(roverId, pose_, arrivalNs);
+            return true;
+            
+        case StreamKind::Lidar: {
+            if (length < sizeof(LidarPacketHeader)) return false;
+            memcpy(&lidar_.header, data, sizeof(LidarPacketHeader));
+            
+            // Last chunk of a scan is shorter than a full LidarPacket
+            uint32_t points = lidar_.header.pointsInThisChunk;
+            if (points > MAX_LIDAR_POINTS_PER_PACKET ||
+                length != sizeof(LidarPacketHeader) + points * sizeof(LidarPoint)) {
+                return false;
+            }
+            memcpy(lidar_.points, data + sizeof(LidarPacketHeader), points * sizeof(LidarPoint));
+            handler.onLidar(roverId, lidar_, arrivalNs);
+            return true;
+        }
+            
+        case StreamKind::Telemetry:
+            if (length != sizeof(VehicleTelem)) return false;
+            memcpy(&telem_, data, sizeof(VehicleTelem));
+            handler.onTelemetry(roverId, telem_, arrivalNs);
+            return true;
+    }
+    
+    return false;
+}
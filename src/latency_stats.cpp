@@ -0,0 +1,132 @@
+#include "latency_stats.h"
+#include <iomanip>
+#include <algorithm>
+
+const char* latencyStageName(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::Receive:   return "receive";
+        case LatencyStage::Assembly:  return "assembly";
+        case LatencyStage::Transform: return "transform";
+        case LatencyStage::Render:    return "render";
+        case LatencyStage::EndToEnd:  return "end-to-end";
+        case LatencyStage::ChunkToWorld: return "chunk-to-world";
+        case LatencyStage::CommandRoundTrip: return "command-rtt";
+        case LatencyStage::Count:     break;
+    }
+    return "unknown";
+}
+
+LatencyHistogram::LatencyHistogram() : count_(0), max_(0) {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t value) noexcept {
+    if (value < SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+
+    // Top SUB_BUCKET_BITS bits below the leading one pick the linear bucket
+    size_t msb = 63 - static_cast<size_t>(__builtin_clzll(value));
+    size_t shift = msb - SUB_BUCKET_BITS;
+    size_t sub = static_cast<size_t>(value >> shift) & (SUB_BUCKETS - 1);
+    return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+
+    size_t shift = index / SUB_BUCKETS - 1;
+    uint64_t sub = index % SUB_BUCKETS;
+    uint64_t lower = (SUB_BUCKETS + sub) << shift;
+    return lower + ((1ULL << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) noexcept {
+    buckets_[bucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t previous = max_.load(std::memory_order_relaxed);
+    while (nanoseconds > previous &&
+           !max_.compare_exchange_weak(previous, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::percentile(double pct) const {
+    uint64_t total = count();
+    if (total == 0) {
+        return 0;
+    }
+
+    // Rank of the requested sample (1-based)
+    uint64_t rank = static_cast<uint64_t>(pct / 100.0 * static_cast<double>(total) + 0.5);
+    rank = std::max<uint64_t>(1, std::min(rank, total));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(i), max());
+        }
+    }
+    return max();
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+LatencyRecorder::LatencyRecorder(uint32_t maxRoverId)
+    : maxRoverId_(maxRoverId),
+      histograms_(std::make_unique<LatencyHistogram[]>((maxRoverId + 1) * STAGE_COUNT)) {
+}
+
+void LatencyRecorder::record(uint32_t roverId, LatencyStage stage, uint64_t nanoseconds) noexcept {
+    if (roverId > maxRoverId_ || stage == LatencyStage::Count) return;
+    histograms_[roverId * STAGE_COUNT + static_cast<size_t>(stage)].record(nanoseconds);
+}
+
+void LatencyRecorder::recordSince(uint32_t roverId, LatencyStage stage, uint64_t startNs) noexcept {
+    uint64_t now = realtimeNowNs();
+    if (startNs == 0 || now < startNs) return;
+    record(roverId, stage, now - startNs);
+}
+
+const LatencyHistogram* LatencyRecorder::histogram(uint32_t roverId, LatencyStage stage) const {
+    if (roverId > maxRoverId_ || stage == LatencyStage::Count) return nullptr;
+    return &histograms_[roverId * STAGE_COUNT + static_cast<size_t>(stage)];
+}
+
+void LatencyRecorder::dump(std::ostream& out) const {
+    out << std::fixed << std::setprecision(3);
+    out << "Latency (ms)    " << std::left << std::setw(15) << "stage" << std::right
+        << std::setw(8) << "count" << std::setw(10) << "p50" << std::setw(10) << "p99"
+        << std::setw(10) << "max" << '\n';
+
+    for (uint32_t roverId = 0; roverId <= maxRoverId_; ++roverId) {
+        for (size_t s = 0; s < STAGE_COUNT; ++s) {
+            const LatencyHistogram& hist = histograms_[roverId * STAGE_COUNT + s];
+            if (hist.count() == 0) continue;
+
+            out << "  rover " << std::setw(3) << roverId << "     "
+                << std::left << std::setw(15) << latencyStageName(static_cast<LatencyStage>(s))
+                << std::right << std::setw(8) << hist.count()
+                << std::setw(10) << hist.percentile(50.0) / 1e6
+                << std::setw(10) << hist.percentile(99.0) / 1e6
+                << std::setw(10) << hist.max() / 1e6 << '\n';
+        }
+    }
+}
+
+void LatencyRecorder::reset() {
+    for (size_t i = 0; i < (maxRoverId_ + 1) * STAGE_COUNT; ++i) {
+        histograms_[i].reset();
+    }
+}
@@ -1,113 +1,301 @@
 #include "lidar_assembler.h"
-#include <iostream>
+#include "latency_stats.h"
 #include <algorithm>
+#include <cstring>
 
-LidarAssembler::LidarAssembler() 
-    : totalChunksReceived_(0), totalScansCompleted_(0) {
+// Expiry wheel: 1 ms buckets, 256 ms per revolution
+static const size_t EXPIRY_WHEEL_SLOTS = 256;
+static const uint64_t EXPIRY_TICK_NS = 1000000;
+
+LidarAssembler::LidarAssembler() : LidarAssembler(Config()) {
+}
+
+LidarAssembler::LidarAssembler(const Config& config)
+    : config_(config),
+      arena_(std::make_shared<ScanArena>(config.arenaSlots, config.maxChunksPerScan,
+                                         config.retainPoints)),
+      partialScans_(std::max<size_t>(config.maxPartialScans, 1)),
+      expiry_(partialScans_.size(), EXPIRY_WHEEL_SLOTS, EXPIRY_TICK_NS),
+      timeoutNs_(static_cast<uint64_t>((config.emitPartialScans ? config.partialDeadlineMs
+                                                                : config.staleScanTimeoutMs) * 1e6)),
+      completeScans_(config.queueDepth),
+      activePartials_(0), totalChunksReceived_(0), totalScansCompleted_(0),
+      droppedChunks_(0), droppedScans_(0), partialScansEmitted_(0), staleScans_(0),
+      queueHighWater_(0) {
 }
 
-bool LidarAssembler::addPacket(const LidarPacket& packet) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    totalChunksReceived_++;
-    
+LidarAssembler::~LidarAssembler() {
+    // Return our references; handles still held by consumers keep the arena alive
+    for (auto& partial : partialScans_) {
+        abandonScan(partial);
+    }
+    uint32_t slot;
+    while (completeScans_.pop(slot)) {
+        arena_->release(slot);
+    }
+}
+
+bool LidarAssembler::addPacket(const LidarPacket& packet, uint64_t arrivalNs) {
+    if (arrivalNs == 0) {
+        arrivalNs = realtimeNowNs();
+    }
+
+    totalChunksReceived_.fetch_add(1, std::memory_order_relaxed);
+
     double timestamp = packet.header.timestamp;
     uint32_t chunkIndex = packet.header.chunkIndex;
     uint32_t totalChunks = packet.header.totalChunks;
-    uint32_t pointsInChunk = packet.header.pointsInThisChunk;
-    
+    uint32_t pointsInChunk = std::min<uint32_t>(packet.header.pointsInThisChunk,
+                                                MAX_LIDAR_POINTS_PER_PACKET);
+
+    if (totalChunks == 0 || totalChunks > arena_->getMaxChunksPerScan() ||
+        chunkIndex >= totalChunks) {
+        droppedChunks_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
     // Find or create partial scan for this timestamp
-    auto& partial = partialScans_[timestamp];
-    partial.timestamp = timestamp;
-    partial.totalChunks = totalChunks;
-    partial.lastUpdateTime = std::chrono::steady_clock::now();
-    
-    // Add points from this chunk
-    std::vector<LidarPoint> points;
-    points.reserve(pointsInChunk);
-    for (uint32_t i = 0; i < pointsInChunk && i < MAX_LIDAR_POINTS_PER_PACKET; ++i) {
-        points.push_back(packet.points[i]);
-    }
-    
-    // Store chunk (will overwrite if duplicate received)
-    partial.chunks[chunkIndex] = std::move(points);
-    
+    uint64_t now = steadyNowNs();
+    bool started = false;
+    PartialScan* partial = findOrStartScan(timestamp, totalChunks, started);
+    if (partial == nullptr) {
+        droppedChunks_.fetch_add(1, std::memory_order_relaxed);
+        return expireScans(now);
+    }
+    partial->lastUpdateNs = now;
+    expiry_.schedule(timerId(*partial), now + timeoutNs_);
+
+    // Other scans past their deadline, or older than a newly started scan,
+    // will not get more chunks
+    bool queued = expireScans(now);
+    if (config_.emitPartialScans && started) {
+        queued = emitOlderScans(timestamp) || queued;
+    }
+
+    uint32_t slot = partial->slot;
+    ScanInfo& info = arena_->info(slot);
+    if (info.firstChunkArrivalNs == 0) {
+        info.firstChunkArrivalNs = arrivalNs;
+    }
+    info.lastChunkArrivalNs = arrivalNs;
+
+    // Write points straight to this chunk's offset in the slot
+    // (a duplicate chunk simply overwrites the same region)
+    if (config_.retainPoints) {
+        memcpy(arena_->points(slot) + static_cast<size_t>(chunkIndex) * MAX_LIDAR_POINTS_PER_PACKET,
+               packet.points, pointsInChunk * sizeof(LidarPoint));
+    }
+    arena_->chunkPointCounts(slot)[chunkIndex] = static_cast<uint16_t>(pointsInChunk);
+
+    uint64_t& word = arena_->chunkBitmap(slot)[chunkIndex / 64];
+    uint64_t bit = 1ULL << (chunkIndex % 64);
+    if ((word & bit) == 0) {
+        word |= bit;
+        info.chunksReceived++;
+    }
+
     // Check if scan is complete
-    if (partial.chunks.size() == totalChunks) {
-        // Assemble complete scan
-        CompleteScan complete;
-        complete.timestamp = timestamp;
-        complete.totalChunks = totalChunks;
-        
-        // Combine all chunks in order
-        for (const auto& [idx, chunkPoints] : partial.chunks) {
-            complete.points.insert(complete.points.end(), 
-                                 chunkPoints.begin(), 
-                                 chunkPoints.end());
-        }
-        
-        // Move to complete scans
-        completeScans_.push_back(std::move(complete));
-        
-        // Remove from partial scans
-        partialScans_.erase(timestamp);
-        
-        totalScansCompleted_++;
-        
+    if (info.chunksReceived == info.totalChunks) {
+        compactScan(slot);
+
+        // Hand the slot (and our reference) to the consumer
+        expiry_.cancel(timerId(*partial));
+        partial->slot = ScanArena::INVALID_SLOT;
+        activePartials_.fetch_sub(1, std::memory_order_relaxed);
+        publishScan(slot);
+
+        totalScansCompleted_.fetch_add(1, std::memory_order_relaxed);
+
         return true;  // Scan completed
     }
-    
-    return false;  // Scan not yet complete
+
+    return queued;  // Scan not yet complete
 }
 
-bool LidarAssembler::hasCompleteScan() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return !completeScans_.empty();
+bool LidarAssembler::poll() {
+    return expireScans(steadyNowNs());
 }
 
-bool LidarAssembler::getCompleteScan(CompleteScan& scan) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (completeScans_.empty()) {
+bool LidarAssembler::expireScans(uint64_t nowNs) {
+    bool queued = false;
+
+    // Only buckets elapsed since the last call are visited
+    expiry_.advance(nowNs, [this, &queued](uint32_t id) {
+        PartialScan& partial = partialScans_[id];
+        if (config_.emitPartialScans) {
+            queued = emitPartialScan(partial) || queued;
+        } else {
+            staleScans_.fetch_add(1, std::memory_order_relaxed);
+            abandonScan(partial);
+        }
+    });
+    return queued;
+}
+
+bool LidarAssembler::emitOlderScans(double timestamp) {
+    bool queued = false;
+
+    for (auto& partial : partialScans_) {
+        if (partial.slot != ScanArena::INVALID_SLOT && partial.timestamp < timestamp) {
+            queued = emitPartialScan(partial) || queued;
+        }
+    }
+    return queued;
+}
+
+bool LidarAssembler::emitPartialScan(PartialScan& partial) {
+    uint32_t slot = partial.slot;
+    const ScanInfo& info = arena_->info(slot);
+    float completeness = static_cast<float>(info.chunksReceived) / info.totalChunks;
+
+    if (completeness < config_.minCompleteness) {
+        staleScans_.fetch_add(1, std::memory_order_relaxed);
+        abandonScan(partial);
         return false;
     }
-    
-    // Get oldest scan (front of vector)
-    scan = std::move(completeScans_.front());
-    completeScans_.erase(completeScans_.begin());
-    
+
+    compactScan(slot);
+    expiry_.cancel(timerId(partial));
+    partial.slot = ScanArena::INVALID_SLOT;
+    activePartials_.fetch_sub(1, std::memory_order_relaxed);
+    publishScan(slot);
+
+    partialScansEmitted_.fetch_add(1, std::memory_order_relaxed);
     return true;
 }
 
-void LidarAssembler::cleanupStaleScans(double maxAgeSeconds) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto now = std::chrono::steady_clock::now();
-    auto maxAge = std::chrono::duration<double>(maxAgeSeconds);
-    
-    // Find and remove stale partial scans
-    auto it = partialScans_.begin();
-    while (it != partialScans_.end()) {
-        auto age = now - it->second.lastUpdateTime;
-        if (age > maxAge) {
-            std::cout << "Cleaning up stale partial scan at timestamp " 
-                      << it->first 
-                      << " (had " << it->second.chunks.size() 
-                      << "/" << it->second.totalChunks << " chunks)" 
-                      << std::endl;
-            it = partialScans_.erase(it);
-        } else {
-            ++it;
+LidarAssembler::PartialScan* LidarAssembler::findOrStartScan(double timestamp,
+                                                             uint32_t totalChunks,
+                                                             bool& started) {
+    PartialScan* unused = nullptr;
+    PartialScan* oldest = nullptr;
+
+    for (auto& partial : partialScans_) {
+        if (partial.slot == ScanArena::INVALID_SLOT) {
+            if (unused == nullptr) unused = &partial;
+            continue;
+        }
+        if (partial.timestamp == timestamp) {
+            // Chunks disagreeing on the scan size cannot be placed
+            return arena_->info(partial.slot).totalChunks == totalChunks ? &partial : nullptr;
+        }
+        if (oldest == nullptr || partial.lastUpdateNs < oldest->lastUpdateNs) {
+            oldest = &partial;
+        }
+    }
+
+    // All partial entries busy: the least recently updated scan gives way
+    if (unused == nullptr) {
+        staleScans_.fetch_add(1, std::memory_order_relaxed);
+        abandonScan(*oldest);
+        unused = oldest;
+    }
+
+    uint32_t slot = arena_->acquire();
+    if (slot == ScanArena::INVALID_SLOT) {
+        return nullptr;  // Consumers are holding every slot
+    }
+
+    ScanInfo& info = arena_->info(slot);
+    info.roverId = config_.roverId;
+    info.timestamp = timestamp;
+    info.totalChunks = totalChunks;
+
+    unused->timestamp = timestamp;
+    unused->slot = slot;
+    activePartials_.fetch_add(1, std::memory_order_relaxed);
+    started = true;
+    return unused;
+}
+
+void LidarAssembler::abandonScan(PartialScan& partial) {
+    if (partial.slot == ScanArena::INVALID_SLOT) return;
+
+    expiry_.cancel(timerId(partial));
+    arena_->release(partial.slot);
+    partial.slot = ScanArena::INVALID_SLOT;
+    activePartials_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void LidarAssembler::publishScan(uint32_t slot) {
+    // Drop-oldest: a stale scan is worth less than the one just completed
+    uint32_t dropped;
+    if (completeScans_.pushOverwrite(slot, dropped)) {
+        arena_->release(dropped);
+        droppedScans_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t depth = completeScans_.size();
+    if (depth > queueHighWater_.load(std::memory_order_relaxed)) {
+        queueHighWater_.store(depth, std::memory_order_relaxed);
+    }
+}
+
+void LidarAssembler::compactScan(uint32_t slot) {
+    ScanInfo& info = arena_->info(slot);
+    LidarPoint* points = arena_->points(slot);
+    const uint16_t* counts = arena_->chunkPointCounts(slot);
+    const uint64_t* bitmap = arena_->chunkBitmap(slot);
+
+    // Usually only the last chunk is short and nothing moves; missing chunks
+    // (partial scans) are skipped, their counts are left over from reuse
+    size_t writeOffset = 0;
+    for (uint32_t chunk = 0; chunk < info.totalChunks; ++chunk) {
+        if (((bitmap[chunk / 64] >> (chunk % 64)) & 1) == 0) continue;
+
+        size_t chunkOffset = static_cast<size_t>(chunk) * MAX_LIDAR_POINTS_PER_PACKET;
+        if (points != nullptr && writeOffset != chunkOffset) {
+            memmove(points + writeOffset, points + chunkOffset, counts[chunk] * sizeof(LidarPoint));
         }
+        writeOffset += counts[chunk];
     }
+    info.pointCount = writeOffset;
+}
+
+bool LidarAssembler::hasChunk(double timestamp, uint32_t chunkIndex) const {
+    for (const auto& partial : partialScans_) {
+        if (partial.slot != ScanArena::INVALID_SLOT && partial.timestamp == timestamp) {
+            if (chunkIndex >= arena_->info(partial.slot).totalChunks) {
+                return false;
+            }
+            uint64_t word = arena_->chunkBitmap(partial.slot)[chunkIndex / 64];
+            return (word & (1ULL << (chunkIndex % 64))) != 0;
+        }
+    }
+    return false;
+}
+
+bool LidarAssembler::hasCompleteScan() const {
+    return !completeScans_.empty();
 }
 
-size_t LidarAssembler::getPartialScanCount() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return partialScans_.size();
+bool LidarAssembler::getCompleteScan(ScanHandle& scan) {
+    uint32_t slot;
+    if (!completeScans_.pop(slot)) {
+        return false;
+    }
+
+    // Oldest queued scan; the handle adopts the queue's reference
+    scan = ScanHandle(arena_, slot);
+    return true;
 }
 
-size_t LidarAssembler::getCompleteScanCount() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return completeScans_.size();
+bool LidarAssembler::getCompleteScan(CompleteScan& scan) {
+    ScanHandle handle;
+    if (!getCompleteScan(handle)) {
+        return false;
+    }
+
+    scan.roverId = handle.roverId();
+    scan.timestamp = handle.timestamp();
+    scan.totalChunks = handle.totalChunks();
+    scan.firstChunkArrivalNs = handle.firstChunkArrivalNs();
+    scan.lastChunkArrivalNs = handle.lastChunkArrivalNs();
+    if (handle.points() != nullptr) {
+        scan.points.assign(handle.points(), handle.points() + handle.pointCount());
+    } else {
+        scan.points.clear();   // Bookkeeping-only assembler
+    }
+
+    return true;
 }
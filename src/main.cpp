@@ -1,27 +1,520 @@
-#include <iostream>
+#include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include "ingest_reactor.h"
+#include "chunk_pipeline.h"
+#include "command_channel.h"
+#include "telemetry_monitor.h"
+#include "rover_state.h"
+#include "point_renderer.h"
+#include "height_map.h"
+#include "point_filter.h"
+#include "terrain_mesher.h"
+#include "terrain_renderer.h"
+#include "spsc_ring.h"
+#include "latency_stats.h"
+
+// LiDAR point cloud viewer
+//
+// Rover streams are received by an IngestReactor on its own thread and
+// georeferenced chunk by chunk (ChunkPipeline); world-space chunks reach the
+// render thread through preallocated slots passed over SPSC rings and are
+// appended to the PointRenderer's persistent rings. The same chunks,
+// filtered per scan (PointFilter), build the HeightMap on the reactor
+// thread; TerrainMesher meshes changed tiles
+// and the TerrainRenderer culls and draws them. Once a second the upload
+// bytes per frame, frame times, terrain culling results and button command
+// round trips are printed.
+//
+// Usage:
+//   lidar_viz [--rovers N] [--points-per-rover N] [--synthetic POINTS_PER_SEC] [--fill-map 1]
+//             [--filter-voxel M] [--filter-reduction N]
+// --synthetic feeds generated points instead of the network (per rover),
+// to check that frame time stays flat as the cloud grows. --fill-map 1
+// covers the whole height map with generated terrain at startup, to check
+// frame time with the full map loaded. --filter-voxel sets the PointFilter
+// voxel edge (default: the height map cell size, so each cell gets about
+// one point per scan); --filter-reduction N > 0 lets the filter adapt the
+// voxel to keep about 1/N of the points instead.
+// Left drag orbits, scroll zooms, keys 1-4 toggle buttons 0-3 on every
+// rover, Esc quits. Button changes and lost rover links are printed as
+// they happen.
+
+namespace {
+
+// World-space chunks handed from the reactor thread to the render thread
+// Slots circulate reactor -> render (filled) -> reactor (free), as in AssemblerPool.
+// Chunks are also collected per rover on the reactor thread; when a scan is
+// complete its points are downsampled and cleaned by a PointFilter before
+// they go into the height map, and the scan is published to the rover's
+// state snapshot.
+class RenderFeed : public ChunkSink {
+public:
+    struct Slot {
+        uint32_t roverId;
+        uint32_t pointCount;
+        glm::vec3 points[MAX_LIDAR_POINTS_PER_PACKET];
+    };
+
+    RenderFeed(size_t depth, HeightMap& map, const PointFilter::Config& filterConfig)
+        : slots_(depth), filled_(depth), free_(depth), map_(map), filter_(filterConfig),
+          state_(nullptr), dropped_(0) {
+        for (uint32_t i = 0; i < depth; ++i) {
+            free_.push(i);
+        }
+    }
+
+    // Reactor thread
+    void onWorldChunk(const WorldChunk& chunk) override {
+        if (chunk.roverId >= scanPoints_.size()) {
+            scanPoints_.resize(chunk.roverId + 1);
+        }
+        std::vector<LidarPoint>& scan = scanPoints_[chunk.roverId];
+        for (size_t i = 0; i < chunk.pointCount; ++i) {
+            scan.push_back({chunk.points[i].x, chunk.points[i].y, chunk.points[i].z});
+        }
+
+        uint32_t index = 0;
+        if (!free_.pop(index)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);   // Render thread fell behind
+            return;
+        }
+        Slot& slot = slots_[index];
+        slot.roverId = chunk.roverId;
+        slot.pointCount = static_cast<uint32_t>(std::min<size_t>(chunk.pointCount, MAX_LIDAR_POINTS_PER_PACKET));
+        std::copy(chunk.points, chunk.points + slot.pointCount, slot.points);
+        filled_.push(index);
+    }
+
+    // Where finished scans are published (before the reactor starts)
+    void setStateBuffer(RoverStateBuffer* state) { state_ = state; }
+
+    // Reactor thread
+    // The rover's collected chunks go through the filter into the height
+    // map. Chunks of the next scan that overtook a partial one are filtered
+    // with it, which only merges two sweeps of the same ground.
+    // The map fuses filtered points, each the mean of a voxel neighbourhood,
+    // not raw returns: a cell's hits count filtered points, and its
+    // variance and standard error describe how those means spread across
+    // scans, which is narrower than the sensor noise.
+    void onScanComplete(uint32_t roverId, const ScanHandle& scan) override {
+        if (roverId < scanPoints_.size() && !scanPoints_[roverId].empty()) {
+            std::vector<LidarPoint>& points = scanPoints_[roverId];
+            filter_.filter(points);
+            filtered_.resize(points.size());
+            for (size_t i = 0; i < points.size(); ++i) {
+                filtered_[i] = glm::vec3(points[i].x, points[i].y, points[i].z);
+            }
+            map_.insert(filtered_);
+            points.clear();   // Capacity kept for the next scan
+        }
+        if (state_ != nullptr) {
+            state_->publishScan(roverId, scan);
+        }
+    }
+
+    // Render thread: append every waiting chunk to the renderer
+    void drainInto(PointRenderer& renderer) {
+        uint32_t index = 0;
+        while (filled_.pop(index)) {
+            const Slot& slot = slots_[index];
+            renderer.append(slot.roverId, slot.points, slot.pointCount);
+            free_.push(index);
+        }
+    }
+
+    size_t getDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<Slot> slots_;
+    SpscRing<uint32_t> filled_;
+    SpscRing<uint32_t> free_;
+    HeightMap& map_;
+    PointFilter filter_;
+    std::vector<std::vector<LidarPoint>> scanPoints_;   // Indexed by rover ID, current scan
+    std::vector<glm::vec3> filtered_;                    // One filtered scan for HeightMap::insert
+    RoverStateBuffer* state_;
+    std::atomic<size_t> dropped_;
+};
+
+// Prints telemetry events (reactor thread)
+class TelemetryLog : public TelemetryListener {
+public:
+    void onButtonsChanged(uint32_t roverId, uint8_t previous, uint8_t current, uint64_t) override {
+        std::cout << "rover " << roverId << " buttons 0x" << std::hex << static_cast<int>(previous)
+                  << " -> 0x" << static_cast<int>(current) << std::dec << std::endl;
+    }
+    void onLinkUp(uint32_t roverId) override {
+        std::cout << "rover " << roverId << " telemetry up" << std::endl;
+    }
+    void onLinkLost(uint32_t roverId, uint64_t silentNs) override {
+        std::cout << "rover " << roverId << " telemetry lost (silent " << silentNs / 1000000 << " ms)" << std::endl;
+    }
+};
+
+// Orbit camera driven by GLFW callbacks
+struct OrbitCamera {
+    float yaw = 0.8f;
+    float pitch = 0.6f;
+    float distance = 150.0f;
+    bool dragging = false;
+    double lastX = 0.0, lastY = 0.0;
+
+    glm::vec3 eye() const {
+        return glm::vec3(distance * std::cos(pitch) * std::cos(yaw),
+                         distance * std::sin(pitch),
+                         distance * std::cos(pitch) * std::sin(yaw));
+    }
+    glm::mat4 view() const {
+        return glm::lookAt(eye(), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+    glm::mat4 projection(float aspect) const {
+        return glm::perspective(glm::radians(50.0f), aspect, 0.5f, 5000.0f);
+    }
+};
+
+void onMouseButton(GLFWwindow* window, int button, int action, int) {
+    OrbitCamera* camera = static_cast<OrbitCamera*>(glfwGetWindowUserPointer(window));
+    if (button == GLFW_MOUSE_BUTTON_LEFT) {
+        camera->dragging = action == GLFW_PRESS;
+        glfwGetCursorPos(window, &camera->lastX, &camera->lastY);
+    }
+}
+
+void onCursor(GLFWwindow* window, double x, double y) {
+    OrbitCamera* camera = static_cast<OrbitCamera*>(glfwGetWindowUserPointer(window));
+    if (camera->dragging) {
+        camera->yaw += static_cast<float>(x - camera->lastX) * 0.005f;
+        camera->pitch = glm::clamp(camera->pitch + static_cast<float>(y - camera->lastY) * 0.005f, -1.5f, 1.5f);
+    }
+    camera->lastX = x;
+    camera->lastY = y;
+}
+
+void onScroll(GLFWwindow* window, double, double dy) {
+    OrbitCamera* camera = static_cast<OrbitCamera*>(glfwGetWindowUserPointer(window));
+    camera->distance = glm::clamp(camera->distance * static_cast<float>(std::pow(0.9, dy)), 5.0f, 3000.0f);
+}
+
+const glm::vec3 ROVER_COLORS[] = {
+    {1.0f, 0.35f, 0.3f}, {0.3f, 0.85f, 0.4f}, {0.35f, 0.55f, 1.0f},
+    {1.0f, 0.8f, 0.25f}, {0.85f, 0.4f, 1.0f}, {0.3f, 0.9f, 0.9f}
+};
+
+// One point per cell over the whole map: rolling hills
+void fillMap(HeightMap& map) {
+    const HeightMap::Config& config = map.getConfig();
+    const float half = config.extent * 0.5f;
+    std::vector<glm::vec3> row;
+    for (float z = -half + config.cellSize * 0.5f; z < half; z += config.cellSize) {
+        row.clear();
+        for (float x = -half + config.cellSize * 0.5f; x < half; x += config.cellSize) {
+            float y = 4.0f * std::sin(x * 0.02f) * std::cos(z * 0.015f) + 0.5f * std::sin(x * 0.3f + z * 0.2f);
+            row.push_back(glm::vec3(x, y, z));
+        }
+        map.insert(row);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t rovers = 5;
+    double syntheticRate = 0.0;
+    bool fill = false;
+    PointRenderer::Config renderConfig;
+    PointFilter::Config filterConfig;
+    filterConfig.voxelSize = HeightMap::Config().cellSize;
+    filterConfig.reductionFactor = 0.0f;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--rovers") {
+            rovers = static_cast<uint32_t>(std::atoi(argv[i + 1]));
+        } else if (arg == "--points-per-rover") {
+            renderConfig.pointsPerRover = static_cast<size_t>(std::atol(argv[i + 1]));
+        } else if (arg == "--synthetic") {
+            syntheticRate = std::atof(argv[i + 1]);
+        } else if (arg == "--fill-map") {
+            fill = std::atoi(argv[i + 1]) != 0;
+        } else if (arg == "--filter-voxel") {
+            filterConfig.voxelSize = static_cast<float>(std::atof(argv[i + 1]));
+        } else if (arg == "--filter-reduction") {
+            filterConfig.reductionFactor = static_cast<float>(std::atof(argv[i + 1]));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--rovers N] [--points-per-rover N] [--synthetic POINTS_PER_SEC] [--fill-map 1]"
+                      << " [--filter-voxel M] [--filter-reduction N]" << std::endl;
+            return 1;
+        }
+    }
 
-int main() {
-    std::cout << "LiDAR Visualization System - Build Test" << std::endl;
-    
-    // Test GLFW initialization
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW" << std::endl;
         return -1;
     }
-    
-    // Test GLM
-    glm::vec3 testVector(1.0f, 2.0f, 3.0f);
-    glm::mat4 identity = glm::mat4(1.0f);
-    std::cout << "GLM test vector: (" 
-              << testVector.x << ", " 
-              << testVector.y << ", " 
-              << testVector.z << ")" << std::endl;
-    
-    std::cout << "Build configuration successful!" << std::endl;
-    
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    GLFWwindow* window = glfwCreateWindow(1280, 720, "LiDAR Visualization", nullptr, nullptr);
+    if (window == nullptr) {
+        // macOS tops out at a forward-compatible 4.1 core context; the
+        // renderers fall back to what it offers
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+        window = glfwCreateWindow(1280, 720, "LiDAR Visualization", nullptr, nullptr);
+    }
+    if (window == nullptr) {
+        std::cerr << "Failed to create an OpenGL 4.1 window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(1);
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
+        std::cerr << "Failed to load OpenGL functions" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+
+    OrbitCamera camera;
+    glfwSetWindowUserPointer(window, &camera);
+    glfwSetMouseButtonCallback(window, onMouseButton);
+    glfwSetCursorPosCallback(window, onCursor);
+    glfwSetScrollCallback(window, onScroll);
+
+    int exitCode = 0;
+    {
+        PointRenderer renderer(renderConfig);
+        std::vector<RoverPorts> ports = IngestReactor::portsForRovers(rovers);
+        bool ready = renderer.initialize();
+        for (size_t i = 0; ready && i < ports.size(); ++i) {
+            ready = renderer.addRover(ports[i].roverId, ROVER_COLORS[i % 6]);
+        }
+
+        // Terrain: built where the points arrive, meshed on workers, drawn here
+        HeightMap map;
+        TerrainMesher mesher(map);
+        TerrainRenderer::Config terrainConfig;
+        terrainConfig.upAxis = map.getConfig().upAxis;
+        TerrainRenderer terrain(terrainConfig);
+        TerrainMesher::MeshFrame meshFrame;
+        ready = ready && terrain.initialize();
+        mesher.start();
+        if (ready && fill) {
+            fillMap(map);
+        }
+
+        // Network feed (skipped in synthetic mode). Packets pass through the
+        // state buffer (read by the render loop without touching the
+        // pipeline), the telemetry monitor and the command channel on their
+        // way to the pipeline
+        RenderFeed feed(8192, map, filterConfig);
+        ChunkPipeline pipeline(feed);
+        CommandChannel commands(&pipeline);
+        LatencyRecorder commandLatency(rovers);
+        commands.setLatencyRecorder(&commandLatency);
+        TelemetryMonitor telemetry(&commands);
+        TelemetryLog telemetryLog;
+        telemetry.addListener(telemetryLog);
+        RoverStateBuffer state(&telemetry);
+        feed.setStateBuffer(&state);
+        IngestReactor reactor;
+        std::atomic<bool> stopReactor(false);
+        std::thread reactorThread;
+        if (ready && syntheticRate <= 0.0) {
+            for (const RoverPorts& rover : ports) {
+                pipeline.addRover(rover.roverId);
+                commands.addRover(rover);
+                telemetry.addRover(rover.roverId);
+                state.addRover(rover.roverId);
+                ready = ready && reactor.addRover(rover, state);
+            }
+            if (ready) {
+                reactorThread = std::thread([&]() {
+                    while (!stopReactor.load(std::memory_order_relaxed)) {
+                        reactor.pollOnce(10);
+                        pipeline.poll();
+                        commands.poll();
+                        telemetry.poll();
+                        mesher.beginFrame();
+                    }
+                });
+            }
+        }
+        if (!ready) {
+            exitCode = -1;
+            glfwSetWindowShouldClose(window, GLFW_TRUE);
+        } else {
+            std::cout << "Rendering " << ports.size() << " rovers, ring capacity "
+                      << renderer.getCapacity() / 1000000.0 << " M points"
+                      << (syntheticRate > 0.0 ? " (synthetic)" : "") << std::endl;
+        }
+
+        // Synthetic points: rovers drive outward, scattering points around them
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> spread(-30.0f, 30.0f);
+        std::vector<glm::vec3> synthetic(static_cast<size_t>(std::max(syntheticRate, 0.0) / 30.0) + 1);
+        double syntheticCarry = 0.0;
+
+        glEnable(GL_DEPTH_TEST);
+        glClearColor(0.05f, 0.05f, 0.08f, 1.0f);
+
+        auto start = std::chrono::steady_clock::now();
+        auto lastFrame = start;
+        auto lastReport = start;
+        size_t frames = 0, uploadBytes = 0, fenceWaits = 0;
+        double frameMsMax = 0.0, cpuMsTotal = 0.0;
+        std::vector<RoverSnapshot> snapshots(ports.size());
+        uint8_t buttons = 0;
+        bool keyWasDown[4] = {false, false, false, false};
+
+        while (!glfwWindowShouldClose(window)) {
+            auto frameStart = std::chrono::steady_clock::now();
+            double frameMs = std::chrono::duration<double, std::milli>(frameStart - lastFrame).count();
+            lastFrame = frameStart;
+
+            renderer.beginFrame();
+            if (syntheticRate > 0.0) {
+                double elapsed = std::chrono::duration<double>(frameStart - start).count();
+                syntheticCarry += syntheticRate * frameMs / 1000.0;
+                size_t count = std::min(static_cast<size_t>(syntheticCarry), synthetic.size());
+                syntheticCarry -= static_cast<double>(count);
+                for (size_t r = 0; r < ports.size(); ++r) {
+                    float heading = 6.2831853f * static_cast<float>(r) / static_cast<float>(ports.size());
+                    glm::vec3 centre(2.0f * elapsed * std::cos(heading), 0.0f, 2.0f * elapsed * std::sin(heading));
+                    for (size_t i = 0; i < count; ++i) {
+                        float x = spread(rng), z = spread(rng);
+                        synthetic[i] = centre + glm::vec3(x, 0.1f * (x + z), z);
+                    }
+                    renderer.append(ports[r].roverId, synthetic.data(), count);
+                    map.insert(synthetic.data(), count);
+                }
+            } else {
+                feed.drainInto(renderer);
+            }
+            if (syntheticRate > 0.0 || !reactorThread.joinable()) {
+                mesher.beginFrame();   // This thread is the one inserting
+            }
+            if (mesher.takeFrame(meshFrame)) {
+                terrain.upload(meshFrame);
+            }
+
+            // Newest rover state; never waits on the reactor thread. The
+            // loop does not read the scan, so its arena slot is released at
+            // once instead of being held until the next frame
+            for (size_t r = 0; r < ports.size(); ++r) {
+                state.getSnapshot(ports[r].roverId, snapshots[r]);
+                snapshots[r].scan.reset();
+            }
+
+            int width = 0, height = 0;
+            glfwGetFramebufferSize(window, &width, &height);
+            glViewport(0, 0, width, height);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glm::mat4 view = camera.view();
+            glm::mat4 projection = camera.projection(height > 0 ? static_cast<float>(width) / height : 1.0f);
+            terrain.draw(view, projection, camera.eye(), static_cast<float>(height));
+            renderer.draw(projection * view);
+
+            const PointRenderer::FrameStats& stats = renderer.getFrameStats();
+            cpuMsTotal += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+            uploadBytes += stats.uploadBytes;
+            fenceWaits += stats.fenceWaits;
+            frameMsMax = std::max(frameMsMax, frameMs);
+            frames++;
+
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+            if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
+                glfwSetWindowShouldClose(window, GLFW_TRUE);
+            }
+            for (int b = 0; b < 4; ++b) {
+                bool down = glfwGetKey(window, GLFW_KEY_1 + b) == GLFW_PRESS;
+                if (down && !keyWasDown[b] && reactorThread.joinable()) {
+                    buttons ^= static_cast<uint8_t>(1u << b);
+                    for (const RoverPorts& rover : ports) {
+                        commands.request(rover.roverId, buttons);   // Sent by the reactor thread
+                    }
+                }
+                keyWasDown[b] = down;
+            }
+
+            double sinceReport = std::chrono::duration<double>(frameStart - lastReport).count();
+            if (sinceReport >= 1.0) {
+                std::cout << std::fixed << std::setprecision(2)
+                          << "points " << renderer.getTotalPoints() / 1e6 << " M"
+                          << " | drawn " << stats.pointsDrawn / 1e6 << " M in " << stats.drawCalls << " calls"
+                          << " | upload " << uploadBytes / frames / 1024.0 << " KB/frame"
+                          << " | frame " << sinceReport * 1000.0 / frames << " ms avg, " << frameMsMax << " max"
+                          << " | cpu " << cpuMsTotal / frames << " ms"
+                          << " | fence waits " << fenceWaits
+                          << " | feed drops " << feed.getDropped() << std::endl;
+                const TerrainRenderer::FrameStats& tiles = terrain.getFrameStats();
+                std::cout << "terrain " << tiles.tilesVisible << "/" << tiles.tiles << " tiles visible"
+                          << " | LOD " << tiles.tilesPerLevel[0] << "/" << tiles.tilesPerLevel[1]
+                          << "/" << tiles.tilesPerLevel[2]
+                          << " | " << tiles.triangles / 1e6 << " M triangles in " << tiles.drawCalls << " calls"
+                          << " | cull " << tiles.cullMs << " ms"
+                          << " | rejected " << terrain.getStats().tilesRejected << std::endl;
+                size_t posed = 0;
+                uint64_t scans = 0;
+                double poseAgeMs = 0.0;
+                uint64_t now = realtimeNowNs();
+                for (const RoverSnapshot& snapshot : snapshots) {
+                    if (snapshot.hasPose) {
+                        posed++;
+                        if (now > snapshot.poseArrivalNs) {
+                            poseAgeMs = std::max(poseAgeMs, (now - snapshot.poseArrivalNs) / 1e6);
+                        }
+                    }
+                    scans += snapshot.scanUpdates;
+                }
+                uint64_t rttCount = 0, rttP99 = 0, rttMax = 0;
+                for (const RoverPorts& rover : ports) {
+                    const LatencyHistogram* rtt =
+                        commandLatency.histogram(rover.roverId, LatencyStage::CommandRoundTrip);
+                    if (rtt != nullptr && rtt->count() > 0) {
+                        rttCount += rtt->count();
+                        rttP99 = std::max(rttP99, rtt->percentile(99.0));
+                        rttMax = std::max(rttMax, rtt->max());
+                    }
+                }
+                std::cout << "rovers " << posed << "/" << snapshots.size() << " with pose"
+                          << " | oldest pose " << poseAgeMs << " ms"
+                          << " | scans " << scans
+                          << " | buttons 0x" << std::hex << static_cast<int>(buttons) << std::dec
+                          << " | command rtt p99 " << rttP99 / 1e6 << " ms, max " << rttMax / 1e6
+                          << " ms (" << rttCount << " confirmed)" << std::endl;
+                lastReport = frameStart;
+                frames = 0;
+                uploadBytes = 0;
+                fenceWaits = 0;
+                frameMsMax = 0.0;
+                cpuMsTotal = 0.0;
+            }
+        }
+
+        stopReactor.store(true);
+        if (reactorThread.joinable()) {
+            reactorThread.join();
+        }
+        mesher.stop();
+    }   // Renderer releases its buffers while the context is still current
+
+    glfwDestroyWindow(window);
     glfwTerminate();
-    return 0;
+    return exitCode;
 }
@@ -0,0 +1,423 @@
+#include "packet_log.h"
+#include "latency_stats.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+const char MAGIC[8] = {'R', 'V', 'P', 'K', 'T', 'L', 'G', '1'};
+const uint32_t FORMAT_VERSION = 1;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t formatVersion;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 16, "log header is 16 bytes");
+static_assert(sizeof(PacketLogRecord) == 16, "record header is 16 bytes");
+
+// Longest a paced replay sleeps before checking stop()
+const uint64_t MAX_SLEEP_NS = 50 * 1000000ull;
+
+// Replay wait between two records: 0 if the clock stepped back, at most
+// maxGapNs (e.g. across appended sessions)
+uint64_t clampedGapNs(uint64_t previousNs, uint64_t arrivalNs, uint64_t maxGapNs) {
+    return arrivalNs > previousNs ? std::min(arrivalNs - previousNs, maxGapNs) : 0;
+}
+
+bool validHeader(const FileHeader& header) {
+    return memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.formatVersion == FORMAT_VERSION;
+}
+
+// Offset just past the last complete record of a log of the given size
+// (read through fd); bytes after it belong to a record cut short by a crash
+bool findCleanEnd(int fd, size_t bytes, size_t& cleanEnd) {
+    cleanEnd = sizeof(FileHeader);
+    if (bytes <= cleanEnd) {
+        return true;
+    }
+
+    void* base = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    madvise(base, bytes, MADV_SEQUENTIAL);
+
+    const uint8_t* data = static_cast<const uint8_t*>(base);
+    while (cleanEnd + sizeof(PacketLogRecord) <= bytes) {
+        PacketLogRecord record;
+        memcpy(&record, data + cleanEnd, sizeof(record));
+        if (cleanEnd + sizeof(record) + record.length > bytes) {
+            break;
+        }
+        cleanEnd += sizeof(record) + record.length;
+    }
+    munmap(base, bytes);
+    return true;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// PacketRecorder
+
+PacketRecorder::PacketRecorder() : PacketRecorder(Config()) {
+}
+
+PacketRecorder::PacketRecorder(const Config& config)
+    : config_(config), fd_(-1), active_(0), used_(0), fullBytes_(0), writing_(false),
+      stopWriter_(false), records_(0), bytes_(0), droppedRecords_(0), writeErrors_(0) {
+    // A buffer must hold at least one full-size record
+    config_.bufferBytes = std::max(config_.bufferBytes, sizeof(PacketLogRecord) + 65536);
+}
+
+PacketRecorder::~PacketRecorder() {
+    close();
+}
+
+bool PacketRecorder::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error opening packet log " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // New file: write the header; existing one: append after checking it,
+    // behind the last complete record
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        std::cerr << "Error reading packet log " << path << ": " << strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+    if (st.st_size == 0) {
+        FileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.formatVersion = FORMAT_VERSION;
+        if (write(fd, &header, sizeof(header)) != static_cast<ssize_t>(sizeof(header))) {
+            std::cerr << "Error writing packet log " << path << ": " << strerror(errno) << std::endl;
+            ::close(fd);
+            return false;
+        }
+    } else {
+        FileHeader header;
+        if (pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+            !validHeader(header)) {
+            std::cerr << "Error: " << path << " is not a packet log" << std::endl;
+            ::close(fd);
+            return false;
+        }
+
+        // A cut-off record would swallow the start of the new session on replay
+        size_t bytes = static_cast<size_t>(st.st_size);
+        size_t cleanEnd = 0;
+        if (!findCleanEnd(fd, bytes, cleanEnd) ||
+            (cleanEnd < bytes && ftruncate(fd, static_cast<off_t>(cleanEnd)) != 0)) {
+            std::cerr << "Error repairing packet log " << path << ": " << strerror(errno) << std::endl;
+            ::close(fd);
+            return false;
+        }
+        if (cleanEnd < bytes) {
+            std::cerr << "Warning: dropped " << bytes - cleanEnd << " bytes of a cut-off record at the end of "
+                      << path << std::endl;
+        }
+    }
+
+    // Touch both buffers now so record() never faults in fresh pages
+    for (auto& buffer : buffers_) {
+        buffer.assign(config_.bufferBytes, 0);
+    }
+    fd_ = fd;
+    active_ = 0;
+    used_ = 0;
+    fullBytes_ = 0;
+    writing_ = false;
+    stopWriter_ = false;
+    writer_ = std::thread(&PacketRecorder::writerLoop, this);
+    return true;
+}
+
+void PacketRecorder::close() {
+    if (fd_ < 0) return;
+
+    // Wait for the writer to take the other buffer, then queue the active one
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this] { return fullBytes_ == 0 && !writing_; });
+        fullBytes_ = used_;
+        active_ ^= 1;
+        used_ = 0;
+        stopWriter_ = true;
+    }
+    cond_.notify_all();
+    writer_.join();
+
+    ::close(fd_);
+    fd_ = -1;
+}
+
+void PacketRecorder::record(uint32_t roverId, StreamKind kind, const uint8_t* data, size_t length,
+                            uint64_t arrivalNs) {
+    if (fd_ < 0) return;
+
+    const size_t recordBytes = sizeof(PacketLogRecord) + length;
+    if (length > UINT16_MAX) {
+        droppedRecords_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (used_ + recordBytes > config_.bufferBytes) {
+        // Hand the full buffer over, unless the writer still owns the other one
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (fullBytes_ != 0 || writing_) {
+                droppedRecords_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            fullBytes_ = used_;
+            active_ ^= 1;
+            used_ = 0;
+        }
+        cond_.notify_all();
+    }
+
+    PacketLogRecord header;
+    header.arrivalNs = arrivalNs;
+    header.roverId = roverId;
+    header.length = static_cast<uint16_t>(length);
+    header.kind = static_cast<uint8_t>(kind);
+    header.reserved = 0;
+
+    uint8_t* out = buffers_[active_].data() + used_;
+    memcpy(out, &header, sizeof(header));
+    memcpy(out + sizeof(header), data, length);
+    used_ += recordBytes;
+
+    records_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(recordBytes, std::memory_order_relaxed);
+}
+
+void PacketRecorder::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cond_.wait(lock, [this] { return fullBytes_ != 0 || stopWriter_; });
+        if (fullBytes_ != 0) {
+            // The full buffer is the one record() is not filling
+            const uint8_t* data = buffers_[active_ ^ 1].data();
+            size_t length = fullBytes_;
+            writing_ = true;
+            lock.unlock();
+
+            if (!writeAll(data, length)) {
+                writeErrors_.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            lock.lock();
+            writing_ = false;
+            fullBytes_ = 0;
+            cond_.notify_all();
+        } else if (stopWriter_) {
+            return;
+        }
+    }
+}
+
+bool PacketRecorder::writeAll(const uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd_, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Error writing packet log: " << strerror(errno) << std::endl;
+            return false;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+PacketRecorder::Stats PacketRecorder::getStats() const {
+    Stats stats;
+    stats.records = records_.load(std::memory_order_relaxed);
+    stats.bytes = bytes_.load(std::memory_order_relaxed);
+    stats.droppedRecords = droppedRecords_.load(std::memory_order_relaxed);
+    stats.writeErrors = writeErrors_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// ---------------------------------------------------------------------------
+// PacketReplayer
+
+PacketReplayer::PacketReplayer() : PacketReplayer(Config()) {
+}
+
+PacketReplayer::PacketReplayer(const Config& config)
+    : config_(config), base_(nullptr), mappedBytes_(0), endOffset_(0), recordCount_(0),
+      firstArrivalNs_(0), durationNs_(0), defaultHandler_(nullptr), stopRequested_(false) {
+}
+
+PacketReplayer::~PacketReplayer() {
+    close();
+}
+
+bool PacketReplayer::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Error opening packet log " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FileHeader)) {
+        std::cerr << "Error: " << path << " is not a packet log" << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    size_t bytes = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // The mapping keeps the file open
+    if (base == MAP_FAILED) {
+        std::cerr << "Error mapping packet log " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    madvise(base, bytes, MADV_SEQUENTIAL);
+
+    FileHeader header;
+    memcpy(&header, base, sizeof(header));
+    if (!validHeader(header)) {
+        std::cerr << "Error: " << path << " is not a packet log" << std::endl;
+        munmap(base, bytes);
+        return false;
+    }
+
+    base_ = static_cast<const uint8_t*>(base);
+    mappedBytes_ = bytes;
+
+    // Index pass: count records and find the time span and the clean end
+    size_t offset = sizeof(FileHeader);
+    recordCount_ = 0;
+    durationNs_ = 0;
+    uint64_t previousNs = 0;
+    while (offset + sizeof(PacketLogRecord) <= bytes) {
+        PacketLogRecord record;
+        memcpy(&record, base_ + offset, sizeof(record));
+        if (offset + sizeof(record) + record.length > bytes) {
+            break;   // Cut short by a crash
+        }
+        if (recordCount_ == 0) {
+            firstArrivalNs_ = previousNs = record.arrivalNs;
+        }
+        durationNs_ += clampedGapNs(previousNs, record.arrivalNs, config_.maxGapNs);
+        previousNs = record.arrivalNs;
+        recordCount_++;
+        offset += sizeof(record) + record.length;
+    }
+    endOffset_ = offset;
+    if (recordCount_ == 0) {
+        firstArrivalNs_ = 0;
+    }
+    return true;
+}
+
+void PacketReplayer::close() {
+    if (base_ == nullptr) return;
+    munmap(const_cast<uint8_t*>(base_), mappedBytes_);
+    base_ = nullptr;
+    mappedBytes_ = 0;
+    endOffset_ = 0;
+    recordCount_ = 0;
+}
+
+void PacketReplayer::addRover(uint32_t roverId, IngestHandler& handler) {
+    if (roverId >= handlers_.size()) {
+        handlers_.resize(roverId + 1, nullptr);
+    }
+    handlers_[roverId] = &handler;
+}
+
+IngestHandler* PacketReplayer::findHandler(uint32_t roverId) const {
+    if (roverId < handlers_.size() && handlers_[roverId] != nullptr) {
+        return handlers_[roverId];
+    }
+    return defaultHandler_;
+}
+
+size_t PacketReplayer::run(double speed) {
+    if (base_ == nullptr) return 0;
+    stopRequested_.store(false, std::memory_order_release);
+    stats_ = Stats();
+
+    const bool paced = speed > 0.0;
+    const uint64_t startNs = steadyNowNs();
+    size_t handled = 0;
+    double maxLagNs = 0.0;
+    uint64_t previousNs = firstArrivalNs_;
+    uint64_t replayNs = 0;   // Where the record falls in a 1x replay
+
+    size_t offset = sizeof(FileHeader);
+    while (offset < endOffset_ && !stopRequested_.load(std::memory_order_acquire)) {
+        PacketLogRecord record;
+        memcpy(&record, base_ + offset, sizeof(record));
+        const uint8_t* payload = base_ + offset + sizeof(record);
+        offset += sizeof(record) + record.length;
+
+        if (record.arrivalNs < previousNs || record.arrivalNs - previousNs > config_.maxGapNs) {
+            stats_.gapsClamped++;
+        }
+        replayNs += clampedGapNs(previousNs, record.arrivalNs, config_.maxGapNs);
+        previousNs = record.arrivalNs;
+
+        if (paced) {
+            // Sleep (in slices, so stop() is honoured) until the record is due
+            uint64_t dueNs = startNs + static_cast<uint64_t>(static_cast<double>(replayNs) / speed);
+            uint64_t nowNs = steadyNowNs();
+            while (nowNs < dueNs && !stopRequested_.load(std::memory_order_acquire)) {
+                uint64_t sleepNs = std::min(dueNs - nowNs, MAX_SLEEP_NS);
+                struct timespec ts;
+                ts.tv_sec = static_cast<time_t>(sleepNs / 1000000000ull);
+                ts.tv_nsec = static_cast<long>(sleepNs % 1000000000ull);
+                nanosleep(&ts, nullptr);
+                nowNs = steadyNowNs();
+            }
+            maxLagNs = std::max(maxLagNs, static_cast<double>(nowNs) - static_cast<double>(dueNs));
+        }
+
+        IngestHandler* handler = findHandler(record.roverId);
+        if (handler == nullptr) {
+            stats_.unknownRover++;
+            continue;
+        }
+
+        StreamKind kind = static_cast<StreamKind>(record.kind);
+        uint64_t arrivalNs = config_.restampArrivals ? realtimeNowNs() : record.arrivalNs;
+        if (!decoder_.dispatch(kind, record.roverId, payload, record.length, arrivalNs, *handler)) {
+            stats_.malformedPackets++;
+            continue;
+        }
+
+        switch (kind) {
+            case StreamKind::Pose:      stats_.posePackets++; break;
+            case StreamKind::Lidar:     stats_.lidarPackets++; break;
+            case StreamKind::Telemetry: stats_.telemPackets++; break;
+        }
+        handled++;
+    }
+
+    stats_.records = handled;
+    stats_.runSeconds = static_cast<double>(steadyNowNs() - startNs) / 1e9;
+    stats_.maxLagMs = maxLagNs / 1e6;
+    return handled;
+}
@@ -0,0 +1,141 @@
+#include "point_filter.h"
+#include "voxel_key.h"
+#include <cmath>
+#include <algorithm>
+
+const uint64_t PointFilter::EMPTY_KEY;
+
+PointFilter::PointFilter() : PointFilter(Config()) {
+}
+
+PointFilter::PointFilter(const Config& config)
+    : config_(config), shift_(64) {
+    if (config_.minVoxelSize <= 0.0f) config_.minVoxelSize = 0.05f;
+    config_.maxVoxelSize = std::max(config_.maxVoxelSize, config_.minVoxelSize);
+    voxelSize_ = std::min(std::max(config_.voxelSize, config_.minVoxelSize), config_.maxVoxelSize);
+
+    voxels_.reserve(config_.expectedPoints);
+    resetTable(config_.expectedPoints);
+}
+
+void PointFilter::resetTable(size_t count) {
+    // Power of two, at most half full even if every point has its own voxel
+    uint32_t bits = 4;
+    while ((size_t(1) << bits) < count * 2 && bits < 31) {
+        bits++;
+    }
+    if (keys_.size() < (size_t(1) << bits)) {
+        keys_.resize(size_t(1) << bits);
+        indices_.resize(size_t(1) << bits);
+    }
+    shift_ = 64 - bits;
+    std::fill(keys_.begin(), keys_.begin() + (std::ptrdiff_t(1) << bits), EMPTY_KEY);
+}
+
+uint32_t PointFilter::findVoxel(int32_t x, int32_t y, int32_t z) const {
+    const uint64_t key = packVoxelKey(x, y, z);
+    const uint32_t mask = static_cast<uint32_t>((size_t(1) << (64 - shift_)) - 1);
+    for (uint32_t slot = voxelKeySlot(key, shift_);; slot = (slot + 1) & mask) {
+        if (keys_[slot] == key) {
+            return indices_[slot];
+        }
+        if (keys_[slot] == EMPTY_KEY) {
+            return UINT32_MAX;
+        }
+    }
+}
+
+size_t PointFilter::filter(LidarPoint* points, size_t count) {
+    stats_.scansFiltered++;
+    stats_.pointsIn += count;
+    if (count == 0) {
+        return 0;
+    }
+
+    resetTable(count);
+    voxels_.clear();
+    const uint32_t mask = static_cast<uint32_t>((size_t(1) << (64 - shift_)) - 1);
+    const float inv = 1.0f / voxelSize_;
+
+    // Bin points, accumulating sums per voxel
+    for (size_t i = 0; i < count; ++i) {
+        const LidarPoint& p = points[i];
+        int32_t v[3];
+        if (!gridCoordinates(p.x * inv, p.y * inv, p.z * inv, VOXEL_KEY_RANGE, v)) {
+            continue;
+        }
+        int32_t x = v[0], y = v[1], z = v[2];
+
+        uint64_t key = packVoxelKey(x, y, z);
+        uint32_t slot = voxelKeySlot(key, shift_);
+        while (keys_[slot] != EMPTY_KEY && keys_[slot] != key) {
+            slot = (slot + 1) & mask;
+        }
+        if (keys_[slot] == EMPTY_KEY) {
+            keys_[slot] = key;
+            indices_[slot] = static_cast<uint32_t>(voxels_.size());
+            voxels_.push_back({x, y, z, 0, 0.0f, 0.0f, 0.0f, 0, 0.0f, 0.0f, 0.0f});
+        }
+        Voxel& voxel = voxels_[indices_[slot]];
+        voxel.count++;
+        voxel.sumX += p.x;
+        voxel.sumY += p.y;
+        voxel.sumZ += p.z;
+    }
+
+    // Neighbourhood counts and sums (27 lookups per voxel)
+    double sum = 0.0, sumSq = 0.0;
+    for (Voxel& voxel : voxels_) {
+        uint32_t neighbors = 0;
+        float sx = 0.0f, sy = 0.0f, sz = 0.0f;
+        for (int32_t dz = -1; dz <= 1; ++dz) {
+            for (int32_t dy = -1; dy <= 1; ++dy) {
+                for (int32_t dx = -1; dx <= 1; ++dx) {
+                    uint32_t index = findVoxel(voxel.x + dx, voxel.y + dy, voxel.z + dz);
+                    if (index != UINT32_MAX) {
+                        const Voxel& n = voxels_[index];
+                        neighbors += n.count;
+                        sx += n.sumX; sy += n.sumY; sz += n.sumZ;
+                    }
+                }
+            }
+        }
+        voxel.neighbors = neighbors;
+        voxel.nearX = sx; voxel.nearY = sy; voxel.nearZ = sz;
+        sum += neighbors;
+        sumSq += static_cast<double>(neighbors) * neighbors;
+    }
+
+    double threshold = config_.minNeighbors;
+    if (config_.stddevMultiplier > 0.0f && !voxels_.empty()) {
+        double n = static_cast<double>(voxels_.size());
+        double mean = sum / n;
+        double stddev = std::sqrt(std::max(sumSq / n - mean * mean, 0.0));
+        threshold = std::max(threshold, mean - config_.stddevMultiplier * stddev);
+    }
+
+    // Centroids over the front of the array (never past the points already read)
+    size_t kept = 0;
+    size_t outliers = 0;
+    for (const Voxel& voxel : voxels_) {
+        if (voxel.neighbors < threshold) {
+            outliers += voxel.count;
+            continue;
+        }
+        float invCount = 1.0f / static_cast<float>(voxel.neighbors);
+        points[kept++] = { voxel.nearX * invCount, voxel.nearY * invCount, voxel.nearZ * invCount };
+    }
+
+    stats_.pointsOut += kept;
+    stats_.outliersRemoved += outliers;
+
+    // Steer the voxel size towards the target ratio. Voxels (before outlier
+    // rejection, which depends on voxel size the other way) scale with
+    // roughly 1 / voxelSize^2 on surfaces. Limited to 2x per scan.
+    if (config_.reductionFactor > 0.0f && !voxels_.empty()) {
+        float achieved = static_cast<float>(count) / static_cast<float>(voxels_.size());
+        float step = std::min(std::max(std::sqrt(config_.reductionFactor / achieved), 0.5f), 2.0f);
+        voxelSize_ = std::min(std::max(voxelSize_ * step, config_.minVoxelSize), config_.maxVoxelSize);
+    }
+    return kept;
+}
@@ -0,0 +1,329 @@
+#include "point_renderer.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+const char* VERTEX_SHADER = R"(#version 410 core
+layout(location = 0) in vec3 position;
+uniform mat4 viewProjection;
+uniform float pointSize;
+out float height;
+void main() {
+    gl_Position = viewProjection * vec4(position, 1.0);
+    gl_PointSize = pointSize;
+    height = position.y;
+}
+)";
+
+const char* FRAGMENT_SHADER = R"(#version 410 core
+uniform vec3 color;
+in float height;
+out vec4 fragColor;
+void main() {
+    float shade = clamp(0.6 + height * 0.02, 0.3, 1.0);
+    fragColor = vec4(color * shade, 1.0);
+}
+)";
+
+const GLbitfield MAP_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (ok != GL_TRUE) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::cerr << "Error compiling point shader: " << log << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+} // namespace
+
+PointRenderer::RoverRing::RoverRing(uint32_t id, const glm::vec3& rgb)
+    : roverId(id), color(rgb), vao(0), buffer(0), mapped(nullptr), written(0) {
+}
+
+PointRenderer::RoverRing::~RoverRing() {
+    if (mapped != nullptr) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    if (buffer != 0) {
+        glDeleteBuffers(1, &buffer);
+    }
+    if (vao != 0) {
+        glDeleteVertexArrays(1, &vao);
+    }
+}
+
+PointRenderer::PointRenderer() : PointRenderer(Config()) {
+}
+
+PointRenderer::PointRenderer(const Config& config)
+    : config_(config),
+      persistent_(false),
+      segmentPoints_(0),
+      program_(0),
+      viewProjectionLocation_(-1),
+      colorLocation_(-1),
+      pointSizeLocation_(-1),
+      frame_(1),
+      completedFrame_(0) {
+    config_.segments = std::max<uint32_t>(config_.segments, 2);
+    config_.framesInFlight = std::max<uint32_t>(config_.framesInFlight, 1);
+    segmentPoints_ = std::max<size_t>(config_.pointsPerRover / config_.segments, 1);
+    config_.pointsPerRover = segmentPoints_ * config_.segments;
+    fences_.assign(config_.framesInFlight, nullptr);
+}
+
+PointRenderer::~PointRenderer() {
+    // Rings may still be read by queued draws
+    if (frame_ > 1) {
+        waitForFrame(frame_ - 1);
+    }
+    rovers_.clear();
+    if (program_ != 0) {
+        glDeleteProgram(program_);
+    }
+}
+
+bool PointRenderer::initialize() {
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, VERTEX_SHADER);
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, FRAGMENT_SHADER);
+    if (vertexShader == 0 || fragmentShader == 0) {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return false;
+    }
+
+    program_ = glCreateProgram();
+    glAttachShader(program_, vertexShader);
+    glAttachShader(program_, fragmentShader);
+    glLinkProgram(program_);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint ok = GL_FALSE;
+    glGetProgramiv(program_, GL_LINK_STATUS, &ok);
+    if (ok != GL_TRUE) {
+        char log[1024];
+        glGetProgramInfoLog(program_, sizeof(log), nullptr, log);
+        std::cerr << "Error linking point shader: " << log << std::endl;
+        glDeleteProgram(program_);
+        program_ = 0;
+        return false;
+    }
+
+    viewProjectionLocation_ = glGetUniformLocation(program_, "viewProjection");
+    colorLocation_ = glGetUniformLocation(program_, "color");
+    pointSizeLocation_ = glGetUniformLocation(program_, "pointSize");
+    glEnable(GL_PROGRAM_POINT_SIZE);
+
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    persistent_ = major > 4 || (major == 4 && minor >= 4);
+    return true;
+}
+
+bool PointRenderer::addRover(uint32_t roverId, const glm::vec3& color) {
+    if (findRover(roverId) != nullptr) {
+        return false;
+    }
+
+    auto ring = std::make_unique<RoverRing>(roverId, color);
+    ring->lastDrawn.assign(config_.segments, 0);
+    GLsizeiptr bytes = static_cast<GLsizeiptr>(config_.pointsPerRover * sizeof(glm::vec3));
+
+    glGenVertexArrays(1, &ring->vao);
+    glBindVertexArray(ring->vao);
+    glGenBuffers(1, &ring->buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, ring->buffer);
+    if (persistent_) {
+        glBufferStorage(GL_ARRAY_BUFFER, bytes, nullptr, MAP_FLAGS);
+        ring->mapped = static_cast<glm::vec3*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, MAP_FLAGS));
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_DYNAMIC_DRAW);
+    }
+    GLenum error = glGetError();
+    bool created = persistent_ ? ring->mapped != nullptr : error == GL_NO_ERROR;
+    if (created) {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
+        glEnableVertexAttribArray(0);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (!created) {
+        std::cerr << "Error: cannot create " << (persistent_ ? "persistent " : "")
+                  << "point buffer for rover " << roverId
+                  << " (" << bytes / (1024 * 1024) << " MB, GL error 0x" << std::hex << error
+                  << std::dec << ")" << std::endl;
+        return false;
+    }
+
+    if (roverId >= byRover_.size()) {
+        byRover_.resize(roverId + 1, nullptr);
+    }
+    byRover_[roverId] = ring.get();
+    rovers_.push_back(std::move(ring));
+    return true;
+}
+
+void PointRenderer::beginFrame() {
+    current_ = FrameStats();
+}
+
+size_t PointRenderer::append(uint32_t roverId, const glm::vec3* points, size_t count) {
+    RoverRing* ring = findRover(roverId);
+    if (ring == nullptr || count == 0) {
+        return 0;
+    }
+
+    const size_t capacity = config_.pointsPerRover;
+    if (!persistent_) {
+        glBindBuffer(GL_ARRAY_BUFFER, ring->buffer);
+    }
+    size_t remaining = count;
+    while (remaining > 0) {
+        size_t position = static_cast<size_t>(ring->written % capacity);
+        size_t offset = position % segmentPoints_;
+
+        // Entering a segment: the GPU must be done with its old points
+        // (glBufferSubData is ordered after earlier draws by the driver)
+        if (offset == 0 && persistent_) {
+            uint64_t lastDrawn = ring->lastDrawn[position / segmentPoints_];
+            if (lastDrawn > completedFrame_) {
+                waitForFrame(lastDrawn);
+            }
+        }
+
+        size_t batch = std::min(remaining, segmentPoints_ - offset);
+        if (persistent_) {
+            std::memcpy(ring->mapped + position, points, batch * sizeof(glm::vec3));
+        } else {
+            glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(position * sizeof(glm::vec3)),
+                            static_cast<GLsizeiptr>(batch * sizeof(glm::vec3)), points);
+        }
+        if (ring->written >= capacity) {
+            current_.pointsOverwritten += batch;
+        }
+        ring->written += batch;
+        points += batch;
+        remaining -= batch;
+    }
+    if (!persistent_) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    current_.pointsUploaded += count;
+    current_.uploadBytes += count * sizeof(glm::vec3);
+    return count;
+}
+
+size_t PointRenderer::visibleCount(const RoverRing& ring) const {
+    // Everything from two segments past the head's segment start, i.e.
+    // all but the segment after the head (and the head segment's old tail)
+    uint64_t headSegmentStart = ring.written - ring.written % segmentPoints_;
+    uint64_t start = headSegmentStart + 2 * segmentPoints_;
+    start = start > config_.pointsPerRover ? start - config_.pointsPerRover : 0;
+    return static_cast<size_t>(ring.written - start);
+}
+
+void PointRenderer::draw(const glm::mat4& viewProjection) {
+    const size_t capacity = config_.pointsPerRover;
+
+    glUseProgram(program_);
+    glUniformMatrix4fv(viewProjectionLocation_, 1, GL_FALSE, glm::value_ptr(viewProjection));
+    glUniform1f(pointSizeLocation_, config_.pointSize);
+
+    for (const auto& ring : rovers_) {
+        size_t visible = visibleCount(*ring);
+        if (visible == 0) {
+            continue;
+        }
+
+        // Visible range [start, written) in ring positions, split where it wraps
+        uint64_t start = ring->written - visible;
+        size_t first = static_cast<size_t>(start % capacity);
+        GLint firsts[2] = {static_cast<GLint>(first), 0};
+        GLsizei counts[2] = {static_cast<GLsizei>(std::min(visible, capacity - first)), 0};
+        counts[1] = static_cast<GLsizei>(visible - static_cast<size_t>(counts[0]));
+
+        glUniform3fv(colorLocation_, 1, glm::value_ptr(ring->color));
+        glBindVertexArray(ring->vao);
+        glMultiDrawArrays(GL_POINTS, firsts, counts, counts[1] > 0 ? 2 : 1);
+
+        for (uint64_t index = start; index < ring->written; index += segmentPoints_) {
+            ring->lastDrawn[(index % capacity) / segmentPoints_] = frame_;
+        }
+        ring->lastDrawn[((ring->written - 1) % capacity) / segmentPoints_] = frame_;
+
+        current_.pointsDrawn += visible;
+        current_.drawCalls++;
+    }
+    glBindVertexArray(0);
+
+    // Reuse the fence slot of frame_ - framesInFlight (bounds GPU lag)
+    GLsync& fence = fences_[frame_ % config_.framesInFlight];
+    if (fence != nullptr) {
+        waitForFrame(frame_ - config_.framesInFlight);
+    }
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    lastFrame_ = current_;
+    lastFrame_.frame = frame_;
+    frame_++;
+}
+
+void PointRenderer::clear() {
+    if (frame_ > 1) {
+        waitForFrame(frame_ - 1);
+    }
+    for (const auto& ring : rovers_) {
+        ring->written = 0;
+    }
+}
+
+size_t PointRenderer::getTotalPoints() const {
+    size_t total = 0;
+    for (const auto& ring : rovers_) {
+        total += static_cast<size_t>(std::min<uint64_t>(ring->written, config_.pointsPerRover));
+    }
+    return total;
+}
+
+void PointRenderer::waitForFrame(uint64_t frame) {
+    for (uint64_t f = completedFrame_ + 1; f <= frame; ++f) {
+        GLsync& fence = fences_[f % config_.framesInFlight];
+        if (fence == nullptr) {
+            continue;
+        }
+
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+            auto start = std::chrono::steady_clock::now();
+            current_.fenceWaits++;
+            do {
+                result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);   // 1 ms
+            } while (result == GL_TIMEOUT_EXPIRED);
+            current_.fenceWaitMs += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+    completedFrame_ = std::max(completedFrame_, frame);
+}
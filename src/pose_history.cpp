@@ -0,0 +1,110 @@
+#include "pose_history.h"
+#include "transform.h"
+#include <glm/gtc/matrix_transform.hpp>
+
+PoseHistory::PoseHistory(size_t capacity)
+    : entries_(capacity > 0 ? capacity : 1), head_(0), count_(0), outOfOrderPoses_(0) {
+}
+
+void PoseHistory::addPose(const PosePacket& pose) {
+    // Same rotation convention as the rest of the pipeline
+    glm::mat4 matrix = Transform::poseToMatrix(pose);
+
+    Entry entry;
+    entry.timestamp = pose.timestamp;
+    entry.position = Transform::getPosition(matrix);
+    entry.rotation = glm::quat_cast(matrix);
+
+    // Usual case: newer than everything stored
+    if (count_ == 0 || pose.timestamp > at(count_ - 1).timestamp) {
+        if (count_ < entries_.size()) {
+            at(count_) = entry;
+            count_++;
+        } else {
+            entries_[head_] = entry;
+            head_ = (head_ + 1) % entries_.size();
+        }
+        return;
+    }
+
+    size_t pos = upperBound(pose.timestamp);
+    if (pos > 0 && at(pos - 1).timestamp == pose.timestamp) {
+        at(pos - 1) = entry;   // Repeated timestamp
+        return;
+    }
+
+    outOfOrderPoses_++;
+    if (count_ == entries_.size()) {
+        if (pos == 0) return;   // Older than the whole history
+        head_ = (head_ + 1) % entries_.size();
+        count_--;
+        pos--;
+    }
+
+    // Shift newer poses up by one (reordering is shallow, so this is short)
+    for (size_t i = count_; i > pos; --i) {
+        at(i) = at(i - 1);
+    }
+    at(pos) = entry;
+    count_++;
+}
+
+PoseMatch PoseHistory::lookup(double timestamp, glm::vec3& position, glm::quat& rotation) const {
+    if (count_ == 0) {
+        return PoseMatch::None;
+    }
+
+    const Entry& newest = at(count_ - 1);
+    if (timestamp >= newest.timestamp) {
+        position = newest.position;
+        rotation = newest.rotation;
+        return timestamp == newest.timestamp ? PoseMatch::Interpolated : PoseMatch::HeldNewest;
+    }
+
+    // Just behind the newest pose needs no search
+    size_t upper;
+    if (count_ >= 2 && timestamp >= at(count_ - 2).timestamp) {
+        upper = count_ - 1;
+    } else {
+        upper = upperBound(timestamp);
+    }
+
+    if (upper == 0) {
+        const Entry& oldest = at(0);
+        position = oldest.position;
+        rotation = oldest.rotation;
+        return PoseMatch::HeldOldest;
+    }
+
+    const Entry& before = at(upper - 1);
+    const Entry& after = at(upper);
+    float t = static_cast<float>((timestamp - before.timestamp) / (after.timestamp - before.timestamp));
+
+    position = glm::mix(before.position, after.position, t);
+    rotation = glm::slerp(before.rotation, after.rotation, t);
+    return PoseMatch::Interpolated;
+}
+
+PoseMatch PoseHistory::lookup(double timestamp, glm::mat4& transform) const {
+    glm::vec3 position;
+    glm::quat rotation;
+    PoseMatch match = lookup(timestamp, position, rotation);
+    if (match != PoseMatch::None) {
+        transform = glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation);
+    }
+    return match;
+}
+
+size_t PoseHistory::upperBound(double timestamp) const {
+    size_t low = 0;
+    size_t high = count_;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (at(mid).timestamp <= timestamp) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
@@ -0,0 +1,104 @@
+#include "rover_state.h"
+#include "transform.h"
+
+RoverStateBuffer::RoverStateBuffer(IngestHandler* downstream) : downstream_(downstream) {
+}
+
+bool RoverStateBuffer::addRover(uint32_t roverId) {
+    if (findRover(roverId) != nullptr) {
+        return false;
+    }
+
+    rovers_.push_back(std::make_unique<Rover>(roverId));
+    if (roverId >= byRover_.size()) {
+        byRover_.resize(roverId + 1, nullptr);
+    }
+    byRover_[roverId] = rovers_.back().get();
+    return true;
+}
+
+void RoverStateBuffer::onPose(uint32_t roverId, const PosePacket& pose, uint64_t arrivalNs) {
+    Rover* rover = findRover(roverId);
+    if (rover != nullptr) {
+        VehicleState& state = rover->latestVehicle;
+        state.hasPose = true;
+        state.pose = Transform::poseToMatrix(pose);
+        state.poseTimestamp = pose.timestamp;
+        state.poseArrivalNs = arrivalNs;
+        state.updates++;
+        rover->vehicle.publish(state);
+    }
+    if (downstream_ != nullptr) {
+        downstream_->onPose(roverId, pose, arrivalNs);
+    }
+}
+
+void RoverStateBuffer::onLidar(uint32_t roverId, const LidarPacket& packet, uint64_t arrivalNs) {
+    if (downstream_ != nullptr) {
+        downstream_->onLidar(roverId, packet, arrivalNs);
+    }
+}
+
+void RoverStateBuffer::onTelemetry(uint32_t roverId, const VehicleTelem& telem, uint64_t arrivalNs) {
+    Rover* rover = findRover(roverId);
+    if (rover != nullptr) {
+        VehicleState& state = rover->latestVehicle;
+        state.hasTelemetry = true;
+        state.buttonStates = telem.buttonStates;
+        state.telemTimestamp = telem.timestamp;
+        state.updates++;
+        rover->vehicle.publish(state);
+    }
+    if (downstream_ != nullptr) {
+        downstream_->onTelemetry(roverId, telem, arrivalNs);
+    }
+}
+
+bool RoverStateBuffer::publishScan(uint32_t roverId, const ScanHandle& scan) {
+    Rover* rover = findRover(roverId);
+    if (rover == nullptr) {
+        return false;
+    }
+
+    // The back copy may still hold the scan from two publishes ago; the
+    // assignment releases it here, on the processing thread
+    ScanState& back = rover->scan.back();
+    back.scan = scan;
+    back.updates = ++rover->scansPublished;
+    rover->scan.publish();
+    return true;
+}
+
+bool RoverStateBuffer::getSnapshot(uint32_t roverId, RoverSnapshot& snapshot) {
+    Rover* rover = findRover(roverId);
+    if (rover == nullptr) {
+        return false;
+    }
+
+    rover->vehicle.update();
+    rover->scan.update();
+    const VehicleState& vehicle = rover->vehicle.front();
+    const ScanState& scan = rover->scan.front();
+
+    snapshot.roverId = roverId;
+    snapshot.hasPose = vehicle.hasPose;
+    snapshot.pose = vehicle.pose;
+    snapshot.poseTimestamp = vehicle.poseTimestamp;
+    snapshot.poseArrivalNs = vehicle.poseArrivalNs;
+    snapshot.hasTelemetry = vehicle.hasTelemetry;
+    snapshot.buttonStates = vehicle.buttonStates;
+    snapshot.telemTimestamp = vehicle.telemTimestamp;
+    snapshot.vehicleUpdates = vehicle.updates;
+    snapshot.scanUpdates = scan.updates;
+    snapshot.scan = scan.scan;
+    return true;
+}
+
+std::vector<uint32_t> RoverStateBuffer::getRoverIds() const {
+    std::vector<uint32_t> ids;
+    ids.reserve(rovers_.size());
+    for (const auto& rover : rovers_) {
+        ids.push_back(rover->roverId);
+    }
+    return ids;
+}
@@ -0,0 +1,107 @@
+#include "scan_arena.h"
+#include <cstring>
+
+ScanArena::ScanArena(size_t slotCount, uint32_t maxChunksPerScan, bool storePoints)
+    : maxChunksPerScan_(maxChunksPerScan > 0 ? maxChunksPerScan : 1),
+      pointsPerSlot_(static_cast<size_t>(maxChunksPerScan_) * MAX_LIDAR_POINTS_PER_PACKET),
+      bitmapWords_((maxChunksPerScan_ + 63) / 64),
+      points_(storePoints ? slotCount * pointsPerSlot_ : 0),
+      bitmaps_(slotCount * bitmapWords_, 0),
+      chunkCounts_(slotCount * maxChunksPerScan_, 0),
+      infos_(slotCount),
+      refCounts_(std::make_unique<std::atomic<uint32_t>[]>(slotCount)) {
+    freeSlots_.reserve(slotCount);
+
+    // Hand out low slots first
+    for (size_t i = slotCount; i > 0; --i) {
+        refCounts_[i - 1].store(0, std::memory_order_relaxed);
+        freeSlots_.push_back(static_cast<uint32_t>(i - 1));
+    }
+}
+
+uint32_t ScanArena::acquire() {
+    uint32_t slot;
+    {
+        std::lock_guard<std::mutex> lock(freeMutex_);
+        if (freeSlots_.empty()) {
+            return INVALID_SLOT;
+        }
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    }
+
+    // Only the bitmap and info need clearing; points are overwritten by chunks
+    memset(chunkBitmap(slot), 0, bitmapWords_ * sizeof(uint64_t));
+    infos_[slot] = ScanInfo();
+    refCounts_[slot].store(1, std::memory_order_relaxed);
+    return slot;
+}
+
+void ScanArena::addRef(uint32_t slot) noexcept {
+    refCounts_[slot].fetch_add(1, std::memory_order_relaxed);
+}
+
+void ScanArena::release(uint32_t slot) {
+    // acq_rel: the last releaser must see every write made through the slot
+    if (refCounts_[slot].fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(freeMutex_);
+    freeSlots_.push_back(slot);
+}
+
+size_t ScanArena::getFreeSlotCount() const {
+    std::lock_guard<std::mutex> lock(freeMutex_);
+    return freeSlots_.size();
+}
+
+size_t ScanArena::getMemoryBytes() const {
+    return points_.size() * sizeof(LidarPoint)
+         + bitmaps_.size() * sizeof(uint64_t)
+         + chunkCounts_.size() * sizeof(uint16_t)
+         + infos_.size() * (sizeof(ScanInfo) + sizeof(std::atomic<uint32_t>));
+}
+
+ScanHandle::ScanHandle(const ScanHandle& other)
+    : arena_(other.arena_), slot_(other.slot_) {
+    if (arena_) {
+        arena_->addRef(slot_);
+    }
+}
+
+ScanHandle& ScanHandle::operator=(const ScanHandle& other) {
+    if (this != &other) {
+        // Take the new reference before dropping ours (same slot is fine)
+        if (other.arena_) {
+            other.arena_->addRef(other.slot_);
+        }
+        reset();
+        arena_ = other.arena_;
+        slot_ = other.slot_;
+    }
+    return *this;
+}
+
+ScanHandle::ScanHandle(ScanHandle&& other) noexcept
+    : arena_(std::move(other.arena_)), slot_(other.slot_) {
+    other.slot_ = ScanArena::INVALID_SLOT;
+}
+
+ScanHandle& ScanHandle::operator=(ScanHandle&& other) noexcept {
+    if (this != &other) {
+        reset();
+        arena_ = std::move(other.arena_);
+        slot_ = other.slot_;
+        other.slot_ = ScanArena::INVALID_SLOT;
+    }
+    return *this;
+}
+
+void ScanHandle::reset() {
+    if (arena_) {
+        arena_->release(slot_);
+        arena_.reset();
+    }
+    slot_ = ScanArena::INVALID_SLOT;
+}
@@ -0,0 +1,103 @@
+#include "telemetry_monitor.h"
+#include "latency_stats.h"
+
+// Link timers: 10 ms buckets, 2.56 s per revolution
+static const size_t LINK_WHEEL_SLOTS = 256;
+static const uint64_t LINK_TICK_NS = 10000000;
+
+const uint32_t TelemetryMonitor::NO_SLOT;
+
+TelemetryMonitor::TelemetryMonitor(IngestHandler* downstream) : TelemetryMonitor(downstream, Config()) {
+}
+
+TelemetryMonitor::TelemetryMonitor(IngestHandler* downstream, const Config& config)
+    : downstream_(downstream),
+      config_(config),
+      timeoutNs_(static_cast<uint64_t>(config.staleTimeoutMs * 1e6)),
+      linkTimers_(config.maxRovers, LINK_WHEEL_SLOTS, LINK_TICK_NS),
+      linksUp_(0) {
+    roverIds_.reserve(config_.maxRovers);
+    buttons_.reserve(config_.maxRovers);
+    linkUp_.reserve(config_.maxRovers);
+    lastSeenNs_.reserve(config_.maxRovers);
+}
+
+bool TelemetryMonitor::addRover(uint32_t roverId) {
+    if (findSlot(roverId) != NO_SLOT || roverIds_.size() >= config_.maxRovers) {
+        return false;
+    }
+
+    if (roverId >= slotOfRover_.size()) {
+        slotOfRover_.resize(roverId + 1, NO_SLOT);
+    }
+    slotOfRover_[roverId] = static_cast<uint32_t>(roverIds_.size());
+    roverIds_.push_back(roverId);
+    buttons_.push_back(0);
+    linkUp_.push_back(0);
+    lastSeenNs_.push_back(0);
+    return true;
+}
+
+void TelemetryMonitor::onPose(uint32_t roverId, const PosePacket& pose, uint64_t arrivalNs) {
+    if (downstream_ != nullptr) {
+        downstream_->onPose(roverId, pose, arrivalNs);
+    }
+}
+
+void TelemetryMonitor::onLidar(uint32_t roverId, const LidarPacket& packet, uint64_t arrivalNs) {
+    if (downstream_ != nullptr) {
+        downstream_->onLidar(roverId, packet, arrivalNs);
+    }
+}
+
+void TelemetryMonitor::onTelemetry(uint32_t roverId, const VehicleTelem& telem, uint64_t arrivalNs) {
+    uint32_t slot = findSlot(roverId);
+    if (slot == NO_SLOT) {
+        stats_.unknownRoverPackets++;
+    } else {
+        stats_.packets++;
+        uint64_t now = steadyNowNs();
+        linkTimers_.schedule(slot, now + timeoutNs_);
+
+        if (linkUp_[slot] == 0) {
+            if (lastSeenNs_[slot] != 0) {
+                stats_.linksRestored++;
+            }
+            linkUp_[slot] = 1;
+            linksUp_++;
+            for (TelemetryListener* listener : listeners_) {
+                listener->onLinkUp(roverId);
+            }
+        }
+        lastSeenNs_[slot] = now;
+
+        uint8_t previous = buttons_[slot];
+        if (telem.buttonStates != previous) {
+            buttons_[slot] = telem.buttonStates;
+            stats_.buttonChanges++;
+            for (TelemetryListener* listener : listeners_) {
+                listener->onButtonsChanged(roverId, previous, telem.buttonStates, arrivalNs);
+            }
+        }
+    }
+
+    if (downstream_ != nullptr) {
+        downstream_->onTelemetry(roverId, telem, arrivalNs);
+    }
+}
+
+void TelemetryMonitor::poll() {
+    checkLinks(steadyNowNs());
+}
+
+void TelemetryMonitor::checkLinks(uint64_t nowNs) {
+    // Only buckets elapsed since the last call are visited
+    linkTimers_.advance(nowNs, [this, nowNs](uint32_t slot) {
+        linkUp_[slot] = 0;
+        linksUp_--;
+        stats_.linksLost++;
+        for (TelemetryListener* listener : listeners_) {
+            listener->onLinkLost(roverIds_[slot], nowNs - lastSeenNs_[slot]);
+        }
+    });
+}
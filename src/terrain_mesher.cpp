@@ -0,0 +1,375 @@
+#include "terrain_mesher.h"
+#include "latency_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <pthread.h>
+
+const uint32_t TerrainMesher::FLOATS_PER_VERTEX;
+const uint32_t TerrainMesher::LOD_LEVELS;
+
+TerrainMesher::TerrainMesher(HeightMap& map) : TerrainMesher(map, Config()) {
+}
+
+TerrainMesher::TerrainMesher(HeightMap& map, const Config& config)
+    : map_(map),
+      config_(config),
+      pendingMark_(map.getTileCount(), 0),
+      frameCounter_(0),
+      jobCount_(0),
+      frameStartNs_(0),
+      nextJob_(0),
+      workersDone_(0),
+      frameTriangles_(0),
+      frameVertices_(0),
+      busy_(false),
+      readyFull_(false),
+      frameSeq_(0),
+      stopRequested_(false),
+      running_(false),
+      framesMeshed_(0),
+      framesSkipped_(0),
+      tilesRebuilt_(0),
+      trianglesEmitted_(0) {
+    if (config_.workerCount == 0) config_.workerCount = 1;
+    dirty_.reserve(map.getTileCount());
+    pending_.reserve(map.getTileCount());
+}
+
+TerrainMesher::~TerrainMesher() {
+    stop();
+}
+
+void TerrainMesher::start() {
+    if (running_) return;
+
+    stopRequested_ = false;
+    for (unsigned i = 0; i < config_.workerCount; ++i) {
+        workers_.emplace_back(&TerrainMesher::workerLoop, this, i);
+    }
+    running_ = true;
+}
+
+void TerrainMesher::stop() {
+    if (!running_) return;
+
+    // Let the frame in flight finish so workers never exit mid-frame
+    waitIdle();
+    {
+        std::lock_guard<std::mutex> lock(workMutex_);
+        stopRequested_ = true;
+    }
+    workCond_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    running_ = false;
+}
+
+void TerrainMesher::queueTile(int32_t tileX, int32_t tileY) {
+    const HeightMap::Tile* tile = map_.getTile(tileX, tileY);
+    if (tile == nullptr) {
+        return;
+    }
+    uint32_t index = static_cast<uint32_t>(tileY) * map_.getTilesPerSide() + static_cast<uint32_t>(tileX);
+    if (!pendingMark_[index]) {
+        pendingMark_[index] = 1;
+        pending_.push_back(index);
+    }
+}
+
+size_t TerrainMesher::beginFrame() {
+    if (!running_ || busy_.load(std::memory_order_acquire)) {
+        framesSkipped_.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(readyMutex_);
+        if (readyFull_) {
+            framesSkipped_.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        }
+    }
+
+    uint64_t startNs = steadyNowNs();
+
+    // A changed tile also changes the seam quads of its -x/-y neighbours
+    map_.takeDirtyTiles(dirty_);
+    // (coordinates from the index: with a tile store, looking up neighbours
+    // may evict the tile itself)
+    const int32_t tilesPerSide = static_cast<int32_t>(map_.getTilesPerSide());
+    for (uint32_t index : dirty_) {
+        const int32_t tileX = static_cast<int32_t>(index) % tilesPerSide;
+        const int32_t tileY = static_cast<int32_t>(index) / tilesPerSide;
+        queueTile(tileX, tileY);
+        queueTile(tileX - 1, tileY);
+        queueTile(tileX, tileY - 1);
+        queueTile(tileX - 1, tileY - 1);
+    }
+    if (pending_.empty()) {
+        return 0;
+    }
+
+    size_t count = pending_.size();
+    if (config_.maxTilesPerFrame > 0) {
+        count = std::min(count, config_.maxTilesPerFrame);
+    }
+
+    // Jobs keep their snapshot buffers between frames
+    if (jobs_.size() < count) {
+        jobs_.resize(count);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        pendingMark_[pending_[i]] = 0;
+        snapshot(*map_.getTile(pending_[i]), jobs_[i]);
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(count));
+
+    building_.tiles.resize(count);
+    building_.stats = FrameStats();
+    building_.stats.frame = ++frameCounter_;
+    building_.stats.tilesRebuilt = count;
+    building_.stats.tilesDeferred = pending_.size();
+    building_.stats.snapshotMs = static_cast<double>(steadyNowNs() - startNs) / 1e6;
+    frameStartNs_ = startNs;
+    frameTriangles_.store(0, std::memory_order_relaxed);
+    frameVertices_.store(0, std::memory_order_relaxed);
+    busy_.store(true, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(workMutex_);
+        jobCount_ = count;
+        nextJob_.store(0, std::memory_order_relaxed);
+        workersDone_.store(0, std::memory_order_relaxed);
+        frameSeq_++;
+    }
+    workCond_.notify_all();
+    return count;
+}
+
+void TerrainMesher::snapshot(const HeightMap::Tile& tile, Job& job) const {
+    const uint32_t tileCells = map_.getConfig().tileCells;
+    const uint32_t side = tileCells + 1;
+
+    job.tileIndex = static_cast<uint32_t>(tile.tileY) * map_.getTilesPerSide() + static_cast<uint32_t>(tile.tileX);
+    job.version = tile.version;
+    job.origin = map_.tileOrigin(tile);
+    job.cells.resize(static_cast<size_t>(side) * side);
+
+    HeightMap::Cell* out = job.cells.data();
+    for (uint32_t y = 0; y < tileCells; ++y) {
+        std::copy(&tile.cells[y * tileCells], &tile.cells[y * tileCells] + tileCells, out + y * side);
+    }
+
+    // Border: first column of the +x tile, first row of the +y tile, corner of +x+y.
+    // Each neighbour is copied before the next is fetched (fetching may page
+    // tiles in and out, including this one).
+    const int32_t tileX = tile.tileX, tileY = tile.tileY;
+    const HeightMap::Cell empty = {};
+    const HeightMap::Tile* east = map_.getTile(tileX + 1, tileY);
+    for (uint32_t y = 0; y < tileCells; ++y) {
+        out[y * side + tileCells] = east ? east->cells[y * tileCells] : empty;
+    }
+    const HeightMap::Tile* north = map_.getTile(tileX, tileY + 1);
+    for (uint32_t x = 0; x < tileCells; ++x) {
+        out[tileCells * side + x] = north ? north->cells[x] : empty;
+    }
+    const HeightMap::Tile* corner = map_.getTile(tileX + 1, tileY + 1);
+    out[tileCells * side + tileCells] = corner ? corner->cells[0] : empty;
+}
+
+void TerrainMesher::meshTile(const Job& job, TileMesh& mesh, std::vector<int32_t>& remap) const {
+    const HeightMap::Config& mapConfig = map_.getConfig();
+    const uint32_t tileCells = mapConfig.tileCells;
+    const int32_t side = static_cast<int32_t>(tileCells + 1);
+    const float cellSize = mapConfig.cellSize;
+    const bool yUp = mapConfig.upAxis == HeightMap::UpAxis::Y;
+    const HeightMap::Cell* cells = job.cells.data();
+
+    mesh.tileIndex = job.tileIndex;
+    mesh.version = job.version;
+    mesh.vertices.clear();
+    mesh.indices.clear();
+    mesh.lodIndices.clear();
+    mesh.boundsMin = glm::vec3(std::numeric_limits<float>::max());
+    mesh.boundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+    remap.assign(job.cells.size(), -1);
+
+    auto observed = [&](int32_t x, int32_t y) {
+        return x >= 0 && y >= 0 && x < side && y < side && cells[y * side + x].hits > 0;
+    };
+
+    // Vertex at a cell centre, emitted the first time a quad uses it
+    auto vertex = [&](int32_t x, int32_t y) -> uint32_t {
+        int32_t& id = remap[static_cast<size_t>(y * side + x)];
+        if (id >= 0) {
+            return static_cast<uint32_t>(id);
+        }
+        id = static_cast<int32_t>(mesh.vertices.size() / FLOATS_PER_VERTEX);
+
+        float h = cells[y * side + x].meanHeight;
+        float gx = job.origin.x + (static_cast<float>(x) + 0.5f) * cellSize;
+        float gy = job.origin.y + (static_cast<float>(y) + 0.5f) * cellSize;
+
+        // Slope by central differences where neighbours exist (one-sided at holes)
+        int32_t x0 = observed(x - 1, y) ? x - 1 : x, x1 = observed(x + 1, y) ? x + 1 : x;
+        int32_t y0 = observed(x, y - 1) ? y - 1 : y, y1 = observed(x, y + 1) ? y + 1 : y;
+        float dx = x1 > x0 ? (cells[y * side + x1].meanHeight - cells[y * side + x0].meanHeight) /
+                             (static_cast<float>(x1 - x0) * cellSize) : 0.0f;
+        float dy = y1 > y0 ? (cells[y1 * side + x].meanHeight - cells[y0 * side + x].meanHeight) /
+                             (static_cast<float>(y1 - y0) * cellSize) : 0.0f;
+        glm::vec3 n = glm::normalize(yUp ? glm::vec3(-dx, 1.0f, -dy) : glm::vec3(-dx, -dy, 1.0f));
+
+        glm::vec3 position = yUp ? glm::vec3(gx, h, gy) : glm::vec3(gx, gy, h);
+        mesh.vertices.insert(mesh.vertices.end(), {position.x, position.y, position.z, n.x, n.y, n.z});
+        mesh.boundsMin = glm::min(mesh.boundsMin, position);
+        mesh.boundsMax = glm::max(mesh.boundsMax, position);
+        return static_cast<uint32_t>(id);
+    };
+
+    // Two triangles per quad of four observed cells. Ground (x, y) maps to
+    // world (X, Z) with Y up but (X, Y) with Z up, which mirrors the winding.
+    for (int32_t y = 0; y < side - 1; ++y) {
+        for (int32_t x = 0; x < side - 1; ++x) {
+            if (!observed(x, y) || !observed(x + 1, y) || !observed(x, y + 1) || !observed(x + 1, y + 1)) {
+                continue;
+            }
+            uint32_t a = vertex(x, y), b = vertex(x + 1, y);
+            uint32_t c = vertex(x, y + 1), d = vertex(x + 1, y + 1);
+            if (yUp) {
+                mesh.indices.insert(mesh.indices.end(), {a, c, b, b, c, d});
+            } else {
+                mesh.indices.insert(mesh.indices.end(), {a, b, c, b, d, c});
+            }
+        }
+    }
+    mesh.lodIndexCount[0] = static_cast<uint32_t>(mesh.indices.size());
+    mesh.lodError[0] = 0.0f;
+
+    // Coarser levels: the same quads over every stride-th cell. The error of
+    // a quad is the largest distance of an observed cell it covers from the
+    // bilinear surface through its corners.
+    auto height = [&](int32_t x, int32_t y) { return cells[y * side + x].meanHeight; };
+    for (uint32_t level = 1; level < LOD_LEVELS; ++level) {
+        const int32_t stride = 1 << level;
+        const float inverse = 1.0f / static_cast<float>(stride);
+        size_t start = mesh.lodIndices.size();
+        float error = mesh.lodError[level - 1];
+
+        for (int32_t y = 0; y + stride < side; y += stride) {
+            for (int32_t x = 0; x + stride < side; x += stride) {
+                if (!observed(x, y) || !observed(x + stride, y) ||
+                    !observed(x, y + stride) || !observed(x + stride, y + stride)) {
+                    continue;
+                }
+                uint32_t a = vertex(x, y), b = vertex(x + stride, y);
+                uint32_t c = vertex(x, y + stride), d = vertex(x + stride, y + stride);
+                if (yUp) {
+                    mesh.lodIndices.insert(mesh.lodIndices.end(), {a, c, b, b, c, d});
+                } else {
+                    mesh.lodIndices.insert(mesh.lodIndices.end(), {a, b, c, b, d, c});
+                }
+
+                float h00 = height(x, y), h10 = height(x + stride, y);
+                float h01 = height(x, y + stride), h11 = height(x + stride, y + stride);
+                for (int32_t j = 0; j <= stride; ++j) {
+                    float v = static_cast<float>(j) * inverse;
+                    for (int32_t i = 0; i <= stride; ++i) {
+                        if (!observed(x + i, y + j)) {
+                            continue;
+                        }
+                        float u = static_cast<float>(i) * inverse;
+                        float surface = (h00 * (1.0f - u) + h10 * u) * (1.0f - v) + (h01 * (1.0f - u) + h11 * u) * v;
+                        error = std::max(error, std::fabs(height(x + i, y + j) - surface));
+                    }
+                }
+            }
+        }
+        mesh.lodIndexCount[level] = static_cast<uint32_t>(mesh.lodIndices.size() - start);
+        mesh.lodError[level] = error;
+    }
+}
+
+void TerrainMesher::workerLoop(unsigned worker) {
+    std::string name = "mesher-" + std::to_string(worker);
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+
+    std::vector<int32_t> remap;
+    uint64_t seenSeq = 0;
+
+    while (true) {
+        size_t jobCount;
+        {
+            std::unique_lock<std::mutex> lock(workMutex_);
+            workCond_.wait(lock, [&] { return stopRequested_ || frameSeq_ != seenSeq; });
+            if (stopRequested_) {
+                return;
+            }
+            seenSeq = frameSeq_;
+            jobCount = jobCount_;
+        }
+
+        size_t triangles = 0;
+        size_t vertices = 0;
+        for (size_t i = nextJob_.fetch_add(1, std::memory_order_relaxed); i < jobCount;
+             i = nextJob_.fetch_add(1, std::memory_order_relaxed)) {
+            TileMesh& mesh = building_.tiles[i];
+            meshTile(jobs_[i], mesh, remap);
+            triangles += mesh.indices.size() / 3;
+            vertices += mesh.vertices.size() / FLOATS_PER_VERTEX;
+        }
+        frameTriangles_.fetch_add(triangles, std::memory_order_relaxed);
+        frameVertices_.fetch_add(vertices, std::memory_order_relaxed);
+
+        // Every worker passes through every frame; the last one out publishes
+        if (workersDone_.fetch_add(1, std::memory_order_acq_rel) + 1 == config_.workerCount) {
+            publish();
+        }
+    }
+}
+
+void TerrainMesher::publish() {
+    FrameStats& stats = building_.stats;
+    stats.triangles = frameTriangles_.load(std::memory_order_relaxed);
+    stats.vertices = frameVertices_.load(std::memory_order_relaxed);
+    stats.meshingMs = static_cast<double>(steadyNowNs() - frameStartNs_) / 1e6;
+
+    framesMeshed_.fetch_add(1, std::memory_order_relaxed);
+    tilesRebuilt_.fetch_add(stats.tilesRebuilt, std::memory_order_relaxed);
+    trianglesEmitted_.fetch_add(stats.triangles, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(readyMutex_);
+        std::swap(building_, ready_);
+        readyFull_ = true;
+        busy_.store(false, std::memory_order_release);
+    }
+    idleCond_.notify_all();
+}
+
+bool TerrainMesher::takeFrame(MeshFrame& frame) {
+    // Only contended by publish(), which holds the lock for a swap
+    std::lock_guard<std::mutex> lock(readyMutex_);
+    if (!readyFull_) {
+        return false;
+    }
+    std::swap(frame, ready_);
+    readyFull_ = false;
+    return true;
+}
+
+void TerrainMesher::waitIdle() {
+    std::unique_lock<std::mutex> lock(readyMutex_);
+    idleCond_.wait(lock, [&] { return !busy_.load(std::memory_order_acquire); });
+}
+
+TerrainMesher::Stats TerrainMesher::getStats() const {
+    Stats stats;
+    stats.framesMeshed = framesMeshed_.load(std::memory_order_relaxed);
+    stats.framesSkipped = framesSkipped_.load(std::memory_order_relaxed);
+    stats.tilesRebuilt = tilesRebuilt_.load(std::memory_order_relaxed);
+    stats.trianglesEmitted = trianglesEmitted_.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,368 @@
+#include "terrain_renderer.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <cmath>
+
+namespace {
+
+const char* VERTEX_SHADER = R"(#version 410 core
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+uniform mat4 viewProjection;
+uniform vec3 up;
+out vec3 worldNormal;
+out float height;
+void main() {
+    gl_Position = viewProjection * vec4(position, 1.0);
+    worldNormal = normal;
+    height = dot(position, up);
+}
+)";
+
+const char* FRAGMENT_SHADER = R"(#version 410 core
+in vec3 worldNormal;
+in float height;
+uniform vec3 lightDirection;
+out vec4 fragColor;
+void main() {
+    vec3 low = vec3(0.35, 0.3, 0.22);
+    vec3 high = vec3(0.55, 0.6, 0.45);
+    vec3 albedo = mix(low, high, clamp(height * 0.05 + 0.5, 0.0, 1.0));
+    float light = 0.35 + 0.65 * max(dot(normalize(worldNormal), lightDirection), 0.0);
+    fragColor = vec4(albedo * light, 1.0);
+}
+)";
+
+const size_t VERTEX_BYTES = TerrainMesher::FLOATS_PER_VERTEX * sizeof(float);
+
+GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (ok != GL_TRUE) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::cerr << "Error compiling terrain shader: " << log << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+} // namespace
+
+TerrainRenderer::RangeAllocator::RangeAllocator(size_t capacity) : used_(0) {
+    free_.push_back({0, capacity});
+}
+
+bool TerrainRenderer::RangeAllocator::allocate(size_t count, size_t& offset) {
+    for (size_t i = 0; i < free_.size(); ++i) {
+        Range& range = free_[i];
+        if (range.count < count) {
+            continue;
+        }
+        offset = range.offset;
+        range.offset += count;
+        range.count -= count;
+        if (range.count == 0) {
+            free_.erase(free_.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        used_ += count;
+        return true;
+    }
+    return false;
+}
+
+void TerrainRenderer::RangeAllocator::release(size_t offset, size_t count) {
+    auto next = std::lower_bound(free_.begin(), free_.end(), offset,
+                                 [](const Range& range, size_t value) { return range.offset < value; });
+    next = free_.insert(next, {offset, count});
+    used_ -= count;
+
+    // Merge with the following and preceding free ranges
+    auto after = next + 1;
+    if (after != free_.end() && next->offset + next->count == after->offset) {
+        next->count += after->count;
+        free_.erase(after);
+    }
+    if (next != free_.begin()) {
+        auto before = next - 1;
+        if (before->offset + before->count == next->offset) {
+            before->count += next->count;
+            free_.erase(next);
+        }
+    }
+}
+
+TerrainRenderer::TerrainRenderer() : TerrainRenderer(Config()) {
+}
+
+TerrainRenderer::TerrainRenderer(const Config& config)
+    : config_(config),
+      vertexRanges_(config.vertexCapacity),
+      indexRanges_(config.indexCapacity),
+      program_(0),
+      viewProjectionLocation_(-1),
+      vao_(0),
+      vertexBuffer_(0),
+      indexBuffer_(0),
+      commandBuffer_(0),
+      commandCapacity_(0),
+      multiDrawIndirect_(false) {
+}
+
+TerrainRenderer::~TerrainRenderer() {
+    if (commandBuffer_ != 0) glDeleteBuffers(1, &commandBuffer_);
+    if (indexBuffer_ != 0) glDeleteBuffers(1, &indexBuffer_);
+    if (vertexBuffer_ != 0) glDeleteBuffers(1, &vertexBuffer_);
+    if (vao_ != 0) glDeleteVertexArrays(1, &vao_);
+    if (program_ != 0) glDeleteProgram(program_);
+}
+
+bool TerrainRenderer::initialize() {
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, VERTEX_SHADER);
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, FRAGMENT_SHADER);
+    if (vertexShader == 0 || fragmentShader == 0) {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return false;
+    }
+
+    program_ = glCreateProgram();
+    glAttachShader(program_, vertexShader);
+    glAttachShader(program_, fragmentShader);
+    glLinkProgram(program_);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint ok = GL_FALSE;
+    glGetProgramiv(program_, GL_LINK_STATUS, &ok);
+    if (ok != GL_TRUE) {
+        char log[1024];
+        glGetProgramInfoLog(program_, sizeof(log), nullptr, log);
+        std::cerr << "Error linking terrain shader: " << log << std::endl;
+        glDeleteProgram(program_);
+        program_ = 0;
+        return false;
+    }
+    viewProjectionLocation_ = glGetUniformLocation(program_, "viewProjection");
+
+    // Height tint and sun follow the map's up axis (the mesher emits either)
+    bool yUp = config_.upAxis == HeightMap::UpAxis::Y;
+    glm::vec3 up = yUp ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(0.0f, 0.0f, 1.0f);
+    glm::vec3 lightDirection = glm::normalize(yUp ? glm::vec3(0.4f, 1.0f, 0.3f) : glm::vec3(0.4f, 0.3f, 1.0f));
+    glUseProgram(program_);
+    glUniform3fv(glGetUniformLocation(program_, "up"), 1, glm::value_ptr(up));
+    glUniform3fv(glGetUniformLocation(program_, "lightDirection"), 1, glm::value_ptr(lightDirection));
+    glUseProgram(0);
+
+    glGenVertexArrays(1, &vao_);
+    glBindVertexArray(vao_);
+    glGenBuffers(1, &vertexBuffer_);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer_);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(config_.vertexCapacity * VERTEX_BYTES), nullptr, GL_DYNAMIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(VERTEX_BYTES), nullptr);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(VERTEX_BYTES),
+                          reinterpret_cast<const void*>(3 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glGenBuffers(1, &indexBuffer_);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer_);   // Recorded in the VAO
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(config_.indexCapacity * sizeof(uint32_t)),
+                 nullptr, GL_DYNAMIC_DRAW);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenBuffers(1, &commandBuffer_);
+
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    multiDrawIndirect_ = major > 4 || (major == 4 && minor >= 3);
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cerr << "Error: cannot allocate terrain buffers (GL error 0x" << std::hex << error << std::dec
+                  << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void TerrainRenderer::upload(const TerrainMesher::MeshFrame& frame) {
+    for (const TerrainMesher::TileMesh& mesh : frame.tiles) {
+        if (mesh.tileIndex >= slotOfTile_.size()) {
+            slotOfTile_.resize(mesh.tileIndex + 1, -1);
+        }
+        int32_t oldSlot = slotOfTile_[mesh.tileIndex];
+
+        TileSlot slot;
+        slot.tileIndex = mesh.tileIndex;
+        slot.vertexCount = mesh.vertices.size() / TerrainMesher::FLOATS_PER_VERTEX;
+        slot.indexCount = mesh.indices.size() + mesh.lodIndices.size();
+
+        // Release the old ranges first, so a re-meshed tile can reuse its own space
+        if (oldSlot >= 0) {
+            releaseSlot(static_cast<size_t>(oldSlot));
+        }
+        bool placed = false;
+        if (mesh.lodIndexCount[0] > 0 && vertexRanges_.allocate(slot.vertexCount, slot.vertexOffset)) {
+            placed = indexRanges_.allocate(slot.indexCount, slot.indexOffset);
+            if (!placed) {
+                vertexRanges_.release(slot.vertexOffset, slot.vertexCount);
+            }
+        }
+        if (!placed) {
+            stats_.tilesRejected += mesh.lodIndexCount[0] > 0 ? 1 : 0;
+            continue;
+        }
+
+        // Level ranges; a level that would leave holes in the tile is never picked
+        uint32_t first = 0;
+        for (uint32_t level = 0; level < TerrainMesher::LOD_LEVELS; ++level) {
+            slot.levelFirst[level] = first;
+            slot.levelCount[level] = mesh.lodIndexCount[level];
+            float coverage = static_cast<float>(mesh.lodIndexCount[level]) * static_cast<float>(1u << (2 * level)) /
+                             static_cast<float>(mesh.lodIndexCount[0]);
+            slot.levelError[level] = coverage >= config_.minLevelCoverage || level == 0
+                ? mesh.lodError[level] : std::numeric_limits<float>::max();
+            first += mesh.lodIndexCount[level];
+        }
+        slot.boundsMin = mesh.boundsMin;
+        slot.boundsMax = mesh.boundsMax;
+
+        scratch_.assign(mesh.indices.begin(), mesh.indices.end());
+        scratch_.insert(scratch_.end(), mesh.lodIndices.begin(), mesh.lodIndices.end());
+
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer_);
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(slot.vertexOffset * VERTEX_BYTES),
+                        static_cast<GLsizeiptr>(slot.vertexCount * VERTEX_BYTES), mesh.vertices.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(vao_);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>(slot.indexOffset * sizeof(uint32_t)),
+                        static_cast<GLsizeiptr>(scratch_.size() * sizeof(uint32_t)), scratch_.data());
+        glBindVertexArray(0);
+
+        slotOfTile_[mesh.tileIndex] = static_cast<int32_t>(slots_.size());
+        slots_.push_back(slot);
+        stats_.tilesUploaded++;
+        stats_.uploadBytes += slot.vertexCount * VERTEX_BYTES + scratch_.size() * sizeof(uint32_t);
+    }
+    stats_.verticesUsed = vertexRanges_.used();
+    stats_.indicesUsed = indexRanges_.used();
+}
+
+void TerrainRenderer::releaseSlot(size_t slot) {
+    TileSlot& released = slots_[slot];
+    vertexRanges_.release(released.vertexOffset, released.vertexCount);
+    indexRanges_.release(released.indexOffset, released.indexCount);
+    slotOfTile_[released.tileIndex] = -1;
+
+    // Swap-remove: the last slot takes its place
+    if (slot + 1 != slots_.size()) {
+        released = slots_.back();
+        slotOfTile_[released.tileIndex] = static_cast<int32_t>(slot);
+    }
+    slots_.pop_back();
+}
+
+void TerrainRenderer::draw(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& eye,
+                           float viewportHeight) {
+    auto start = std::chrono::steady_clock::now();
+    frameStats_ = FrameStats();
+    frameStats_.tiles = slots_.size();
+
+    // Frustum planes (inward normals) from the rows of the view-projection
+    glm::mat4 viewProjection = projection * view;
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; ++i) {
+        rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    }
+    const glm::vec4 planes[6] = {rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1],
+                                 rows[3] - rows[1], rows[3] + rows[2], rows[3] - rows[2]};
+
+    // Pixels covered by one world unit at distance 1
+    const float pixelsPerUnit = projection[1][1] * viewportHeight * 0.5f;
+
+    commands_.clear();
+    for (const TileSlot& slot : slots_) {
+        bool inside = true;
+        for (const glm::vec4& plane : planes) {
+            // Box corner furthest along the plane normal
+            glm::vec3 corner(plane.x >= 0.0f ? slot.boundsMax.x : slot.boundsMin.x,
+                             plane.y >= 0.0f ? slot.boundsMax.y : slot.boundsMin.y,
+                             plane.z >= 0.0f ? slot.boundsMax.z : slot.boundsMin.z);
+            if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) {
+                inside = false;
+                break;
+            }
+        }
+        if (!inside) {
+            frameStats_.tilesCulled++;
+            continue;
+        }
+
+        // Coarsest level whose error stays under maxPixelError at the box's nearest point
+        float distance = std::max(glm::length(glm::clamp(eye, slot.boundsMin, slot.boundsMax) - eye), 1e-3f);
+        uint32_t level = 0;
+        for (uint32_t candidate = TerrainMesher::LOD_LEVELS - 1; candidate > 0; --candidate) {
+            if (slot.levelCount[candidate] > 0 &&
+                slot.levelError[candidate] * pixelsPerUnit / distance <= config_.maxPixelError) {
+                level = candidate;
+                break;
+            }
+        }
+
+        DrawCommand command;
+        command.count = slot.levelCount[level];
+        command.instanceCount = 1;
+        command.firstIndex = static_cast<GLuint>(slot.indexOffset + slot.levelFirst[level]);
+        command.baseVertex = static_cast<GLint>(slot.vertexOffset);
+        command.baseInstance = 0;
+        commands_.push_back(command);
+
+        frameStats_.tilesPerLevel[level]++;
+        frameStats_.triangles += command.count / 3;
+    }
+    frameStats_.tilesVisible = commands_.size();
+
+    if (!commands_.empty() && multiDrawIndirect_) {
+        // Orphan the command buffer so this frame never waits on the last one
+        size_t bytes = commands_.size() * sizeof(DrawCommand);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer_);
+        commandCapacity_ = std::max(commandCapacity_, commands_.capacity() * sizeof(DrawCommand));
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(commandCapacity_), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, static_cast<GLsizeiptr>(bytes), commands_.data());
+        frameStats_.cullMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        glUseProgram(program_);
+        glUniformMatrix4fv(viewProjectionLocation_, 1, GL_FALSE, glm::value_ptr(viewProjection));
+        glBindVertexArray(vao_);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr,
+                                    static_cast<GLsizei>(commands_.size()), sizeof(DrawCommand));
+        glBindVertexArray(0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        frameStats_.drawCalls = 1;
+    } else if (!commands_.empty()) {
+        frameStats_.cullMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        glUseProgram(program_);
+        glUniformMatrix4fv(viewProjectionLocation_, 1, GL_FALSE, glm::value_ptr(viewProjection));
+        glBindVertexArray(vao_);
+        for (const DrawCommand& command : commands_) {
+            glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(command.count), GL_UNSIGNED_INT,
+                                     reinterpret_cast<const void*>(command.firstIndex * sizeof(uint32_t)),
+                                     command.baseVertex);
+        }
+        glBindVertexArray(0);
+        frameStats_.drawCalls = commands_.size();
+    } else {
+        frameStats_.cullMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
@@ -0,0 +1,155 @@
+#include "tile_store.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+const size_t PAGE = 4096;
+const char MAGIC[8] = {'R', 'V', 'T', 'I', 'L', 'E', 'S', '1'};
+const uint32_t FORMAT_VERSION = 1;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+struct TileStore::FileHeader {
+    char magic[8];
+    uint32_t formatVersion;
+    uint32_t tileCount;
+    uint32_t tileBytes;
+    uint32_t reserved;
+    uint64_t fingerprint;
+    uint64_t dataOffset;
+    uint64_t slotStride;
+};
+
+TileStore::TileStore()
+    : fd_(-1), base_(nullptr), fileBytes_(0), dataOffset_(0), slotStride_(0),
+      entries_(nullptr), resumed_(false) {
+}
+
+TileStore::~TileStore() {
+    close();
+}
+
+bool TileStore::open(const std::string& path, const Layout& layout) {
+    close();
+    static_assert(sizeof(FileHeader) <= PAGE, "header must fit its page");
+    static_assert(sizeof(Entry) == 16, "directory entries are 16 bytes");
+
+    size_t dataOffset = alignUp(PAGE + static_cast<size_t>(layout.tileCount) * sizeof(Entry), PAGE);
+    size_t slotStride = alignUp(layout.tileBytes, PAGE);
+    size_t fileBytes = dataOffset + slotStride * layout.tileCount;
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error opening tile store " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        std::cerr << "Error reading tile store " << path << ": " << strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    // Existing file: the header must describe the same layout
+    bool resumed = st.st_size > 0;
+    if (resumed) {
+        FileHeader header;
+        if (pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+            memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+            header.formatVersion != FORMAT_VERSION ||
+            header.tileCount != layout.tileCount || header.tileBytes != layout.tileBytes ||
+            header.fingerprint != layout.fingerprint ||
+            header.dataOffset != dataOffset || header.slotStride != slotStride ||
+            static_cast<size_t>(st.st_size) != fileBytes) {
+            std::cerr << "Error: tile store " << path << " was created for a different map layout" << std::endl;
+            ::close(fd);
+            return false;
+        }
+    } else if (ftruncate(fd, static_cast<off_t>(fileBytes)) != 0) {   // Sparse: no blocks yet
+        std::cerr << "Error sizing tile store " << path << ": " << strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    void* base = mmap(nullptr, fileBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        std::cerr << "Error mapping tile store " << path << ": " << strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    path_ = path;
+    layout_ = layout;
+    fd_ = fd;
+    base_ = static_cast<uint8_t*>(base);
+    fileBytes_ = fileBytes;
+    dataOffset_ = dataOffset;
+    slotStride_ = slotStride;
+    entries_ = reinterpret_cast<Entry*>(base_ + PAGE);
+    resumed_ = resumed;
+
+    if (!resumed) {
+        FileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.formatVersion = FORMAT_VERSION;
+        header.tileCount = layout.tileCount;
+        header.tileBytes = layout.tileBytes;
+        header.fingerprint = layout.fingerprint;
+        header.dataOffset = dataOffset;
+        header.slotStride = slotStride;
+        memcpy(base_, &header, sizeof(header));
+    }
+    return true;
+}
+
+void TileStore::close() {
+    if (base_ == nullptr) return;
+
+    sync();
+    munmap(base_, fileBytes_);
+    ::close(fd_);
+    fd_ = -1;
+    base_ = nullptr;
+    entries_ = nullptr;
+    fileBytes_ = 0;
+    resumed_ = false;
+}
+
+void TileStore::release(uint32_t index) {
+    // Shared file mapping: dirty pages stay in the page cache for writeback,
+    // only this process's resident copy goes
+    madvise(slot(index), slotStride_, MADV_DONTNEED);
+}
+
+void TileStore::clear() {
+    memset(entries_, 0, static_cast<size_t>(layout_.tileCount) * sizeof(Entry));
+}
+
+bool TileStore::sync() {
+    if (base_ == nullptr) return false;
+    if (msync(base_, fileBytes_, MS_SYNC) != 0) {
+        std::cerr << "Error syncing tile store " << path_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+size_t TileStore::getStoredTiles() const {
+    size_t stored = 0;
+    for (uint32_t i = 0; i < layout_.tileCount; ++i) {
+        stored += entries_[i].present ? 1 : 0;
+    }
+    return stored;
+}
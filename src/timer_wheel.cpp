@@ -0,0 +1,58 @@
+#include "timer_wheel.h"
+
+const uint32_t TimerWheel::NONE;
+
+TimerWheel::TimerWheel(size_t timerCount, size_t slotCount, uint64_t tickNs)
+    : entries_(timerCount),
+      buckets_(slotCount > 0 ? slotCount : 1, NONE),
+      tickNs_(tickNs > 0 ? tickNs : 1),
+      nextTick_(0),
+      scheduledCount_(0) {
+}
+
+void TimerWheel::schedule(uint32_t id, uint64_t deadlineNs) {
+    if (entries_[id].scheduled) {
+        unlink(id);
+    }
+
+    // The first tick starting at or after the deadline, so the bucket is
+    // never visited before the timer is due (it would then wait a whole
+    // revolution). Deadlines behind the cursor go in the next bucket visited
+    uint64_t tick = std::max((deadlineNs + tickNs_ - 1) / tickNs_, nextTick_);
+    uint32_t bucket = static_cast<uint32_t>(tick % buckets_.size());
+
+    Entry& entry = entries_[id];
+    entry.deadlineNs = deadlineNs;
+    entry.bucket = bucket;
+    entry.prev = NONE;
+    entry.next = buckets_[bucket];
+    entry.scheduled = true;
+    if (entry.next != NONE) {
+        entries_[entry.next].prev = id;
+    }
+    buckets_[bucket] = id;
+    scheduledCount_++;
+}
+
+void TimerWheel::cancel(uint32_t id) {
+    if (entries_[id].scheduled) {
+        unlink(id);
+    }
+}
+
+void TimerWheel::unlink(uint32_t id) {
+    Entry& entry = entries_[id];
+    if (entry.prev != NONE) {
+        entries_[entry.prev].next = entry.next;
+    } else {
+        buckets_[entry.bucket] = entry.next;
+    }
+    if (entry.next != NONE) {
+        entries_[entry.next].prev = entry.prev;
+    }
+
+    entry.prev = NONE;
+    entry.next = NONE;
+    entry.scheduled = false;
+    scheduledCount_--;
+}
@@ -49,16 +49,36 @@ std::vector<glm::vec3> Transform::transformLidarPoints(
     const glm::mat4& transform,
     const std::vector<LidarPoint>& localPoints) {
     
-    std::vector<glm::vec3> worldPoints;
-    worldPoints.reserve(localPoints.size());
-    
-    for (const auto& point : localPoints) {
-        worldPoints.push_back(transformLidarPoint(transform, point));
-    }
-    
+    std::vector<glm::vec3> worldPoints(localPoints.size());
+    transformLidarPoints(transform, localPoints.data(), localPoints.size(), worldPoints.data());
     return worldPoints;
 }
 
+void Transform::transformLidarPoints(const glm::mat4& transform,
+                                     const LidarPoint* localPoints, size_t count,
+                                     glm::vec3* worldPoints) {
+    static_assert(sizeof(glm::vec3) == sizeof(LidarPoint), "glm::vec3 must match LidarPoint layout");
+    transformPoints(toAffine(transform), localPoints, count,
+                    reinterpret_cast<LidarPoint*>(worldPoints));
+}
+
+void Transform::transformLidarPointsSoA(const glm::mat4& transform,
+                                        const LidarPoint* localPoints, size_t count,
+                                        float* worldX, float* worldY, float* worldZ) {
+    transformPointsSoA(toAffine(transform), localPoints, count, worldX, worldY, worldZ);
+}
+
+AffineTransform Transform::toAffine(const glm::mat4& transform) {
+    // GLM is column-major: transform[column][row]; the bottom row is dropped
+    AffineTransform affine;
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 4; ++col) {
+            affine.m[row][col] = transform[col][row];
+        }
+    }
+    return affine;
+}
+
 glm::vec3 Transform::getPosition(const glm::mat4& transform) {
     // Position is in the last column of the 4x4 matrix
     return glm::vec3(transform[3]);
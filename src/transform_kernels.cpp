@@ -0,0 +1,256 @@
+#include "transform_kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TRANSFORM_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+static_assert(sizeof(LidarPoint) == 3 * sizeof(float), "LidarPoint must be three packed floats");
+
+AffineTransform::AffineTransform() {
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            m[r][c] = (r == c) ? 1.0f : 0.0f;
+        }
+    }
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::SSE:    return "sse";
+        case SimdLevel::AVX2:   return "avx2";
+    }
+    return "unknown";
+}
+
+// ---------------------------------------------------------------------------
+// Scalar
+
+static void transformScalar(const AffineTransform& t, const LidarPoint* in, size_t count,
+                            LidarPoint* out, float* outX, float* outY, float* outZ) {
+    const float m00 = t.m[0][0], m01 = t.m[0][1], m02 = t.m[0][2], m03 = t.m[0][3];
+    const float m10 = t.m[1][0], m11 = t.m[1][1], m12 = t.m[1][2], m13 = t.m[1][3];
+    const float m20 = t.m[2][0], m21 = t.m[2][1], m22 = t.m[2][2], m23 = t.m[2][3];
+
+    for (size_t i = 0; i < count; ++i) {
+        // Read before writing: out may alias in
+        float x = in[i].x, y = in[i].y, z = in[i].z;
+        float wx = m00 * x + m01 * y + m02 * z + m03;
+        float wy = m10 * x + m11 * y + m12 * z + m13;
+        float wz = m20 * x + m21 * y + m22 * z + m23;
+
+        if (out != nullptr) {
+            out[i].x = wx;
+            out[i].y = wy;
+            out[i].z = wz;
+        } else {
+            outX[i] = wx;
+            outY[i] = wy;
+            outZ[i] = wz;
+        }
+    }
+}
+
+#ifdef TRANSFORM_KERNELS_X86
+
+// Finish the points after the last full SIMD step
+static void transformTail(const AffineTransform& t, const LidarPoint* in, size_t count, size_t done,
+                          LidarPoint* out, float* outX, float* outY, float* outZ) {
+    if (out != nullptr) {
+        transformScalar(t, in + done, count - done, out + done, nullptr, nullptr, nullptr);
+    } else {
+        transformScalar(t, in + done, count - done, nullptr, outX + done, outY + done, outZ + done);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SSE: 4 points (three registers) per step
+//
+// a = x0 y0 z0 x1 | b = y1 z1 x2 y2 | c = z2 x3 y3 z3
+// The shuffles below only work within 128-bit lanes, so the AVX2 kernel
+// reuses the same sequence on two groups of 4 points at once.
+
+#define DEINTERLEAVE_XYZ(SHUFFLE, a, b, c, x, y, z)                                  \
+    do {                                                                             \
+        auto bc_ = SHUFFLE(b, c, _MM_SHUFFLE(1, 1, 2, 2));     /* x2 x2 x3 x3 */     \
+        x = SHUFFLE(a, bc_, _MM_SHUFFLE(2, 0, 3, 0));                                \
+        auto ab_ = SHUFFLE(a, b, _MM_SHUFFLE(0, 0, 1, 1));     /* y0 y0 y1 y1 */     \
+        auto bc2_ = SHUFFLE(b, c, _MM_SHUFFLE(2, 2, 3, 3));    /* y2 y2 y3 y3 */     \
+        y = SHUFFLE(ab_, bc2_, _MM_SHUFFLE(2, 0, 2, 0));                             \
+        auto ab2_ = SHUFFLE(a, b, _MM_SHUFFLE(1, 1, 2, 2));    /* z0 z0 z1 z1 */     \
+        z = SHUFFLE(ab2_, c, _MM_SHUFFLE(3, 0, 2, 0));                               \
+    } while (0)
+
+#define INTERLEAVE_XYZ(SHUFFLE, x, y, z, a, b, c)                                    \
+    do {                                                                             \
+        a = SHUFFLE(SHUFFLE(x, y, _MM_SHUFFLE(0, 0, 0, 0)),                          \
+                    SHUFFLE(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0)); \
+        b = SHUFFLE(SHUFFLE(y, z, _MM_SHUFFLE(1, 1, 1, 1)),                          \
+                    SHUFFLE(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0)); \
+        c = SHUFFLE(SHUFFLE(z, x, _MM_SHUFFLE(3, 3, 2, 2)),                          \
+                    SHUFFLE(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)); \
+    } while (0)
+
+__attribute__((target("sse2")))
+static void transformSSE(const AffineTransform& t, const LidarPoint* in, size_t count,
+                         LidarPoint* out, float* outX, float* outY, float* outZ) {
+    const __m128 m00 = _mm_set1_ps(t.m[0][0]), m01 = _mm_set1_ps(t.m[0][1]);
+    const __m128 m02 = _mm_set1_ps(t.m[0][2]), m03 = _mm_set1_ps(t.m[0][3]);
+    const __m128 m10 = _mm_set1_ps(t.m[1][0]), m11 = _mm_set1_ps(t.m[1][1]);
+    const __m128 m12 = _mm_set1_ps(t.m[1][2]), m13 = _mm_set1_ps(t.m[1][3]);
+    const __m128 m20 = _mm_set1_ps(t.m[2][0]), m21 = _mm_set1_ps(t.m[2][1]);
+    const __m128 m22 = _mm_set1_ps(t.m[2][2]), m23 = _mm_set1_ps(t.m[2][3]);
+
+    const float* src = reinterpret_cast<const float*>(in);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, src += 12) {
+        __m128 a = _mm_loadu_ps(src);
+        __m128 b = _mm_loadu_ps(src + 4);
+        __m128 c = _mm_loadu_ps(src + 8);
+
+        __m128 x, y, z;
+        DEINTERLEAVE_XYZ(_mm_shuffle_ps, a, b, c, x, y, z);
+
+        __m128 wx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m01, y)),
+                               _mm_add_ps(_mm_mul_ps(m02, z), m03));
+        __m128 wy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, x), _mm_mul_ps(m11, y)),
+                               _mm_add_ps(_mm_mul_ps(m12, z), m13));
+        __m128 wz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, x), _mm_mul_ps(m21, y)),
+                               _mm_add_ps(_mm_mul_ps(m22, z), m23));
+
+        if (out != nullptr) {
+            INTERLEAVE_XYZ(_mm_shuffle_ps, wx, wy, wz, a, b, c);
+            float* dst = reinterpret_cast<float*>(out + i);
+            _mm_storeu_ps(dst, a);
+            _mm_storeu_ps(dst + 4, b);
+            _mm_storeu_ps(dst + 8, c);
+        } else {
+            _mm_storeu_ps(outX + i, wx);
+            _mm_storeu_ps(outY + i, wy);
+            _mm_storeu_ps(outZ + i, wz);
+        }
+    }
+
+    transformTail(t, in, count, i, out, outX, outY, outZ);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2: 8 points per step; points 0-3 in the low lane, 4-7 in the high lane
+
+__attribute__((target("avx2,fma")))
+static void transformAVX2(const AffineTransform& t, const LidarPoint* in, size_t count,
+                          LidarPoint* out, float* outX, float* outY, float* outZ) {
+    const __m256 m00 = _mm256_set1_ps(t.m[0][0]), m01 = _mm256_set1_ps(t.m[0][1]);
+    const __m256 m02 = _mm256_set1_ps(t.m[0][2]), m03 = _mm256_set1_ps(t.m[0][3]);
+    const __m256 m10 = _mm256_set1_ps(t.m[1][0]), m11 = _mm256_set1_ps(t.m[1][1]);
+    const __m256 m12 = _mm256_set1_ps(t.m[1][2]), m13 = _mm256_set1_ps(t.m[1][3]);
+    const __m256 m20 = _mm256_set1_ps(t.m[2][0]), m21 = _mm256_set1_ps(t.m[2][1]);
+    const __m256 m22 = _mm256_set1_ps(t.m[2][2]), m23 = _mm256_set1_ps(t.m[2][3]);
+
+    const float* src = reinterpret_cast<const float*>(in);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8, src += 24) {
+        __m256 a = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src)),
+                                        _mm_loadu_ps(src + 12), 1);
+        __m256 b = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src + 4)),
+                                        _mm_loadu_ps(src + 16), 1);
+        __m256 c = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src + 8)),
+                                        _mm_loadu_ps(src + 20), 1);
+
+        __m256 x, y, z;
+        DEINTERLEAVE_XYZ(_mm256_shuffle_ps, a, b, c, x, y, z);
+
+        __m256 wx = _mm256_fmadd_ps(m00, x, _mm256_fmadd_ps(m01, y, _mm256_fmadd_ps(m02, z, m03)));
+        __m256 wy = _mm256_fmadd_ps(m10, x, _mm256_fmadd_ps(m11, y, _mm256_fmadd_ps(m12, z, m13)));
+        __m256 wz = _mm256_fmadd_ps(m20, x, _mm256_fmadd_ps(m21, y, _mm256_fmadd_ps(m22, z, m23)));
+
+        if (out != nullptr) {
+            INTERLEAVE_XYZ(_mm256_shuffle_ps, wx, wy, wz, a, b, c);
+            float* dst = reinterpret_cast<float*>(out + i);
+            _mm_storeu_ps(dst, _mm256_castps256_ps128(a));
+            _mm_storeu_ps(dst + 4, _mm256_castps256_ps128(b));
+            _mm_storeu_ps(dst + 8, _mm256_castps256_ps128(c));
+            _mm_storeu_ps(dst + 12, _mm256_extractf128_ps(a, 1));
+            _mm_storeu_ps(dst + 16, _mm256_extractf128_ps(b, 1));
+            _mm_storeu_ps(dst + 20, _mm256_extractf128_ps(c, 1));
+        } else {
+            // Lanes hold points 0-3 / 4-7 in order, so x/y/z store contiguously
+            _mm256_storeu_ps(outX + i, wx);
+            _mm256_storeu_ps(outY + i, wy);
+            _mm256_storeu_ps(outZ + i, wz);
+        }
+    }
+
+    transformTail(t, in, count, i, out, outX, outY, outZ);
+}
+
+#undef DEINTERLEAVE_XYZ
+#undef INTERLEAVE_XYZ
+
+#endif // TRANSFORM_KERNELS_X86
+
+// ---------------------------------------------------------------------------
+// Dispatch
+
+static SimdLevel probeSimdLevel() {
+#ifdef TRANSFORM_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SimdLevel::SSE;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+SimdLevel detectSimdLevel() {
+    static const SimdLevel level = probeSimdLevel();
+    return level;
+}
+
+typedef void (*TransformKernel)(const AffineTransform&, const LidarPoint*, size_t,
+                                LidarPoint*, float*, float*, float*);
+
+static TransformKernel selectKernel(SimdLevel level) {
+    SimdLevel supported = detectSimdLevel();
+    if (static_cast<uint8_t>(level) > static_cast<uint8_t>(supported)) {
+        level = supported;
+    }
+
+    switch (level) {
+#ifdef TRANSFORM_KERNELS_X86
+        case SimdLevel::AVX2: return transformAVX2;
+        case SimdLevel::SSE:  return transformSSE;
+#endif
+        default:              return transformScalar;
+    }
+}
+
+static TransformKernel bestKernel() {
+    static const TransformKernel kernel = selectKernel(detectSimdLevel());
+    return kernel;
+}
+
+void transformPoints(const AffineTransform& transform, const LidarPoint* in,
+                     size_t count, LidarPoint* out) {
+    bestKernel()(transform, in, count, out, nullptr, nullptr, nullptr);
+}
+
+void transformPointsSoA(const AffineTransform& transform, const LidarPoint* in,
+                        size_t count, float* outX, float* outY, float* outZ) {
+    bestKernel()(transform, in, count, nullptr, outX, outY, outZ);
+}
+
+void transformPoints(const AffineTransform& transform, const LidarPoint* in,
+                     size_t count, LidarPoint* out, SimdLevel level) {
+    selectKernel(level)(transform, in, count, out, nullptr, nullptr, nullptr);
+}
+
+void transformPointsSoA(const AffineTransform& transform, const LidarPoint* in,
+                        size_t count, float* outX, float* outY, float* outZ,
+                        SimdLevel level) {
+    selectKernel(level)(transform, in, count, nullptr, outX, outY, outZ);
+}
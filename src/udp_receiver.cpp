@@ -1,4 +1,5 @@
 #include "udp_receiver.h"
+#include "latency_stats.h"
 #include <iostream>
 #include <cstring>
 #include <unistd.h>
@@ -6,7 +7,50 @@
 #include <arpa/inet.h>
 #include <errno.h>
 
-UDPReceiver::UDPReceiver(uint16_t port) : port_(port), socketFd_(-1) {
+// Pull the SO_TIMESTAMPNS arrival time out of a received message
+// Returns fallbackNs if the kernel did not attach one
+static uint64_t extractArrivalNs(const struct msghdr& hdr, uint64_t fallbackNs) {
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(const_cast<struct msghdr*>(&hdr), cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            struct timespec ts;
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL 
+                 + static_cast<uint64_t>(ts.tv_nsec);
+        }
+    }
+    return fallbackNs;
+}
+
+ReceiveBatch::ReceiveBatch(size_t capacity)
+    : capacity_(capacity > 0 ? capacity : 1), count_(0),
+      storage_(capacity_ * MAX_DATAGRAM_SIZE),
+      iovecs_(capacity_), senders_(capacity_), messages_(capacity_),
+      control_(capacity_ * RECEIVE_CONTROL_WORDS), arrivals_(capacity_, 0) {
+    prepare();
+}
+
+void ReceiveBatch::prepare() {
+    // recvmmsg overwrites msg_namelen and msg_len, so reset every slot
+    for (size_t i = 0; i < capacity_; ++i) {
+        iovecs_[i].iov_base = &storage_[i * MAX_DATAGRAM_SIZE];
+        iovecs_[i].iov_len = MAX_DATAGRAM_SIZE;
+        
+        struct msghdr& hdr = messages_[i].msg_hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        hdr.msg_name = &senders_[i];
+        hdr.msg_namelen = sizeof(senders_[i]);
+        hdr.msg_iov = &iovecs_[i];
+        hdr.msg_iovlen = 1;
+        hdr.msg_control = &control_[i * RECEIVE_CONTROL_WORDS];
+        hdr.msg_controllen = RECEIVE_CONTROL_WORDS * sizeof(uint64_t);
+        messages_[i].msg_len = 0;
+    }
+    count_ = 0;
+}
+
+UDPReceiver::UDPReceiver(uint16_t port) 
+    : socketFd_(-1), port_(port), timestampsEnabled_(false), lastArrivalNs_(0) {
     // Create UDP socket
     socketFd_ = socket(AF_INET, SOCK_DGRAM, 0);
     if (socketFd_ < 0) {
@@ -70,14 +114,90 @@ void UDPReceiver::setNonBlocking(bool nonBlocking) {
     }
 }
 
+void UDPReceiver::setReceiveBufferSize(int bytes) {
+    if (socketFd_ < 0) return;
+    
+    if (setsockopt(socketFd_, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes)) < 0) {
+        std::cerr << "Warning: Could not set SO_RCVBUF on port " << port_ 
+                  << ": " << strerror(errno) << std::endl;
+    }
+}
+
+void UDPReceiver::enableTimestamps(bool enable) {
+    if (socketFd_ < 0) return;
+    
+    int optval = enable ? 1 : 0;
+    if (setsockopt(socketFd_, SOL_SOCKET, SO_TIMESTAMPNS, &optval, sizeof(optval)) < 0) {
+        std::cerr << "Warning: Could not set SO_TIMESTAMPNS on port " << port_ 
+                  << ": " << strerror(errno) << std::endl;
+        return;
+    }
+    timestampsEnabled_ = enable;
+}
+
 ssize_t UDPReceiver::receive(void* buffer, size_t bufferSize) {
     if (socketFd_ < 0) return 0;
     
+    // Single-slot batch pointing straight at the caller's buffer
+    struct iovec iov;
+    iov.iov_base = buffer;
+    iov.iov_len = bufferSize;
+    
+    uint64_t control[RECEIVE_CONTROL_WORDS];
+    
+    struct mmsghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_hdr.msg_name = &senderAddr_;
+    message.msg_hdr.msg_namelen = sizeof(senderAddr_);
+    message.msg_hdr.msg_iov = &iov;
+    message.msg_hdr.msg_iovlen = 1;
+    message.msg_hdr.msg_control = control;
+    message.msg_hdr.msg_controllen = sizeof(control);
+    
+    int received = receiveMessages(&message, 1);
+    if (received <= 0) {
+        return received;
+    }
+    
+    senderAddrLen_ = message.msg_hdr.msg_namelen;
+    lastArrivalNs_ = timestampsEnabled_ 
+        ? extractArrivalNs(message.msg_hdr, realtimeNowNs()) 
+        : realtimeNowNs();
+    return static_cast<ssize_t>(message.msg_len);
+}
+
+int UDPReceiver::receiveBatch(ReceiveBatch& batch) {
+    if (socketFd_ < 0) return 0;
+    
+    batch.prepare();
+    int received = receiveMessages(batch.messages_.data(),
+                                   static_cast<unsigned int>(batch.capacity_));
+    if (received <= 0) {
+        return received;
+    }
+    
+    batch.count_ = static_cast<size_t>(received);
+    
+    // One clock read per batch covers sockets without kernel timestamps
+    uint64_t fallbackNs = realtimeNowNs();
+    for (size_t i = 0; i < batch.count_; ++i) {
+        batch.arrivals_[i] = timestampsEnabled_ 
+            ? extractArrivalNs(batch.messages_[i].msg_hdr, fallbackNs) 
+            : fallbackNs;
+    }
+    
+    // Keep getLastSender*() meaningful for batch users too
+    senderAddr_ = batch.senders_[batch.count_ - 1];
     senderAddrLen_ = sizeof(senderAddr_);
-    ssize_t bytesReceived = recvfrom(socketFd_, buffer, bufferSize, 0,
-                                      (struct sockaddr*)&senderAddr_, &senderAddrLen_);
+    return received;
+}
+
+int UDPReceiver::receiveMessages(struct mmsghdr* messages, unsigned int count) {
+    // MSG_WAITFORONE: block (if blocking) for the first datagram only, then
+    // drain whatever else is already queued without waiting
+    int received = recvmmsg(socketFd_, messages, count, MSG_WAITFORONE, nullptr);
     
-    if (bytesReceived < 0) {
+    if (received < 0) {
         if (errno == EAGAIN || errno == EWOULDBLOCK) {
             // No data available (non-blocking mode)
             return -1;
@@ -87,7 +207,7 @@ ssize_t UDPReceiver::receive(void* buffer, size_t bufferSize) {
         return 0;
     }
     
-    return bytesReceived;
+    return received;
 }
 
 std::string UDPReceiver::getLastSenderAddress() const {
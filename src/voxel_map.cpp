@@ -0,0 +1,262 @@
+#include "voxel_map.h"
+#include "voxel_key.h"
+#include <cmath>
+#include <algorithm>
+
+const uint32_t VoxelMap::BLOCK_SIZE;
+const uint32_t VoxelMap::BLOCK_VOXELS;
+const uint32_t VoxelMap::MAX_LEVELS;
+constexpr float VoxelMap::LOG_ODDS_SCALE;
+const uint64_t VoxelMap::EMPTY_KEY;
+
+namespace {
+
+// Keys pack block coordinates, so voxel coordinates may go BLOCK_SIZE times further
+const float VOXEL_RANGE = VOXEL_KEY_RANGE * VoxelMap::BLOCK_SIZE;
+
+inline int32_t quantise(float logOdds) {
+    float steps = std::round(logOdds * VoxelMap::LOG_ODDS_SCALE);
+    return static_cast<int32_t>(std::min(std::max(steps, -127.0f), 127.0f));
+}
+
+inline uint32_t voxelIndex(int32_t vx, int32_t vy, int32_t vz) {
+    return ((static_cast<uint32_t>(vz) & 7u) * 8u + (static_cast<uint32_t>(vy) & 7u)) * 8u +
+           (static_cast<uint32_t>(vx) & 7u);
+}
+
+} // namespace
+
+VoxelMap::VoxelMap() : VoxelMap(Config()) {
+}
+
+VoxelMap::VoxelMap(const Config& config)
+    : config_(config) {
+    if (config_.voxelSize <= 0.0f) config_.voxelSize = 0.2f;
+    config_.levels = std::min(std::max(config_.levels, 1u), MAX_LEVELS);
+
+    q_.hit = std::max(quantise(config_.hitLogOdds), 1);
+    q_.miss = std::min(quantise(config_.missLogOdds), -1);
+    q_.min = std::min(quantise(config_.minLogOdds), 0);
+    q_.max = std::max(quantise(config_.maxLogOdds), 0);
+    q_.occupied = quantise(config_.occupiedLogOdds);
+
+    // Table starts at twice the reserved blocks (power of two, load <= 1/2)
+    uint32_t tableBits = 4;
+    while ((1u << tableBits) < config_.initialBlocks * 2 && tableBits < 30) {
+        tableBits++;
+    }
+
+    levels_.resize(config_.levels);
+    float voxelSize = config_.voxelSize;
+    for (Level& level : levels_) {
+        level.voxelSize = voxelSize;
+        level.invVoxelSize = 1.0f / voxelSize;
+        level.blocks.reserve(config_.initialBlocks);
+        level.keys.assign(size_t(1) << tableBits, EMPTY_KEY);
+        level.indices.assign(size_t(1) << tableBits, 0);
+        level.shift = 64 - tableBits;
+        level.cachedKey = EMPTY_KEY;
+        level.cachedIndex = 0;
+        voxelSize *= 2.0f;
+    }
+    updateMemoryStats();
+}
+
+size_t VoxelMap::insert(const glm::vec3* points, size_t count) {
+    size_t accepted = integrate(points, count, true);
+    stats_.pointsInserted += accepted;
+    return accepted;
+}
+
+size_t VoxelMap::insertMisses(const glm::vec3* points, size_t count) {
+    size_t accepted = integrate(points, count, false);
+    stats_.missesInserted += accepted;
+    return accepted;
+}
+
+size_t VoxelMap::integrate(const glm::vec3* points, size_t count, bool hit) {
+    size_t accepted = 0;
+    int32_t v[3];
+    for (size_t i = 0; i < count; ++i) {
+        if (!voxelOf(points[i], levels_[0], v)) {
+            continue;
+        }
+        updateVoxel(v[0], v[1], v[2], hit);
+        accepted++;
+    }
+
+    stats_.pointsRejected += count - accepted;
+    updateMemoryStats();
+    return accepted;
+}
+
+bool VoxelMap::voxelOf(const glm::vec3& point, const Level& level, int32_t v[3]) const {
+    float fx = point.x * level.invVoxelSize;
+    float fy = point.y * level.invVoxelSize;
+    float fz = point.z * level.invVoxelSize;
+    return gridCoordinates(fx, fy, fz, VOXEL_RANGE, v);
+}
+
+void VoxelMap::updateVoxel(int32_t vx, int32_t vy, int32_t vz, bool hit) {
+    Level& fine = levels_[0];
+    Block* block = &fine.blocks[findOrAddBlock(fine, vx >> 3, vy >> 3, vz >> 3)];
+    int8_t& cell = block->logOdds[voxelIndex(vx, vy, vz)];
+
+    int32_t oldValue = cell;
+    int32_t newValue = std::min(std::max(oldValue + (hit ? q_.hit : q_.miss), q_.min), q_.max);
+    if (newValue == oldValue) {
+        return;   // Clamped: nothing changes further up either
+    }
+    cell = static_cast<int8_t>(newValue);
+
+    // Parent = max of its 8 children, which share the child's block (8 is even)
+    for (uint32_t l = 1; l < config_.levels; ++l) {
+        int32_t px = vx >> 1, py = vy >> 1, pz = vz >> 1;
+        Level& parentLevel = levels_[l];
+
+        int32_t candidate;
+        uint32_t parentIndex;
+        if (hit) {
+            // Values only went up: the max can only rise to newValue
+            parentIndex = findOrAddBlock(parentLevel, px >> 3, py >> 3, pz >> 3);
+            int8_t& parent = parentLevel.blocks[parentIndex].logOdds[voxelIndex(px, py, pz)];
+            if (newValue <= parent) {
+                return;
+            }
+            parent = static_cast<int8_t>(newValue);
+            candidate = newValue;
+        } else {
+            parentIndex = findBlock(parentLevel, packVoxelKey(px >> 3, py >> 3, pz >> 3));
+            int32_t parentValue = parentIndex != UINT32_MAX
+                ? parentLevel.blocks[parentIndex].logOdds[voxelIndex(px, py, pz)] : 0;
+            if (oldValue < parentValue) {
+                return;   // A sibling holds the max
+            }
+
+            candidate = -128;
+            int32_t bx = px * 2, by = py * 2, bz = pz * 2;
+            for (int32_t dz = 0; dz < 2; ++dz) {
+                for (int32_t dy = 0; dy < 2; ++dy) {
+                    for (int32_t dx = 0; dx < 2; ++dx) {
+                        candidate = std::max<int32_t>(candidate, block->logOdds[voxelIndex(bx + dx, by + dy, bz + dz)]);
+                    }
+                }
+            }
+            if (candidate == parentValue) {
+                return;
+            }
+            if (parentIndex == UINT32_MAX) {
+                parentIndex = findOrAddBlock(parentLevel, px >> 3, py >> 3, pz >> 3);
+            }
+            parentLevel.blocks[parentIndex].logOdds[voxelIndex(px, py, pz)] = static_cast<int8_t>(candidate);
+            oldValue = parentValue;
+        }
+
+        newValue = candidate;
+        block = &parentLevel.blocks[parentIndex];
+        vx = px; vy = py; vz = pz;
+    }
+}
+
+uint32_t VoxelMap::findBlock(const Level& level, uint64_t key) const {
+    const uint32_t mask = static_cast<uint32_t>(level.keys.size() - 1);
+    for (uint32_t slot = voxelKeySlot(key, level.shift);; slot = (slot + 1) & mask) {
+        if (level.keys[slot] == key) {
+            return level.indices[slot];
+        }
+        if (level.keys[slot] == EMPTY_KEY) {
+            return UINT32_MAX;
+        }
+    }
+}
+
+uint32_t VoxelMap::findOrAddBlock(Level& level, int32_t bx, int32_t by, int32_t bz) {
+    uint64_t key = packVoxelKey(bx, by, bz);
+    if (key == level.cachedKey) {
+        return level.cachedIndex;
+    }
+
+    const uint32_t mask = static_cast<uint32_t>(level.keys.size() - 1);
+    uint32_t slot = voxelKeySlot(key, level.shift);
+    while (level.keys[slot] != EMPTY_KEY) {
+        if (level.keys[slot] == key) {
+            level.cachedKey = key;
+            level.cachedIndex = level.indices[slot];
+            return level.cachedIndex;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    // New block
+    uint32_t index = static_cast<uint32_t>(level.blocks.size());
+    level.blocks.emplace_back();
+    Block& block = level.blocks.back();
+    block.x = bx;
+    block.y = by;
+    block.z = bz;
+    std::fill(block.logOdds, block.logOdds + BLOCK_VOXELS, int8_t(0));
+
+    level.keys[slot] = key;
+    level.indices[slot] = index;
+    if (level.blocks.size() * 2 > level.keys.size()) {
+        growTable(level);
+    }
+
+    level.cachedKey = key;
+    level.cachedIndex = index;
+    return index;
+}
+
+void VoxelMap::growTable(Level& level) {
+    const size_t size = level.keys.size() * 2;
+    level.keys.assign(size, EMPTY_KEY);
+    level.indices.assign(size, 0);
+    level.shift--;
+
+    // Rebuild from the pool (it holds every key)
+    const uint32_t mask = static_cast<uint32_t>(size - 1);
+    for (uint32_t i = 0; i < level.blocks.size(); ++i) {
+        const Block& block = level.blocks[i];
+        uint64_t key = packVoxelKey(block.x, block.y, block.z);
+        uint32_t slot = voxelKeySlot(key, level.shift);
+        while (level.keys[slot] != EMPTY_KEY) {
+            slot = (slot + 1) & mask;
+        }
+        level.keys[slot] = key;
+        level.indices[slot] = i;
+    }
+}
+
+float VoxelMap::getLogOdds(const glm::vec3& point, uint32_t level) const {
+    if (level >= config_.levels) {
+        return 0.0f;
+    }
+    const Level& lv = levels_[level];
+    int32_t v[3];
+    if (!voxelOf(point, lv, v)) {
+        return 0.0f;
+    }
+    uint32_t index = findBlock(lv, packVoxelKey(v[0] >> 3, v[1] >> 3, v[2] >> 3));
+    if (index == UINT32_MAX) {
+        return 0.0f;
+    }
+    return static_cast<float>(lv.blocks[index].logOdds[voxelIndex(v[0], v[1], v[2])]) / LOG_ODDS_SCALE;
+}
+
+void VoxelMap::updateMemoryStats() {
+    size_t bytes = levels_.capacity() * sizeof(Level);
+    for (const Level& level : levels_) {
+        bytes += level.blocks.capacity() * sizeof(Block);
+        bytes += level.keys.capacity() * sizeof(uint64_t);
+        bytes += level.indices.capacity() * sizeof(uint32_t);
+    }
+    stats_.memoryBytes = bytes;
+}
+
+void VoxelMap::clear() {
+    for (Level& level : levels_) {
+        level.blocks.clear();
+        std::fill(level.keys.begin(), level.keys.end(), EMPTY_KEY);
+        level.cachedKey = EMPTY_KEY;
+    }
+}
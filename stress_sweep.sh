@@ -0,0 +1,61 @@
+#!/bin/bash
+
+# Sweeps emulator load against the receiver and reports where it breaks
+#
+# For every combination of rover count, scan rate and point multiplier the
+# receiver harness (stress_receiver, built by CMake) listens while
+# run_rovers.sh streams for DURATION seconds. A configuration is flagged
+# when more than 1% of the scans sent are not received complete, or when
+# the p99 first-chunk -> consumer latency exceeds 50 ms.
+#
+# Usage: ./stress_sweep.sh [emulator options...]   (e.g. --drop 0.01 --reorder 0.05)
+# Override the sweep with ROVERS="1 5 10" RATES="10 20" POINTS="1 2" DURATION=5
+ROVERS=${ROVERS:-"1 5 10 20"}
+RATES=${RATES:-"10 20 40"}
+POINTS=${POINTS:-"1 2 4"}
+DURATION=${DURATION:-5}
+RECEIVER=${RECEIVER:-build/bin/stress_receiver}
+MAX_DROP_PCT=1
+MAX_P99_MS=50
+
+if [[ ! -x "$RECEIVER" || ! -x ./rover_emulator ]]; then
+    echo "Build first: make rover_emulator && make cmake-build (missing $RECEIVER or ./rover_emulator)"
+    exit 1
+fi
+
+printf "%7s %6s %7s %9s %9s %8s %8s %8s %8s  %s\n" \
+    "Rovers" "Hz" "Points" "Expected" "Complete" "Partial" "Drop%" "p99 ms" "Max ms" "Status"
+
+for R in $ROVERS; do
+    for HZ in $RATES; do
+        for P in $POINTS; do
+            LOG=$(mktemp)
+            # The receiver listens a little longer than the rovers stream
+            "$RECEIVER" "$R" $((DURATION + 1)) "$P" > "$LOG" 2>&1 &
+            RECEIVER_PID=$!
+            sleep 0.5
+            ./run_rovers.sh --rovers "$R" --loop --duration "$DURATION" --rate "$HZ" --points "$P" "$@" > /dev/null 2>&1
+            wait "$RECEIVER_PID"
+
+            RESULT=$(grep '^RESULT' "$LOG")
+            rm -f "$LOG"
+            if [[ -z "$RESULT" ]]; then
+                printf "%7s %6s %7s  receiver failed\n" "$R" "$HZ" "$P"
+                continue
+            fi
+            field() { echo "$RESULT" | sed -n "s/.* $1=\([^ ]*\).*/\1/p"; }
+
+            FLAGS=()
+            if awk "BEGIN { exit !($(field drop_pct) > $MAX_DROP_PCT) }"; then
+                FLAGS+=("DROPPING")
+            fi
+            if awk "BEGIN { exit !($(field p99_ms) > $MAX_P99_MS) }"; then
+                FLAGS+=("SLOW")
+            fi
+            STATUS="${FLAGS[*]:-ok}"
+            printf "%7s %6s %7s %9s %9s %8s %8s %8s %8s  %s\n" "$R" "$HZ" "$P" \
+                "$(field expected)" "$(field complete)" "$(field partial)" \
+                "$(field drop_pct)" "$(field p99_ms)" "$(field max_ms)" "$STATUS"
+        done
+    done
+done
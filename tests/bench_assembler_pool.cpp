@@ -0,0 +1,104 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <cstring>
+#include "assembler_pool.h"
+#include "udp_packet_structures.h"
+
+// Throughput of the per-rover assembler pool as rovers are added
+//
+// One feeder thread per rover (standing in for that rover's share of the
+// reactor) pushes full 64-chunk scans as fast as the shard accepts them, and
+// one consumer drains complete scans. Chunks/s should grow roughly linearly
+// with rover count until the cores run out.
+
+static const uint32_t CHUNKS_PER_SCAN = 64;
+static const double RUN_SECONDS = 1.0;
+
+static double runRovers(uint32_t rovers, size_t& inboxDrops) {
+    AssemblerPool::Config config;
+    config.firstCore = 0;
+    config.inboxDepth = 1024;
+    AssemblerPool pool(config);
+    for (uint32_t id = 1; id <= rovers; ++id) {
+        pool.addRover(id);
+    }
+    pool.start();
+
+    std::atomic<bool> done(false);
+    std::vector<std::thread> feeders;
+    for (uint32_t id = 1; id <= rovers; ++id) {
+        feeders.emplace_back([&pool, &done, id]() {
+            LidarPacket packet;
+            memset(&packet, 0, sizeof(packet));
+            packet.header.totalChunks = CHUNKS_PER_SCAN;
+            packet.header.pointsInThisChunk = MAX_LIDAR_POINTS_PER_PACKET;
+
+            LidarAssembler* assembler = pool.getAssembler(id);
+            size_t sent = 0;
+            for (uint32_t scan = 0; !done.load(std::memory_order_relaxed); ++scan) {
+                packet.header.timestamp = scan;
+                for (uint32_t chunk = 0; chunk < CHUNKS_PER_SCAN; ++chunk) {
+                    // Keep the inbox short of full so nothing is shed
+                    while (sent - assembler->getTotalChunksReceived() > 512 &&
+                           !done.load(std::memory_order_relaxed)) {
+                        std::this_thread::yield();
+                    }
+                    packet.header.chunkIndex = chunk;
+                    pool.onLidar(id, packet, 1);
+                    sent++;
+                }
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ScanHandle scan;
+    while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < RUN_SECONDS) {
+        for (uint32_t id = 1; id <= rovers; ++id) {
+            while (pool.getCompleteScan(id, scan)) {
+                scan.reset();
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    AssemblerPool::Stats stats = pool.getStats();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    done.store(true);
+    for (auto& feeder : feeders) {
+        feeder.join();
+    }
+    pool.stop();
+
+    inboxDrops = stats.inboxDrops;
+    return static_cast<double>(stats.chunksReceived) / elapsed;
+}
+
+int main() {
+    unsigned cores = std::thread::hardware_concurrency();
+    uint32_t maxRovers = cores >= 2 ? cores / 2 : 1;
+
+    std::cout << "=== Assembler Pool Scaling Benchmark ===" << std::endl;
+    std::cout << "Cores: " << cores << ", " << CHUNKS_PER_SCAN << " chunks/scan, "
+              << RUN_SECONDS << " s per run" << std::endl << std::endl;
+    std::cout << std::setw(8) << "Rovers" << std::setw(16) << "Chunks/s"
+              << std::setw(12) << "Scaling" << std::setw(14) << "Inbox drops" << std::endl;
+
+    double baseline = 0.0;
+    for (uint32_t rovers = 1; rovers <= maxRovers; rovers *= 2) {
+        size_t drops = 0;
+        double rate = runRovers(rovers, drops);
+        if (rovers == 1) baseline = rate;
+
+        std::cout << std::setw(8) << rovers
+                  << std::setw(16) << std::fixed << std::setprecision(0) << rate
+                  << std::setw(11) << std::setprecision(2) << rate / baseline << "x"
+                  << std::setw(14) << drops << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <glm/glm.hpp>
+#include "chunk_pipeline.h"
+#include "lidar_assembler.h"
+#include "transform.h"
+#include "latency_stats.h"
+#include "udp_packet_structures.h"
+
+// Per-chunk ingest-to-world latency: streaming ChunkPipeline vs whole-scan batch
+//
+// Chunks of each scan are fed spaced evenly over the scan period (a spinning
+// sensor), then again as one burst (like the emulator). Batch mode assembles
+// the scan and transforms it once complete, so every chunk waits for the
+// last one; streaming mode transforms each chunk as it is fed.
+
+static const uint32_t CHUNKS_PER_SCAN = 64;
+static const int SCANS = 20;
+
+struct LatencySink : public ChunkSink {
+    LatencyHistogram chunkLatency;
+    LatencyHistogram firstPointLatency;
+
+    void onWorldChunk(const WorldChunk& chunk) override {
+        uint64_t latency = realtimeNowNs() - chunk.arrivalNs;
+        chunkLatency.record(latency);
+        if (chunk.chunkIndex == 0) firstPointLatency.record(latency);
+    }
+};
+
+static LidarPacket makeChunk(double timestamp, uint32_t index) {
+    LidarPacket packet;
+    memset(&packet, 0, sizeof(packet));
+    packet.header.timestamp = timestamp;
+    packet.header.chunkIndex = index;
+    packet.header.totalChunks = CHUNKS_PER_SCAN;
+    packet.header.pointsInThisChunk = MAX_LIDAR_POINTS_PER_PACKET;
+    for (size_t i = 0; i < MAX_LIDAR_POINTS_PER_PACKET; ++i) {
+        float f = static_cast<float>(index * MAX_LIDAR_POINTS_PER_PACKET + i);
+        packet.points[i] = { std::sin(f) * 20.0f, std::cos(f) * 20.0f, 0.5f };
+    }
+    return packet;
+}
+
+static PosePacket makePose(double timestamp) {
+    PosePacket pose = {};
+    pose.timestamp = timestamp;
+    pose.posX = static_cast<float>(timestamp) * 2.0f;
+    pose.rotZdeg = static_cast<float>(timestamp) * 10.0f;
+    return pose;
+}
+
+// Feed SCANS scans, calling feed(packet, arrivalNs) per chunk
+template <typename Feed>
+static void feedScans(double scanPeriodMs, Feed&& feed) {
+    auto chunkGap = std::chrono::duration<double, std::milli>(scanPeriodMs / CHUNKS_PER_SCAN);
+    std::vector<LidarPacket> chunks;
+    for (uint32_t c = 0; c < CHUNKS_PER_SCAN; ++c) {
+        chunks.push_back(makeChunk(0.0, c));
+    }
+
+    for (int scan = 0; scan < SCANS; ++scan) {
+        double timestamp = scan * 0.1;
+        auto next = std::chrono::steady_clock::now();
+        for (auto& chunk : chunks) {
+            chunk.header.timestamp = timestamp;
+            if (scanPeriodMs > 0.0) {
+                next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(chunkGap);
+                std::this_thread::sleep_until(next);
+            }
+            feed(chunk, realtimeNowNs(), timestamp);
+        }
+    }
+}
+
+static void printRow(const char* mode, const LatencyHistogram& chunks, const LatencyHistogram& first) {
+    std::cout << std::left << std::setw(12) << mode << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << first.percentile(50.0) / 1e6
+              << std::setw(12) << chunks.percentile(50.0) / 1e6
+              << std::setw(12) << chunks.percentile(99.0) / 1e6
+              << std::setw(12) << chunks.max() / 1e6 << std::endl;
+}
+
+static void runStreaming(double scanPeriodMs) {
+    LatencySink sink;
+    ChunkPipeline pipeline(sink);
+    pipeline.addRover(1);
+
+    feedScans(scanPeriodMs, [&](const LidarPacket& chunk, uint64_t arrivalNs, double timestamp) {
+        if (chunk.header.chunkIndex == 0) pipeline.onPose(1, makePose(timestamp), arrivalNs);
+        pipeline.onLidar(1, chunk, arrivalNs);
+    });
+    printRow("streaming", sink.chunkLatency, sink.firstPointLatency);
+}
+
+static void runBatch(double scanPeriodMs) {
+    LidarAssembler assembler;
+    LatencyHistogram chunkLatency;
+    LatencyHistogram firstPointLatency;
+    std::vector<uint64_t> arrivals(CHUNKS_PER_SCAN);
+    std::vector<LidarPoint> points;
+    glm::mat4 pose(1.0f);
+
+    feedScans(scanPeriodMs, [&](const LidarPacket& chunk, uint64_t arrivalNs, double timestamp) {
+        if (chunk.header.chunkIndex == 0) pose = Transform::poseToMatrix(makePose(timestamp));
+        arrivals[chunk.header.chunkIndex] = arrivalNs;
+        if (!assembler.addPacket(chunk, arrivalNs)) return;
+
+        ScanHandle scan;
+        assembler.getCompleteScan(scan);
+        points.assign(scan.points(), scan.points() + scan.pointCount());
+        std::vector<glm::vec3> world = Transform::transformLidarPoints(pose, points);
+
+        uint64_t now = realtimeNowNs();
+        for (uint32_t c = 0; c < CHUNKS_PER_SCAN; ++c) {
+            chunkLatency.record(now - arrivals[c]);
+        }
+        firstPointLatency.record(now - arrivals[0]);
+    });
+    printRow("batch", chunkLatency, firstPointLatency);
+}
+
+int main() {
+    std::cout << "=== Chunk Ingest-to-World Latency Benchmark ===" << std::endl;
+    std::cout << CHUNKS_PER_SCAN << " chunks x " << MAX_LIDAR_POINTS_PER_PACKET
+              << " points per scan, " << SCANS << " scans per run" << std::endl;
+
+    for (double periodMs : {100.0, 0.0}) {
+        std::cout << std::endl << (periodMs > 0.0 ? "Chunks spread over a 100 ms scan"
+                                                  : "Whole scan sent as one burst") << std::endl;
+        std::cout << std::left << std::setw(12) << "Mode" << std::right
+                  << std::setw(12) << "first p50" << std::setw(12) << "chunk p50"
+                  << std::setw(12) << "chunk p99" << std::setw(12) << "max (ms)" << std::endl;
+        runBatch(periodMs);
+        runStreaming(periodMs);
+    }
+
+    return 0;
+}
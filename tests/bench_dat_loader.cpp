@@ -0,0 +1,154 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include "../emulator/dat_loader.h"
+
+// Rover .dat loading: the emulator's old getline/split/stof reader against
+// the memory-mapped from_chars parser and the binary copy
+//
+// Without a file argument a synthetic one of about sizeMB is written:
+// 10 Hz frames of 20,000 points with 6 decimals, like the rover files.
+// Usage:
+//   bench_dat_loader [sizeMB=120] [file.dat]
+
+static const size_t POINTS_PER_LINE = 20000;
+
+static std::string synthesise(size_t sizeMB) {
+    std::string path = "/tmp/bench_dat_loader.dat";
+    FILE* out = fopen(path.c_str(), "w");
+    if (out == nullptr) {
+        return "";
+    }
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> coord(-500.0f, 500.0f);
+    size_t target = sizeMB * 1024 * 1024;
+    size_t written = 0;
+    for (int frame = 0; written < target; ++frame) {
+        written += static_cast<size_t>(fprintf(out, "%.6f,%.6f,%.6f,%.6f,%.6f,%.6f;",
+                                               frame * 0.1, 0.0, frame * 0.2, 0.0, 45.0, 0.0));
+        for (size_t i = 0; i < POINTS_PER_LINE; ++i) {
+            written += static_cast<size_t>(fprintf(out, "%.6f,%.6f,%.6f;", coord(rng), coord(rng), coord(rng)));
+        }
+        fputc('\n', out);
+        written++;
+    }
+    fclose(out);
+    return path;
+}
+
+// --------------------------------------------------------------------
+// The emulator's previous reader, kept as the baseline
+// --------------------------------------------------------------------
+static std::vector<std::string> splitString(const std::string& s, char delim) {
+    std::vector<std::string> tokens;
+    size_t start = 0;
+    while (true) {
+        size_t pos = s.find(delim, start);
+        if (pos == std::string::npos) {
+            tokens.push_back(s.substr(start));
+            break;
+        }
+        tokens.push_back(s.substr(start, pos - start));
+        start = pos + 1;
+    }
+    return tokens;
+}
+
+static size_t loadWithGetline(const std::string& path) {
+    std::ifstream fin(path);
+    std::string line;
+    std::vector<DatPoint> cloud;
+    size_t points = 0;
+    while (std::getline(fin, line)) {
+        size_t semicolon = line.find(';');
+        if (line.empty() || semicolon == std::string::npos) continue;
+        std::vector<std::string> pose = splitString(line.substr(0, semicolon), ',');
+        float rotZ = std::stof(pose[5]);
+        (void)rotZ;
+        cloud.clear();
+        for (const auto& token : splitString(line.substr(semicolon + 1), ';')) {
+            std::vector<std::string> coords = splitString(token, ',');
+            if (coords.size() < 3) continue;
+            cloud.push_back({std::stof(coords[0]), std::stof(coords[1]), std::stof(coords[2])});
+        }
+        points += cloud.size();
+    }
+    return points;
+}
+
+template <typename F>
+static double timeSeconds(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    size_t sizeMB = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 120;
+    std::string path = argc > 2 ? argv[2] : synthesise(sizeMB);
+    if (path.empty()) {
+        return 1;
+    }
+
+    std::ifstream probe(path, std::ios::ate | std::ios::binary);
+    double megabytes = static_cast<double>(probe.tellg()) / (1024.0 * 1024.0);
+
+    std::cout << "=== Rover Data Loader Benchmark ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(3) << path << ": " << megabytes << " MB" << std::endl << std::endl;
+    std::cout << std::left << std::setw(30) << "Loader" << std::right << std::setw(12) << "Seconds"
+              << std::setw(12) << "MB/s" << std::setw(14) << "Points" << std::endl;
+
+    auto row = [&](const char* name, double seconds, size_t points, double mb) {
+        std::cout << std::left << std::setw(30) << name << std::right << std::setw(12) << seconds
+                  << std::setw(12) << mb / seconds << std::setw(14) << points << std::endl;
+    };
+
+    size_t baselinePoints = 0;
+    double baseline = timeSeconds([&] { baselinePoints = loadWithGetline(path); });
+    row("getline + split + stof", baseline, baselinePoints, megabytes);
+
+    DatFile text;
+    double parse = timeSeconds([&] { text.load(path); });
+    row("mmap + from_chars", parse, text.pointCount(), megabytes);
+
+    std::string binaryPath = DatFile::binaryPathFor(path);
+    double convert = timeSeconds([&] { text.saveBinary(binaryPath, path); });
+    std::ifstream binaryProbe(binaryPath, std::ios::ate | std::ios::binary);
+    double binaryMB = static_cast<double>(binaryProbe.tellg()) / (1024.0 * 1024.0);
+    row("binary conversion (once)", convert, text.pointCount(), binaryMB);
+
+    DatFile binary;
+    double mapOnly = timeSeconds([&] { binary.loadPreferBinary(path); });
+    row("binary copy (map)", mapOnly, binary.pointCount(), binaryMB);
+
+    // Streaming touches every point once, as the emulator does
+    volatile double checksum = 0.0;
+    double stream = timeSeconds([&] {
+        for (size_t i = 0; i < binary.frameCount(); ++i) {
+            const DatFrame& frame = binary.frame(i);
+            const DatPoint* points = binary.points(frame);
+            double sum = 0.0;
+            for (uint32_t p = 0; p < frame.pointCount; ++p) {
+                sum += points[p].x;
+            }
+            checksum = checksum + sum;
+        }
+    });
+    row("binary copy (map + read all)", mapOnly + stream, binary.pointCount(), binaryMB);
+
+    std::cout << std::endl << "Speed-up over getline: " << std::setprecision(1) << baseline / parse
+              << "x (text), " << baseline / (mapOnly + stream) << "x (binary)"
+              << (baselinePoints == text.pointCount() && binary.isBinary() ? "" : "  MISMATCH") << std::endl;
+
+    std::remove(binaryPath.c_str());
+    if (argc <= 2) {
+        std::remove(path.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <glm/glm.hpp>
+#include "height_map.h"
+
+// Height-map ingest throughput for several rovers on one core
+//
+// Each rover drives a straight line across the map producing 10 Hz scans of
+// pointsPerScan points within 40 units of it. The run is then repeated
+// with tiles paged to a file under a resident budget, and the file is
+// reopened to time resuming. Usage:
+//   bench_height_map [pointsPerScan=20000] [rovers=5] [residentMB=16]
+
+static const double SCAN_HZ = 10.0;
+static const int SCANS_PER_ROVER = 200;
+
+static std::vector<glm::vec3> makeScan(std::mt19937& rng, glm::vec3 center, size_t points) {
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> radius(1.0f, 40.0f);
+    std::normal_distribution<float> noise(0.0f, 0.5f);
+
+    std::vector<glm::vec3> scan(points);
+    for (auto& p : scan) {
+        float a = angle(rng);
+        float r = radius(rng);
+        float x = center.x + r * std::cos(a);
+        float z = center.z + r * std::sin(a);
+        p = glm::vec3(x, 0.05f * x + 0.02f * z + noise(rng), z);
+    }
+    return scan;
+}
+
+int main(int argc, char* argv[]) {
+    size_t pointsPerScan = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 20000;
+    int rovers = argc > 2 ? std::atoi(argv[2]) : 5;
+    size_t residentMB = argc > 3 ? static_cast<size_t>(std::atol(argv[3])) : 16;
+
+    std::cout << "=== Height Map Ingest Benchmark ===" << std::endl;
+    std::cout << rovers << " rovers x " << pointsPerScan << " points/scan x " << SCAN_HZ
+              << " Hz" << std::endl;
+
+    // Pre-generate scans, interleaved by rover like the live feed
+    std::mt19937 rng(42);
+    std::vector<std::vector<glm::vec3>> scans;
+    for (int s = 0; s < SCANS_PER_ROVER; ++s) {
+        for (int r = 0; r < rovers; ++r) {
+            float lane = -400.0f + 800.0f * static_cast<float>(r) / static_cast<float>(std::max(rovers - 1, 1));
+            glm::vec3 center(-450.0f + 900.0f * s / SCANS_PER_ROVER, 0.0f, lane);
+            scans.push_back(makeScan(rng, center, pointsPerScan));
+        }
+    }
+
+    HeightMap map;
+    std::vector<uint32_t> dirty;
+    size_t dirtyTotal = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < scans.size(); ++i) {
+        map.insert(scans[i]);
+        // One frame's worth of scans, then collect dirty tiles like the mesher would
+        if ((i + 1) % static_cast<size_t>(rovers) == 0) {
+            map.takeDirtyTiles(dirty);
+            dirtyTotal += dirty.size();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const HeightMap::Stats& stats = map.getStats();
+    double rate = static_cast<double>(stats.pointsInserted) / seconds;
+    double required = static_cast<double>(rovers) * static_cast<double>(pointsPerScan) * SCAN_HZ;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Points inserted:   " << stats.pointsInserted << " ("
+              << stats.pointsOutOfBounds << " out of area)" << std::endl;
+    std::cout << "Throughput:        " << rate / 1e6 << " M points/s" << std::endl;
+    std::cout << "Required:          " << required / 1e6 << " M points/s ("
+              << rate / required << "x headroom, "
+              << 100.0 * required / rate << "% of one core)" << std::endl;
+    std::cout << "Tiles allocated:   " << stats.tilesAllocated << " of " << map.getTileCount() << std::endl;
+    std::cout << "Memory:            " << stats.memoryBytes / (1024.0 * 1024.0) << " MB (max "
+              << map.getTileCount() * 64.0 * 64.0 * sizeof(HeightMap::Cell) / (1024.0 * 1024.0)
+              << " MB for the full area)" << std::endl;
+    std::cout << "Dirty tiles/frame: " << static_cast<double>(dirtyTotal) / SCANS_PER_ROVER << std::endl;
+
+    // Rovers parked: the same ground rescanned with fresh noise. Fused heights
+    // converge, so fewer and fewer tiles need re-meshing.
+    std::cout << std::endl << "Rescanning the last positions (fused heights converging):" << std::endl;
+    std::cout << std::setw(8) << "Frames" << std::setw(14) << "Dirty tiles" << std::setw(16) << "Cell changes"
+              << std::setw(16) << "Confidence" << std::endl;
+    std::vector<std::vector<glm::vec3>> parked(scans.end() - rovers, scans.end());
+    std::vector<glm::vec3> centers;
+    for (const auto& scan : parked) {
+        glm::vec3 sum(0.0f);
+        for (const auto& p : scan) sum += p;
+        centers.push_back(sum / static_cast<float>(scan.size()));
+    }
+    const int blocks = 5, framesPerBlock = 20;
+    for (int b = 0; b < blocks; ++b) {
+        size_t blockDirty = 0;
+        size_t changesBefore = map.getStats().cellChanges;
+        size_t pointsBefore = map.getStats().pointsInserted;
+        for (int f = 0; f < framesPerBlock; ++f) {
+            for (int r = 0; r < rovers; ++r) {
+                map.insert(makeScan(rng, centers[static_cast<size_t>(r)], pointsPerScan));
+            }
+            map.takeDirtyTiles(dirty);
+            blockDirty += dirty.size();
+        }
+        const HeightMap::Cell* cell = map.cellAt(centers[0].x + 10.0f, centers[0].z);
+        std::cout << std::setw(4) << b * framesPerBlock << "-" << std::setw(3) << (b + 1) * framesPerBlock
+                  << std::setw(14) << static_cast<double>(blockDirty) / framesPerBlock
+                  << std::setw(15) << 100.0 * static_cast<double>(map.getStats().cellChanges - changesBefore) /
+                                      static_cast<double>(map.getStats().pointsInserted - pointsBefore) << "%"
+                  << std::setw(16) << (cell ? map.cellConfidence(*cell) : 0.0f) << std::endl;
+    }
+
+    // Same drive with a resident budget and a tile store
+    std::cout << std::endl << "Paged to a tile store, " << residentMB << " MB resident:" << std::endl;
+    const std::string path = "/tmp/bench_height_map.tiles";
+    std::remove(path.c_str());
+    {
+        HeightMap::Config config;
+        config.residentBudgetMB = residentMB;
+        HeightMap paged(config);
+        if (!paged.openStore(path)) {
+            return 1;
+        }
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < scans.size(); ++i) {
+            paged.insert(scans[i]);
+            if ((i + 1) % static_cast<size_t>(rovers) == 0) {
+                paged.takeDirtyTiles(dirty);
+            }
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        auto flushStart = std::chrono::steady_clock::now();
+        paged.flush();
+        double flushMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - flushStart).count();
+
+        const HeightMap::Stats& pagedStats = paged.getStats();
+        std::cout << "Throughput:        " << static_cast<double>(pagedStats.pointsInserted) / seconds / 1e6
+                  << " M points/s" << std::endl;
+        std::cout << "Tiles resident:    " << pagedStats.tilesResident << " of " << pagedStats.tilesAllocated
+                  << " (" << pagedStats.memoryBytes / (1024.0 * 1024.0) << " MB)" << std::endl;
+        std::cout << "Evicted/paged in:  " << pagedStats.tilesEvicted << " / " << pagedStats.tilesPagedIn << std::endl;
+        std::cout << "Flush:             " << flushMs << " ms" << std::endl;
+    }
+
+    // Resume: map the file and list the stored tiles, no data replayed
+    HeightMap::Config config;
+    config.residentBudgetMB = residentMB;
+    HeightMap resumed(config);
+    auto resumeStart = std::chrono::steady_clock::now();
+    bool opened = resumed.openStore(path);
+    resumed.takeDirtyTiles(dirty);
+    double resumeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - resumeStart).count();
+    const HeightMap::Cell* cell = resumed.cellAt(centers[0].x + 10.0f, centers[0].z);
+    std::cout << "Resume:            " << resumeMs << " ms, " << dirty.size() << " tiles to mesh"
+              << (opened && cell ? "" : " (FAILED)") << std::endl;
+    std::remove(path.c_str());
+
+    return 0;
+}
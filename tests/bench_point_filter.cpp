@@ -0,0 +1,120 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <cmath>
+#include "point_filter.h"
+#include "udp_packet_structures.h"
+
+// Point filter throughput, reduction and accuracy
+//
+// Scans sample a known terrain (the noise-free data, as sent with
+// --no-noise), then get the emulator's N(0, 0.5) noise on every axis plus
+// 1% gross outliers. Accuracy is the RMS height error against the
+// noise-free surface before and after filtering.
+
+static const size_t POINTS_PER_SCAN = 20000;
+static const int SCANS = 50;
+
+static float surface(float x, float z) {
+    return 3.0f * std::sin(x * 0.1f) + 2.0f * std::cos(z * 0.13f);
+}
+
+static double rmsError(const LidarPoint* points, size_t count) {
+    double sum = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double e = points[i].y - surface(points[i].x, points[i].z);
+        sum += e * e;
+    }
+    return std::sqrt(sum / static_cast<double>(count));
+}
+
+int main() {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> ground(-40.0f, 40.0f);
+    std::uniform_real_distribution<float> air(-20.0f, 30.0f);
+    std::normal_distribution<float> noise(0.0f, 0.5f);
+
+    std::vector<std::vector<LidarPoint>> scans(SCANS);
+    std::vector<std::vector<uint8_t>> isOutlier(SCANS);
+    for (int s = 0; s < SCANS; ++s) {
+        scans[s].resize(POINTS_PER_SCAN);
+        isOutlier[s].resize(POINTS_PER_SCAN);
+        for (size_t i = 0; i < POINTS_PER_SCAN; ++i) {
+            float x = ground(rng), z = ground(rng);
+            if (i % 100 == 0) {
+                scans[s][i] = { x, air(rng), z };
+                isOutlier[s][i] = 1;
+            } else {
+                scans[s][i] = { x + noise(rng), surface(x, z) + noise(rng), z + noise(rng) };
+            }
+        }
+    }
+
+    std::cout << "=== Point Filter Benchmark ===" << std::endl;
+    std::cout << SCANS << " scans x " << POINTS_PER_SCAN
+              << " points, sigma 0.5 noise, 1% outliers" << std::endl << std::endl;
+    std::cout << std::setw(8) << "Voxel" << std::setw(10) << "Mpts/s" << std::setw(10) << "us/scan"
+              << std::setw(10) << "Kept" << std::setw(10) << "Ratio" << std::setw(12) << "RMS in"
+              << std::setw(12) << "RMS out" << std::setw(12) << "Outliers" << std::endl;
+
+    double rmsIn = 0.0;
+    for (int s = 0; s < SCANS; ++s) {
+        // Noisy inliers only: what reaches the terrain without a filter
+        std::vector<LidarPoint> inliers;
+        for (size_t i = 0; i < POINTS_PER_SCAN; ++i) {
+            if (!isOutlier[s][i]) inliers.push_back(scans[s][i]);
+        }
+        rmsIn += rmsError(inliers.data(), inliers.size()) / SCANS;
+    }
+
+    for (float voxelSize : {0.5f, 1.0f, 1.5f, 2.0f}) {
+        PointFilter::Config config;
+        config.voxelSize = voxelSize;
+        PointFilter filter(config);
+
+        std::vector<LidarPoint> work(POINTS_PER_SCAN);
+        double seconds = 0.0;
+        double rmsOut = 0.0;
+        size_t kept = 0;
+        for (int s = 0; s < SCANS; ++s) {
+            work.assign(scans[s].begin(), scans[s].end());
+            auto start = std::chrono::steady_clock::now();
+            size_t n = filter.filter(work.data(), work.size());
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            rmsOut += rmsError(work.data(), n) / SCANS;
+            kept += n;
+        }
+
+        const PointFilter::Stats& stats = filter.getStats();
+        double totalPoints = static_cast<double>(SCANS * POINTS_PER_SCAN);
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(8) << voxelSize
+                  << std::setw(10) << totalPoints / seconds / 1e6
+                  << std::setw(10) << std::setprecision(0) << seconds / SCANS * 1e6
+                  << std::setw(10) << kept / SCANS
+                  << std::setw(9) << std::setprecision(1) << totalPoints / static_cast<double>(kept) << "x"
+                  << std::setw(12) << std::setprecision(3) << rmsIn
+                  << std::setw(12) << rmsOut
+                  << std::setw(12) << stats.outliersRemoved / SCANS << std::endl;
+    }
+
+    // Adaptive voxel size for a 10x reduction
+    PointFilter::Config config;
+    config.reductionFactor = 10.0f;
+    PointFilter filter(config);
+    std::vector<LidarPoint> work;
+    size_t kept = 0;
+    for (int s = 0; s < SCANS; ++s) {
+        work.assign(scans[s].begin(), scans[s].end());
+        filter.filter(work);
+        if (s >= SCANS / 2) kept += work.size();
+    }
+    std::cout << std::endl << "Adaptive (target 10x): voxel " << std::setprecision(2) << filter.getVoxelSize()
+              << ", ratio " << std::setprecision(1)
+              << static_cast<double>((SCANS - SCANS / 2) * POINTS_PER_SCAN) / static_cast<double>(kept)
+              << "x" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,208 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <glm/glm.hpp>
+#include "packet_log.h"
+#include "lidar_assembler.h"
+#include "height_map.h"
+
+// Maximum sustainable throughput of the ingest stages, from a packet log
+//
+// Replays a log as fast as possible through decode only, decode + scan
+// assembly, and decode + assembly + height-map integration, then once at
+// 10x to check pacing. Without a log argument, one is synthesised: rovers
+// driving at 10 Hz with 20,000-point scans in 100-point chunks, like the
+// emulator. Usage:
+//   bench_replay [seconds=5] [log]
+
+static const uint32_t ROVERS = 5;
+static const uint32_t POINTS_PER_SCAN = 20000;
+static const double SCAN_HZ = 10.0;
+
+static std::string synthesise(double seconds) {
+    std::string path = "/tmp/bench_replay.pktlog";
+    std::remove(path.c_str());
+
+    PacketRecorder recorder;
+    if (!recorder.open(path)) {
+        return "";
+    }
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> radius(1.0f, 40.0f);
+    std::normal_distribution<float> noise(0.0f, 0.5f);
+
+    const uint32_t chunks = (POINTS_PER_SCAN + MAX_LIDAR_POINTS_PER_PACKET - 1) / MAX_LIDAR_POINTS_PER_PACKET;
+    const int frames = static_cast<int>(seconds * SCAN_HZ);
+    const uint64_t startNs = realtimeNowNs();
+    LidarPacket lidar;
+
+    for (int f = 0; f < frames; ++f) {
+        double timestamp = f / SCAN_HZ;
+        uint64_t frameNs = startNs + static_cast<uint64_t>(timestamp * 1e9);
+
+        for (uint32_t rover = 1; rover <= ROVERS; ++rover) {
+            // Rovers leave the centre on different headings at 2 units/s
+            float heading = 6.2831853f * static_cast<float>(rover) / ROVERS;
+            float px = 2.0f * static_cast<float>(timestamp) * std::cos(heading);
+            float pz = 2.0f * static_cast<float>(timestamp) * std::sin(heading);
+            uint64_t roverNs = frameNs + rover * 1000000ull;
+
+            PosePacket pose = {timestamp, px, 0.0f, pz, 0.0f, 0.0f, heading * 57.29578f};
+            recorder.record(rover, StreamKind::Pose, reinterpret_cast<const uint8_t*>(&pose), sizeof(pose), roverNs);
+
+            // Chunks spread over 5 ms, points relative to the rover
+            uint32_t remaining = POINTS_PER_SCAN;
+            for (uint32_t c = 0; c < chunks; ++c) {
+                uint32_t count = std::min(remaining, static_cast<uint32_t>(MAX_LIDAR_POINTS_PER_PACKET));
+                lidar.header = {timestamp, c, chunks, count};
+                for (uint32_t i = 0; i < count; ++i) {
+                    float a = angle(rng), r = radius(rng);
+                    float x = r * std::cos(a), z = r * std::sin(a);
+                    lidar.points[i] = {x, 0.05f * (px + x) + noise(rng), z};
+                }
+                remaining -= count;
+                recorder.record(rover, StreamKind::Lidar, reinterpret_cast<const uint8_t*>(&lidar),
+                                sizeof(LidarPacketHeader) + count * sizeof(LidarPoint),
+                                roverNs + 1000000ull + c * 25000ull);
+            }
+
+            VehicleTelem telem = {timestamp, 0};
+            recorder.record(rover, StreamKind::Telemetry, reinterpret_cast<const uint8_t*>(&telem),
+                            sizeof(telem), roverNs + 7000000ull);
+        }
+    }
+    if (recorder.getStats().droppedRecords > 0) {
+        std::cerr << "Warning: recorder dropped " << recorder.getStats().droppedRecords << " datagrams" << std::endl;
+    }
+    return path;
+}
+
+// Decode only: counts points
+class DecodeHandler : public IngestHandler {
+public:
+    void onLidar(uint32_t, const LidarPacket& packet, uint64_t) override {
+        points += packet.header.pointsInThisChunk;
+    }
+    size_t points = 0;
+};
+
+// One LidarAssembler per rover, scans drained inline and optionally
+// integrated (translated by the latest pose) into a height map
+class AssembleHandler : public IngestHandler {
+public:
+    explicit AssembleHandler(HeightMap* map) : map_(map), poses_(ROVERS + 1) {
+        for (uint32_t id = 0; id <= ROVERS; ++id) {
+            LidarAssembler::Config config;
+            config.roverId = id;
+            config.maxChunksPerScan = 256;
+            assemblers_.push_back(std::make_unique<LidarAssembler>(config));
+        }
+    }
+
+    void onPose(uint32_t roverId, const PosePacket& pose, uint64_t) override {
+        if (roverId <= ROVERS) poses_[roverId] = glm::vec3(pose.posX, pose.posY, pose.posZ);
+    }
+
+    void onLidar(uint32_t roverId, const LidarPacket& packet, uint64_t arrivalNs) override {
+        if (roverId > ROVERS) return;
+        LidarAssembler& assembler = *assemblers_[roverId];
+        if (!assembler.addPacket(packet, arrivalNs)) return;
+
+        while (assembler.getCompleteScan(scan_)) {
+            scans++;
+            points += scan_.pointCount();
+            if (map_ != nullptr) {
+                world_.resize(scan_.pointCount());
+                const LidarPoint* p = scan_.points();
+                for (size_t i = 0; i < world_.size(); ++i) {
+                    world_[i] = poses_[roverId] + glm::vec3(p[i].x, p[i].y, p[i].z);
+                }
+                map_->insert(world_);
+            }
+            scan_.reset();
+        }
+    }
+
+    size_t scans = 0;
+    size_t points = 0;
+
+private:
+    HeightMap* map_;
+    std::vector<glm::vec3> poses_;
+    std::vector<std::unique_ptr<LidarAssembler>> assemblers_;
+    std::vector<glm::vec3> world_;
+    ScanHandle scan_;
+};
+
+static void printRow(const char* stage, const PacketReplayer& replayer, size_t points, size_t scans) {
+    const PacketReplayer::Stats& stats = replayer.getStats();
+    double seconds = stats.runSeconds;
+    double recorded = static_cast<double>(replayer.getDurationNs()) / 1e9;
+    std::cout << std::left << std::setw(26) << stage << std::right
+              << std::setw(12) << static_cast<double>(stats.records) / seconds / 1e3
+              << std::setw(12) << static_cast<double>(points) / seconds / 1e6
+              << std::setw(10) << scans
+              << std::setw(12) << recorded / seconds << "x" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    double seconds = argc > 1 ? std::atof(argv[1]) : 5.0;
+    std::string path = argc > 2 ? argv[2] : synthesise(seconds);
+    bool synthesised = argc <= 2;
+
+    PacketReplayer replayer;
+    if (path.empty() || !replayer.open(path)) {
+        return 1;
+    }
+
+    std::cout << "=== Packet Replay Benchmark ===" << std::endl;
+    std::cout << replayer.getRecordCount() << " datagrams spanning "
+              << std::fixed << std::setprecision(2)
+              << static_cast<double>(replayer.getDurationNs()) / 1e9 << " s" << std::endl << std::endl;
+
+    std::cout << std::left << std::setw(26) << "Stage (as fast as possible)" << std::right
+              << std::setw(12) << "k dgram/s" << std::setw(12) << "M points/s"
+              << std::setw(10) << "Scans" << std::setw(13) << "Realtime" << std::endl;
+
+    // Page the log in so the first stage does not pay for disk reads
+    DecodeHandler warm;
+    replayer.setDefaultHandler(warm);
+    replayer.run(0.0);
+
+    DecodeHandler decode;
+    replayer.setDefaultHandler(decode);
+    replayer.run(0.0);
+    printRow("Decode", replayer, decode.points, 0);
+
+    AssembleHandler assemble(nullptr);
+    replayer.setDefaultHandler(assemble);
+    replayer.run(0.0);
+    printRow("Decode + assemble", replayer, assemble.points, assemble.scans);
+
+    HeightMap map;
+    AssembleHandler integrate(&map);
+    replayer.setDefaultHandler(integrate);
+    replayer.run(0.0);
+    printRow("Decode + assemble + map", replayer, integrate.points, integrate.scans);
+
+    // Paced: how closely 10x follows the recorded schedule
+    DecodeHandler paced;
+    replayer.setDefaultHandler(paced);
+    replayer.run(10.0);
+    std::cout << std::endl << "10x replay: " << replayer.getStats().runSeconds << " s for "
+              << static_cast<double>(replayer.getDurationNs()) / 1e9 << " s recorded, max lag "
+              << replayer.getStats().maxLagMs << " ms" << std::endl;
+
+    if (synthesised) {
+        std::remove(path.c_str());
+    }
+    return 0;
+}
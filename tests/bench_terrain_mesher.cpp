@@ -0,0 +1,115 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <thread>
+#include <cmath>
+#include <cstdlib>
+#include <glm/glm.hpp>
+#include "height_map.h"
+#include "terrain_mesher.h"
+
+// Per-frame cost of incremental terrain meshing vs re-meshing everything
+//
+// 5 rovers drive across the site; every frame each adds one 20k-point scan
+// to the height map, then the changed tiles are meshed on the worker pool.
+// At the end the whole map is meshed in one frame for comparison.
+// Usage: bench_terrain_mesher [workers=2]
+
+static const int ROVERS = 5;
+static const int FRAMES = 150;
+static const size_t POINTS_PER_SCAN = 20000;
+
+static std::vector<glm::vec3> makeScan(std::mt19937& rng, glm::vec3 center) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    std::vector<glm::vec3> scan(POINTS_PER_SCAN);
+    for (auto& p : scan) {
+        float a = 6.2831853f * unit(rng);
+        float r = 1.0f + 39.0f * unit(rng);
+        float x = center.x + r * std::cos(a);
+        float z = center.z + r * std::sin(a);
+        p = glm::vec3(x, 2.0f * std::sin(x * 0.05f) + std::cos(z * 0.07f) + noise(rng), z);
+    }
+    return scan;
+}
+
+static TerrainMesher::MeshFrame collect(TerrainMesher& mesher) {
+    TerrainMesher::MeshFrame frame;
+    // The render thread would just try again next frame; here we spin
+    while (!mesher.takeFrame(frame)) {
+        std::this_thread::yield();
+    }
+    return frame;
+}
+
+int main(int argc, char* argv[]) {
+    TerrainMesher::Config config;
+    config.workerCount = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 2;
+
+    std::cout << "=== Terrain Meshing Benchmark ===" << std::endl;
+    std::cout << ROVERS << " rovers x " << POINTS_PER_SCAN << " points per frame, "
+              << config.workerCount << " workers" << std::endl << std::endl;
+
+    std::mt19937 rng(3);
+    std::vector<std::vector<glm::vec3>> scans;
+    for (int f = 0; f < FRAMES; ++f) {
+        for (int r = 0; r < ROVERS; ++r) {
+            glm::vec3 center(-300.0f + 4.0f * f, 0.0f, -300.0f + 150.0f * r);
+            scans.push_back(makeScan(rng, center));
+        }
+    }
+
+    HeightMap map;
+    TerrainMesher mesher(map, config);
+    mesher.start();
+
+    std::vector<double> meshingMs;
+    double tilesSum = 0.0, trianglesSum = 0.0, snapshotSum = 0.0;
+    for (int f = 0; f < FRAMES; ++f) {
+        for (int r = 0; r < ROVERS; ++r) {
+            map.insert(scans[static_cast<size_t>(f * ROVERS + r)]);
+        }
+        if (mesher.beginFrame() == 0) continue;
+        TerrainMesher::MeshFrame frame = collect(mesher);
+        meshingMs.push_back(frame.stats.meshingMs);
+        tilesSum += static_cast<double>(frame.stats.tilesRebuilt);
+        trianglesSum += static_cast<double>(frame.stats.triangles);
+        snapshotSum += frame.stats.snapshotMs;
+    }
+    std::sort(meshingMs.begin(), meshingMs.end());
+    double frames = static_cast<double>(meshingMs.size());
+    double avgMs = 0.0;
+    for (double ms : meshingMs) avgMs += ms;
+    avgMs /= frames;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Incremental (per frame, " << meshingMs.size() << " frames):" << std::endl;
+    std::cout << "  Meshing ms:      avg " << avgMs
+              << ", p99 " << meshingMs[static_cast<size_t>(frames * 0.99)]
+              << ", max " << meshingMs.back()
+              << " (snapshot avg " << snapshotSum / frames << ")" << std::endl;
+    std::cout << "  Tiles rebuilt:   " << tilesSum / frames << " of "
+              << map.getStats().tilesAllocated << " allocated" << std::endl;
+    std::cout << "  Triangles:       " << std::setprecision(0) << trianglesSum / frames << std::endl;
+
+    // Same points in a fresh map: every tile is dirty at once
+    HeightMap fullMap;
+    for (const auto& scan : scans) {
+        fullMap.insert(scan);
+    }
+    TerrainMesher fullMesher(fullMap, config);
+    fullMesher.start();
+    fullMesher.beginFrame();
+    TerrainMesher::MeshFrame full = collect(fullMesher);
+
+    std::cout << std::setprecision(2);
+    std::cout << "Full re-mesh:" << std::endl;
+    std::cout << "  Meshing ms:      " << full.stats.meshingMs << std::endl;
+    std::cout << "  Tiles rebuilt:   " << full.stats.tilesRebuilt << std::endl;
+    std::cout << "  Triangles:       " << full.stats.triangles << std::endl;
+    std::cout << "  Incremental avg is " << full.stats.meshingMs / avgMs << "x cheaper" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cmath>
+#include <glm/glm.hpp>
+#include "transform.h"
+#include "transform_kernels.h"
+#include "udp_packet_structures.h"
+
+// Micro-benchmark: per-point GLM path vs batch transform kernels
+//
+// The GLM path is Transform::transformLidarPoint() per point with
+// push_back into a fresh vector (the pre-kernel transformLidarPoints()).
+// The kernels write into a preallocated buffer, AoS or SoA.
+
+static volatile float g_sink;
+
+template <typename Fn>
+static double bestNsPerPoint(size_t count, Fn&& fn) {
+    int repeats = count >= 1000000 ? 5 : 20;
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, ns);
+    }
+    return best / static_cast<double>(count);
+}
+
+int main() {
+    glm::mat4 transform = Transform::createTransform(glm::vec3(12.0f, -3.0f, 40.0f),
+                                                     glm::vec3(5.0f, 30.0f, -10.0f));
+    AffineTransform affine = Transform::toAffine(transform);
+
+    std::cout << "=== Point Transform Benchmark ===" << std::endl;
+    std::cout << "Dispatched kernel: " << simdLevelName(detectSimdLevel()) << std::endl;
+    std::cout << "(ns per point, best of several runs)" << std::endl << std::endl;
+    std::cout << std::setw(10) << "Points" << std::setw(10) << "GLM"
+              << std::setw(10) << "scalar" << std::setw(10) << "sse" << std::setw(10) << "avx2"
+              << std::setw(10) << "avx2 SoA" << std::setw(10) << "Speedup" << std::endl;
+
+    for (size_t count : {10000u, 100000u, 1000000u}) {
+        std::vector<LidarPoint> points(count);
+        for (size_t i = 0; i < count; ++i) {
+            float f = static_cast<float>(i);
+            points[i] = { std::sin(f) * 50.0f, std::cos(f) * 50.0f, f * 0.001f };
+        }
+        std::vector<LidarPoint> out(count);
+        std::vector<float> x(count), y(count), z(count);
+
+        double glmNs = bestNsPerPoint(count, [&]() {
+            std::vector<glm::vec3> world;
+            world.reserve(points.size());
+            for (const auto& point : points) {
+                world.push_back(Transform::transformLidarPoint(transform, point));
+            }
+            g_sink = world.back().x;
+        });
+
+        double levelNs[3];
+        const SimdLevel levels[3] = { SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2 };
+        for (int l = 0; l < 3; ++l) {
+            levelNs[l] = bestNsPerPoint(count, [&]() {
+                transformPoints(affine, points.data(), count, out.data(), levels[l]);
+                g_sink = out.back().x;
+            });
+        }
+
+        double soaNs = bestNsPerPoint(count, [&]() {
+            transformPointsSoA(affine, points.data(), count, x.data(), y.data(), z.data(),
+                               SimdLevel::AVX2);
+            g_sink = x.back();
+        });
+
+        double bestNs = levelNs[static_cast<int>(detectSimdLevel())];
+        std::cout << std::setw(10) << count << std::fixed << std::setprecision(3)
+                  << std::setw(10) << glmNs << std::setw(10) << levelNs[0]
+                  << std::setw(10) << levelNs[1] << std::setw(10) << levelNs[2]
+                  << std::setw(10) << soaNs
+                  << std::setw(9) << std::setprecision(1) << glmNs / bestNs << "x" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,201 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "udp_receiver.h"
+#include "udp_packet_structures.h"
+
+// Loopback benchmark: a raw recvfrom() loop (baseline) vs UDPReceiver's
+// receive() (one recvmmsg call per datagram) vs receiveBatch() (up to
+// BURST_SIZE datagrams per recvmmsg call)
+//
+// A sender thread emits bursts of full-size LidarPacket datagrams (like one
+// rover scan) and waits for the receiver to drain each burst, so the kernel
+// queue never overflows and every path sees the same traffic. A burst not
+// drained within DRAIN_TIMEOUT_MS (datagrams lost) ends the run early.
+
+static const uint16_t BENCH_PORT = 19999;
+static const size_t BURST_SIZE = 64;
+static const int DRAIN_TIMEOUT_MS = 1000;
+
+struct BenchResult {
+    size_t packets;
+    double wallSeconds;
+    double cpuSeconds;
+};
+
+static double threadCpuSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+static void runSender(size_t totalPackets, const std::atomic<size_t>& received) {
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) {
+        std::cerr << "Error creating sender socket" << std::endl;
+        return;
+    }
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(BENCH_PORT);
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+    LidarPacket packet;
+    memset(&packet, 0, sizeof(packet));
+    packet.header.totalChunks = BURST_SIZE;
+    packet.header.pointsInThisChunk = MAX_LIDAR_POINTS_PER_PACKET;
+
+    size_t sent = 0;
+    while (sent < totalPackets) {
+        for (size_t i = 0; i < BURST_SIZE && sent < totalPackets; ++i, ++sent) {
+            packet.header.chunkIndex = static_cast<uint32_t>(i);
+            sendto(sock, &packet, sizeof(packet), 0, (struct sockaddr*)&addr, sizeof(addr));
+        }
+        // Wait for the receiver to drain this burst
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(DRAIN_TIMEOUT_MS);
+        while (received.load(std::memory_order_acquire) < sent &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        if (received.load(std::memory_order_acquire) < sent) {
+            std::cerr << "Burst not drained within " << DRAIN_TIMEOUT_MS << " ms, stopping early" << std::endl;
+            break;
+        }
+    }
+
+    // 1-byte datagram tells the receiver to stop
+    uint8_t stop = 0;
+    sendto(sock, &stop, sizeof(stop), 0, (struct sockaddr*)&addr, sizeof(addr));
+    close(sock);
+}
+
+// Times drain(received), which receives until the stop datagram while the
+// sender runs; drain also returns when a receive times out
+template <typename Drain>
+static BenchResult runBench(size_t totalPackets, Drain drain) {
+    std::atomic<size_t> received(0);
+
+    auto start = std::chrono::steady_clock::now();
+    double cpuStart = threadCpuSeconds();
+    std::thread sender(runSender, totalPackets, std::cref(received));
+
+    drain(received);
+
+    double cpuEnd = threadCpuSeconds();
+    auto end = std::chrono::steady_clock::now();
+    sender.join();
+
+    return { received.load(), std::chrono::duration<double>(end - start).count(), cpuEnd - cpuStart };
+}
+
+static BenchResult benchRecvfrom(int fd, size_t totalPackets) {
+    uint8_t buffer[MAX_DATAGRAM_SIZE];
+    return runBench(totalPackets, [fd, &buffer](std::atomic<size_t>& received) {
+        while (true) {
+            sockaddr_in sender;
+            socklen_t senderLen = sizeof(sender);
+            ssize_t bytes = recvfrom(fd, buffer, sizeof(buffer), 0,
+                                     reinterpret_cast<sockaddr*>(&sender), &senderLen);
+            if (bytes <= 1) break;   // Stop datagram, timeout or error
+            if (bytes == sizeof(LidarPacket)) {
+                received.fetch_add(1, std::memory_order_release);
+            }
+        }
+    });
+}
+
+static BenchResult benchSingle(UDPReceiver& receiver, size_t totalPackets) {
+    uint8_t buffer[MAX_DATAGRAM_SIZE];
+    return runBench(totalPackets, [&receiver, &buffer](std::atomic<size_t>& received) {
+        while (true) {
+            ssize_t bytes = receiver.receive(buffer, sizeof(buffer));
+            if (bytes <= 1) break;   // Stop datagram, timeout or error
+            if (bytes == sizeof(LidarPacket)) {
+                received.fetch_add(1, std::memory_order_release);
+            }
+        }
+    });
+}
+
+static BenchResult benchBatch(UDPReceiver& receiver, size_t totalPackets) {
+    ReceiveBatch batch(BURST_SIZE);
+    return runBench(totalPackets, [&receiver, &batch](std::atomic<size_t>& received) {
+        bool done = false;
+        while (!done) {
+            int count = receiver.receiveBatch(batch);
+            if (count <= 0) break;   // Timeout or error
+            size_t packets = 0;
+            for (int i = 0; i < count; ++i) {
+                if (batch.length(i) == 1) {
+                    done = true;
+                } else if (batch.length(i) == sizeof(LidarPacket)) {
+                    packets++;
+                }
+            }
+            received.fetch_add(packets, std::memory_order_release);
+        }
+    });
+}
+
+static void printResult(const char* name, const BenchResult& result) {
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << std::left << std::setw(16) << name
+              << std::right << std::setw(12) << (result.packets / result.wallSeconds) << " pkt/s"
+              << std::setprecision(1)
+              << std::setw(10) << (result.cpuSeconds * 1e9 / result.packets) << " ns CPU/pkt"
+              << " (" << result.packets << " packets)" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    size_t totalPackets = 500000;
+    if (argc > 1) {
+        totalPackets = static_cast<size_t>(std::strtoul(argv[1], nullptr, 10));
+    }
+
+    std::cout << "=== UDP Receive Benchmark (loopback port " << BENCH_PORT << ") ===" << std::endl;
+    std::cout << "Bursts of " << BURST_SIZE << " x " << sizeof(LidarPacket) << " byte datagrams\n" << std::endl;
+
+    UDPReceiver receiver(BENCH_PORT);
+    if (!receiver.isValid()) {
+        std::cerr << "Failed to create UDP receiver on port " << BENCH_PORT << std::endl;
+        return 1;
+    }
+
+    // Blocking receives give up after the drain timeout, so a lost stop
+    // datagram cannot hang the benchmark
+    struct timeval timeout = { DRAIN_TIMEOUT_MS / 1000, (DRAIN_TIMEOUT_MS % 1000) * 1000 };
+    setsockopt(receiver.getFd(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    BenchResult raw = benchRecvfrom(receiver.getFd(), totalPackets);
+    BenchResult single = benchSingle(receiver, totalPackets);
+    BenchResult batch = benchBatch(receiver, totalPackets);
+
+    printResult("recvfrom()", raw);
+    printResult("receive()", single);
+    printResult("receiveBatch()", batch);
+
+    double rawCpu = raw.cpuSeconds / raw.packets;
+    std::cout << std::setprecision(2);
+    std::cout << "\nCPU per packet vs recvfrom(): receive() "
+              << rawCpu / (single.cpuSeconds / single.packets) << "x, receiveBatch() "
+              << rawCpu / (batch.cpuSeconds / batch.packets) << "x" << std::endl;
+
+    bool complete = raw.packets == totalPackets && single.packets == totalPackets &&
+                    batch.packets == totalPackets;
+    if (!complete) {
+        std::cerr << "Some runs ended early (datagrams lost)" << std::endl;
+    }
+    return complete ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <glm/glm.hpp>
+#include "transform.h"
+#include "voxel_map.h"
+#include "udp_packet_structures.h"
+
+// Voxel map insert throughput and memory
+//
+// 5 rovers drive across the site producing 10 Hz scans (ground ring plus a
+// wall segment, in sweep order). Each scan goes through Transform::transformLidarPoints()
+// and the resulting vector is inserted in bulk, for a few voxel sizes.
+
+static const int ROVERS = 5;
+static const int SCANS_PER_ROVER = 100;
+static const size_t POINTS_PER_SCAN = 20000;
+static const double SCAN_HZ = 10.0;
+
+static std::vector<LidarPoint> makeLocalScan(std::mt19937& rng) {
+    std::uniform_real_distribution<float> radius(1.0f, 40.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::normal_distribution<float> noise(0.0f, 0.03f);
+
+    // Points come in sweep order, like a spinning sensor
+    std::vector<LidarPoint> scan(POINTS_PER_SCAN);
+    for (size_t i = 0; i < scan.size(); ++i) {
+        float a = 6.2831853f * static_cast<float>(i) / static_cast<float>(scan.size());
+        if (i % 10 == 0) {
+            // Wall 15 units ahead, 4 units tall
+            scan[i] = { unit(rng) * 20.0f - 10.0f, unit(rng) * 4.0f - 1.5f, 15.0f + noise(rng) };
+        } else {
+            float r = radius(rng);
+            scan[i] = { r * std::cos(a), -1.5f + noise(rng), r * std::sin(a) };
+        }
+    }
+    return scan;
+}
+
+int main() {
+    std::cout << "=== Voxel Map Benchmark ===" << std::endl;
+    std::cout << ROVERS << " rovers x " << POINTS_PER_SCAN << " points/scan x " << SCAN_HZ
+              << " Hz, " << SCANS_PER_ROVER << " scans each" << std::endl;
+
+    // World-space scans, interleaved by rover like the live feed
+    std::mt19937 rng(7);
+    std::vector<std::vector<glm::vec3>> scans;
+    double transformSeconds = 0.0;
+    for (int s = 0; s < SCANS_PER_ROVER; ++s) {
+        for (int r = 0; r < ROVERS; ++r) {
+            std::vector<LidarPoint> local = makeLocalScan(rng);
+            glm::mat4 pose = Transform::createTransform(
+                glm::vec3(-200.0f + 4.0f * s, 0.0f, -200.0f + 100.0f * r),
+                glm::vec3(0.0f, 90.0f, 0.0f));
+            auto start = std::chrono::steady_clock::now();
+            scans.push_back(Transform::transformLidarPoints(pose, local));
+            transformSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+    double totalPoints = static_cast<double>(scans.size() * POINTS_PER_SCAN);
+    double required = ROVERS * POINTS_PER_SCAN * SCAN_HZ;
+    std::cout << "Transform: " << std::fixed << std::setprecision(1)
+              << totalPoints / transformSeconds / 1e6 << " M points/s" << std::endl << std::endl;
+
+    std::cout << std::setw(8) << "Voxel" << std::setw(8) << "Levels" << std::setw(12) << "Mpts/s"
+              << std::setw(10) << "Headroom" << std::setw(10) << "Blocks" << std::setw(10) << "MB"
+              << std::setw(12) << "MB/Mpts" << std::endl;
+
+    for (float voxelSize : {0.1f, 0.2f, 0.5f}) {
+        VoxelMap::Config config;
+        config.voxelSize = voxelSize;
+        VoxelMap map(config);
+
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& scan : scans) {
+            map.insert(scan);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        size_t blocks = 0;
+        for (uint32_t l = 0; l < map.getLevelCount(); ++l) {
+            blocks += map.getBlockCount(l);
+        }
+        double mb = static_cast<double>(map.getStats().memoryBytes) / (1024.0 * 1024.0);
+        double rate = totalPoints / seconds;
+
+        std::cout << std::setprecision(2)
+                  << std::setw(8) << voxelSize << std::setw(8) << map.getLevelCount()
+                  << std::setw(12) << rate / 1e6 << std::setw(9) << rate / required << "x"
+                  << std::setw(10) << blocks << std::setw(10) << mb
+                  << std::setw(12) << mb / (totalPoints / 1e6) << std::endl;
+    }
+
+    return 0;
+}
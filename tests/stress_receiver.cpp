@@ -0,0 +1,137 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <cstdlib>
+#include "ingest_reactor.h"
+#include "assembler_pool.h"
+#include "latency_stats.h"
+
+// Receiver side of the emulator stress sweep (stress_sweep.sh)
+//
+// Listens on the ports of rovers 1..N, assembles their scans in an
+// AssemblerPool (partial scans emitted after the usual deadline) and
+// drains them on a consumer thread. Every pose packet stands for one scan
+// the emulator sent, so expected - complete scans is what the receiver
+// lost. Latency is first chunk arrival -> scan in the consumer's hands.
+// Start the emulators with a --duration shorter than the listening time so
+// every scan they send is counted. Ends with one machine-readable line:
+//   RESULT rovers=.. expected=.. complete=.. partial=.. drop_pct=.. p99_ms=.. max_ms=..
+// Usage:
+//   stress_receiver <rovers> <seconds> [pointMultiplier=1]
+
+// Counts poses per rover and hands LiDAR chunks to the pool
+class StressHandler : public IngestHandler {
+public:
+    StressHandler(AssemblerPool& pool, uint32_t rovers) : pool_(pool), poses_(rovers + 1, 0) {}
+
+    void onPose(uint32_t roverId, const PosePacket&, uint64_t) override {
+        if (roverId < poses_.size()) poses_[roverId]++;
+    }
+
+    void onLidar(uint32_t roverId, const LidarPacket& packet, uint64_t arrivalNs) override {
+        pool_.onLidar(roverId, packet, arrivalNs);
+    }
+
+    size_t expectedScans() const {
+        size_t total = 0;
+        for (size_t count : poses_) total += count;
+        return total;
+    }
+
+private:
+    AssemblerPool& pool_;
+    std::vector<size_t> poses_;   // Only touched by the reactor thread
+};
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <rovers> <seconds> [pointMultiplier=1]" << std::endl;
+        return 1;
+    }
+    uint32_t rovers = static_cast<uint32_t>(std::atoi(argv[1]));
+    double seconds = std::atof(argv[2]);
+    uint32_t multiplier = argc > 3 ? static_cast<uint32_t>(std::atoi(argv[3])) : 1;
+    if (rovers == 0 || seconds <= 0.0 || multiplier == 0) {
+        std::cerr << "Error: rovers, seconds and pointMultiplier must be positive" << std::endl;
+        return 1;
+    }
+
+    AssemblerPool::Config config;
+    config.pinWorkers = false;
+    config.inboxDepth = 1024;
+    config.assembler.maxChunksPerScan = 256 * multiplier;
+    config.assembler.emitPartialScans = true;
+    config.assembler.minCompleteness = 0.0f;
+    AssemblerPool pool(config);
+    for (uint32_t id = 1; id <= rovers; ++id) {
+        pool.addRover(id);
+    }
+
+    StressHandler handler(pool, rovers);
+    IngestReactor reactor;
+    for (const RoverPorts& ports : IngestReactor::portsForRovers(rovers)) {
+        if (!reactor.addRover(ports, handler)) {
+            return 1;
+        }
+    }
+
+    pool.start();
+    std::thread reactorThread([&reactor]() { reactor.run(); });
+
+    LatencyHistogram latency;
+    std::atomic<bool> done(false);
+    std::atomic<size_t> complete(0), partial(0);
+    std::thread consumer([&]() {
+        ScanHandle scan;
+        while (!done.load(std::memory_order_relaxed)) {
+            bool any = false;
+            for (uint32_t id = 1; id <= rovers; ++id) {
+                while (pool.getCompleteScan(id, scan)) {
+                    uint64_t now = realtimeNowNs();
+                    if (now > scan.firstChunkArrivalNs()) {
+                        latency.record(now - scan.firstChunkArrivalNs());
+                    }
+                    (scan.isComplete() ? complete : partial)++;
+                    scan.reset();
+                    any = true;
+                }
+            }
+            if (!any) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+    });
+
+    std::cout << "Listening for " << rovers << " rovers for " << seconds << " s" << std::endl;
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+
+    reactor.stop();
+    reactorThread.join();
+    // Let the last partial scans pass their deadline and reach the consumer
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    done.store(true);
+    consumer.join();
+    pool.stop();
+
+    const IngestReactor::Stats& ingest = reactor.getStats();
+    AssemblerPool::Stats stats = pool.getStats();
+    size_t expected = handler.expectedScans();
+    double dropPct = expected > 0
+        ? 100.0 * static_cast<double>(expected - std::min(expected, complete.load())) / expected : 0.0;
+
+    std::cout << "Datagrams: " << ingest.datagrams << " (" << ingest.malformedPackets << " malformed), "
+              << "inbox drops: " << stats.inboxDrops << ", assembler drops: " << stats.droppedChunks
+              << ", scans evicted: " << stats.droppedScans << std::endl;
+    std::cout << std::fixed << std::setprecision(2)
+              << "RESULT rovers=" << rovers
+              << " expected=" << expected
+              << " complete=" << complete.load()
+              << " partial=" << partial.load()
+              << " drop_pct=" << dropPct
+              << " p99_ms=" << static_cast<double>(latency.percentile(99.0)) / 1e6
+              << " max_ms=" << static_cast<double>(latency.max()) / 1e6 << std::endl;
+    return 0;
+}
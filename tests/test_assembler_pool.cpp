@@ -0,0 +1,134 @@
+#include <iostream>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include "assembler_pool.h"
+#include "udp_packet_structures.h"
+#include "../emulator/rover_profiles.h"
+#include "test_check.h"
+
+// Chunk of a scan whose points carry the rover ID in x
+static LidarPacket makeChunk(uint32_t roverId, double timestamp, uint32_t index, uint32_t total) {
+    LidarPacket packet;
+    memset(&packet, 0, sizeof(packet));
+    packet.header.timestamp = timestamp;
+    packet.header.chunkIndex = index;
+    packet.header.totalChunks = total;
+    packet.header.pointsInThisChunk = MAX_LIDAR_POINTS_PER_PACKET;
+    for (size_t i = 0; i < MAX_LIDAR_POINTS_PER_PACKET; ++i) {
+        packet.points[i] = { static_cast<float>(roverId), static_cast<float>(index), 0.0f };
+    }
+    return packet;
+}
+
+// Wait (bounded) for a rover's next scan
+static bool waitForScan(AssemblerPool& pool, uint32_t roverId, ScanHandle& scan) {
+    for (int i = 0; i < 2000; ++i) {
+        if (pool.getCompleteScan(roverId, scan)) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+static AssemblerPool::Config testConfig() {
+    AssemblerPool::Config config;
+    config.pinWorkers = false;
+    return config;
+}
+
+static void testRoversWithSameTimestamp() {
+    AssemblerPool pool(testConfig());
+    bool added[3] = { pool.addRover(1), pool.addRover(2), pool.addRover(2) };
+    CHECK(added[0] && added[1] && !added[2]);
+    pool.start();
+
+    // Two rovers interleave chunks of scans with identical timestamps
+    for (uint32_t chunk = 0; chunk < 4; ++chunk) {
+        pool.onLidar(1, makeChunk(1, 7.5, chunk, 4), 100);
+        pool.onLidar(2, makeChunk(2, 7.5, 3 - chunk, 4), 200);
+    }
+
+    for (uint32_t roverId = 1; roverId <= 2; ++roverId) {
+        ScanHandle scan;
+        bool arrived = waitForScan(pool, roverId, scan);
+        CHECK(arrived);
+        CHECK(scan.roverId() == roverId);
+        CHECK(scan.isComplete() && scan.pointCount() == 4 * MAX_LIDAR_POINTS_PER_PACKET);
+        for (size_t i = 0; i < scan.pointCount(); ++i) {
+            CHECK(scan.points()[i].x == static_cast<float>(roverId));
+        }
+    }
+
+    pool.stop();
+    AssemblerPool::Stats stats = pool.getStats();
+    CHECK(stats.rovers == 2);
+    CHECK(stats.chunksReceived == 8 && stats.scansCompleted == 2);
+    std::cout << "  Rovers sharing a timestamp stay separate: OK\n";
+}
+
+static void testUnknownRover() {
+    AssemblerPool pool(testConfig());
+    bool added = pool.addRover(3);
+    CHECK(added);
+
+    pool.onLidar(9, makeChunk(9, 1.0, 0, 1), 0);
+    ScanHandle scan;
+    bool taken = pool.getCompleteScan(9, scan);
+    CHECK(!taken);
+    CHECK(pool.getAssembler(9) == nullptr);
+    CHECK(pool.getStats().unknownRoverChunks == 1);
+    std::cout << "  Unknown rover counted and ignored: OK\n";
+}
+
+static void testInboxOverflow() {
+    AssemblerPool::Config config = testConfig();
+    config.inboxDepth = 4;
+    AssemblerPool pool(config);
+    pool.addRover(1);
+
+    // Workers not running yet: the inbox fills and sheds the rest
+    for (uint32_t chunk = 0; chunk < 6; ++chunk) {
+        pool.onLidar(1, makeChunk(1, 2.0, chunk, 6), 0);
+    }
+    CHECK(pool.getStats().inboxDrops == 2);
+
+    pool.start();
+    for (int i = 0; i < 2000 && pool.getStats().chunksReceived < 4; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    pool.stop();
+    CHECK(pool.getStats().chunksReceived == 4);
+    CHECK(pool.getAssembler(1)->getPartialScanCount() == 1);
+    std::cout << "  Full inbox drops chunks: OK\n";
+}
+
+static void testProfilesAndIdleExpiry() {
+    AssemblerPool::Config config = testConfig();
+    config.assembler.staleScanTimeoutMs = 2.0;
+    AssemblerPool pool(config);
+    pool.addRoversFromProfiles();
+    CHECK(pool.getRoverCount() == g_roverProfiles.size());
+    pool.start();
+
+    // Idle workers still expire stale scans
+    uint32_t roverId = pool.getRoverIds().front();
+    pool.onLidar(roverId, makeChunk(roverId, 3.0, 0, 2), 0);
+    for (int i = 0; i < 2000 && pool.getStats().staleScans == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    pool.stop();
+    CHECK(pool.getStats().staleScans == 1);
+    std::cout << "  Shards from rover profiles, idle expiry: OK\n";
+}
+
+int main() {
+    std::cout << "Testing per-rover assembler pool...\n\n";
+
+    testRoversWithSameTimestamp();
+    testUnknownRover();
+    testInboxOverflow();
+    testProfilesAndIdleExpiry();
+
+    std::cout << "\n✅ All assembler pool tests passed!\n";
+    return 0;
+}
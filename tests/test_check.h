@@ -0,0 +1,19 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <iostream>
+#include <cstdlib>
+
+// Like assert(), but also checked in Release builds, which define NDEBUG.
+// Keep calls that change state out of the condition: make the call into a
+// local first, then CHECK the local.
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition \
+                      << std::endl;                                                   \
+            std::exit(1);                                                             \
+        }                                                                             \
+    } while (0)
+
+#endif // TEST_CHECK_H
@@ -0,0 +1,218 @@
+#include <iostream>
+#include <cstring>
+#include <thread>
+#include <chrono>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "command_channel.h"
+#include "test_check.h"
+
+// Stands in for a rover's command socket on localhost
+class FakeRover {
+public:
+    explicit FakeRover(uint16_t port) : socket_(socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0)) {
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        int bound = bind(socket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        CHECK(bound == 0);
+    }
+    ~FakeRover() { close(socket_); }
+
+    // Commands received so far; the newest is left in buttons
+    size_t drain(uint8_t& buttons) {
+        size_t count = 0;
+        while (recv(socket_, &buttons, 1, 0) == 1) {
+            count++;
+        }
+        return count;
+    }
+
+private:
+    int socket_;
+};
+
+// Counts what the channel forwards
+class CountingHandler : public IngestHandler {
+public:
+    size_t poses = 0, chunks = 0, telemetry = 0;
+
+    void onPose(uint32_t, const PosePacket&, uint64_t) override { poses++; }
+    void onLidar(uint32_t, const LidarPacket&, uint64_t) override { chunks++; }
+    void onTelemetry(uint32_t, const VehicleTelem&, uint64_t) override { telemetry++; }
+};
+
+static RoverPorts portsOf(uint32_t roverId, uint16_t cmdPort) {
+    RoverPorts ports;
+    ports.roverId = roverId;
+    ports.posePort = 0;
+    ports.lidarPort = 0;
+    ports.telemPort = 0;
+    ports.cmdPort = cmdPort;
+    return ports;
+}
+
+static VehicleTelem telemetryWith(uint8_t buttons) {
+    VehicleTelem telem;
+    telem.timestamp = 0.0;
+    telem.buttonStates = buttons;
+    return telem;
+}
+
+// Let sent datagrams reach the fake rover
+static void settleLoopback() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+}
+
+static void testRoundTrip() {
+    FakeRover rover(18701);
+    CommandChannel channel;
+    LatencyRecorder latency(8);
+    channel.setLatencyRecorder(&latency);
+    CHECK(channel.isValid());
+    bool added[2] = { channel.addRover(portsOf(1, 18701)), channel.addRover(portsOf(1, 18701)) };
+    CHECK(added[0] && !added[1]);
+    bool sent = channel.send(2, 0x01);
+    CHECK(!sent);   // Unknown rover
+
+    uint64_t beforeSend = realtimeNowNs();
+    sent = channel.send(1, 0x05);
+    CHECK(sent);
+    CHECK(channel.getPendingCount() == 1);
+    settleLoopback();
+    uint8_t received = 0;
+    size_t datagrams = rover.drain(received);
+    CHECK(datagrams == 1 && received == 0x05);
+
+    // Telemetry that was already on its way, and telemetry with old bits
+    channel.onTelemetry(1, telemetryWith(0x05), beforeSend - 1);
+    channel.onTelemetry(1, telemetryWith(0x00), realtimeNowNs());
+    CHECK(channel.getPendingCount() == 1);
+
+    channel.onTelemetry(1, telemetryWith(0x05), realtimeNowNs());
+    CommandChannel::Status status;
+    bool known = channel.getStatus(1, status);
+    CHECK(known);
+    CHECK(!status.pending && status.reported == 0x05 && status.attempts == 1);
+    CHECK(status.lastRoundTripNs > 0);
+    CHECK(channel.getPendingCount() == 0);
+    CHECK(channel.getStats().confirmed == 1);
+    CHECK(latency.histogram(1, LatencyStage::CommandRoundTrip)->count() == 1);
+    std::cout << "  Echoed bits confirm a command and record its round trip: OK\n";
+}
+
+static void testRetriesThenGiveUp() {
+    FakeRover rover(18702);
+    CommandChannel::Config config;
+    config.ackTimeoutNs = 2000000;   // 2 ms
+    config.maxRetries = 2;
+    CommandChannel channel(nullptr, config);
+    bool added = channel.addRover(portsOf(1, 18702));
+    bool sent = channel.send(1, 0x02);
+    CHECK(added && sent);
+    auto start = std::chrono::steady_clock::now();
+    while (channel.getPendingCount() > 0 && std::chrono::steady_clock::now() - start < std::chrono::seconds(2)) {
+        channel.poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    settleLoopback();
+
+    uint8_t received = 0;
+    const CommandChannel::Stats& stats = channel.getStats();
+    size_t datagrams = rover.drain(received);
+    CHECK(datagrams == 3 && received == 0x02);
+    CHECK(stats.datagramsSent == 3 && stats.retries == 2 && stats.failed == 1);
+    CHECK(stats.confirmed == 0);
+
+    // A resend that gets through is still timed from the first send
+    channel.send(1, 0x03);
+    std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    channel.poll();
+    channel.onTelemetry(1, telemetryWith(0x03), realtimeNowNs());
+    CommandChannel::Status status;
+    channel.getStatus(1, status);
+    CHECK(!status.pending && status.attempts == 2 && status.lastRoundTripNs >= 3000000);
+    std::cout << "  Unconfirmed commands are resent, then given up: OK\n";
+}
+
+static void testSupersededAndUnmeasured() {
+    FakeRover rover(18703);
+    CommandChannel channel;
+    bool added = channel.addRover(portsOf(1, 18703));
+    CHECK(added);
+
+    // A newer command replaces the outstanding one
+    channel.send(1, 0x01);
+    channel.send(1, 0x03);
+    channel.onTelemetry(1, telemetryWith(0x01), realtimeNowNs());
+    CHECK(channel.getPendingCount() == 1);
+    channel.onTelemetry(1, telemetryWith(0x03), realtimeNowNs());
+    CHECK(channel.getPendingCount() == 0);
+    CHECK(channel.getStats().superseded == 1 && channel.getStats().confirmed == 1);
+
+    // Bits the rover already reports: confirmed, but no round trip
+    CommandChannel::Status before;
+    channel.getStatus(1, before);
+    channel.send(1, 0x03);
+    channel.onTelemetry(1, telemetryWith(0x03), realtimeNowNs());
+    CommandChannel::Status after;
+    channel.getStatus(1, after);
+    CHECK(!after.pending && after.lastRoundTripNs == before.lastRoundTripNs);
+    CHECK(channel.getStats().unmeasured == 1 && channel.getStats().confirmed == 2);
+
+    uint8_t received = 0;
+    settleLoopback();
+    size_t datagrams = rover.drain(received);
+    CHECK(datagrams == 3 && received == 0x03);
+    std::cout << "  Superseded and already-set commands: OK\n";
+}
+
+static void testRequestsAndForwarding() {
+    FakeRover rover(18704);
+    CountingHandler downstream;
+    CommandChannel channel(&downstream);
+    bool added = channel.addRover(portsOf(7, 18704));
+    CHECK(added);
+
+    // Queued from another thread, sent by the next poll()
+    std::thread ui([&channel]() {
+        channel.request(7, 0x10);
+        channel.request(7, 0x30);
+    });
+    ui.join();
+    CHECK(channel.getStats().commands == 0);
+    channel.poll();
+    CHECK(channel.getStats().commands == 2 && channel.getStats().superseded == 1);
+
+    uint8_t received = 0;
+    settleLoopback();
+    size_t datagrams = rover.drain(received);
+    CHECK(datagrams == 2 && received == 0x30);
+
+    PosePacket pose;
+    std::memset(&pose, 0, sizeof(pose));
+    LidarPacket chunk;
+    std::memset(&chunk, 0, sizeof(chunk));
+    channel.onPose(7, pose, 0);
+    channel.onLidar(7, chunk, 0);
+    channel.onTelemetry(7, telemetryWith(0x30), realtimeNowNs());
+    channel.onTelemetry(9, telemetryWith(0x30), realtimeNowNs());   // Unknown rover: forwarded only
+    CHECK(downstream.poses == 1 && downstream.chunks == 1 && downstream.telemetry == 2);
+    CHECK(channel.getPendingCount() == 0);
+    std::cout << "  Requests from another thread, packets forwarded: OK\n";
+}
+
+int main() {
+    std::cout << "=== Command Channel Tests ===\n";
+
+    testRoundTrip();
+    testRetriesThenGiveUp();
+    testSupersededAndUnmeasured();
+    testRequestsAndForwarding();
+
+    std::cout << "\n✅ All command channel tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <iostream>
+#include <cstdio>
+#include <string>
+#include <fstream>
+#include <unistd.h>
+#include "../emulator/dat_loader.h"
+#include "test_check.h"
+
+static std::string tempPath(const char* name, const char* extension) {
+    return std::string("/tmp/") + name + "_" + std::to_string(getpid()) + extension;
+}
+
+static void writeFile(const std::string& path, const std::string& contents) {
+    std::ofstream out(path, std::ios::binary);
+    out << contents;
+}
+
+static void testTextParsing() {
+    std::string path = tempPath("test_dat_loader", ".dat");
+    writeFile(path,
+        "1.5,2,-3,0,90,180; 1,2,3; 4.25,-5e-1,6;\n"
+        "\n"
+        "10,20,30,1,2,3;7,8,9;+1, 2 ,3\r\n"   // stof-style blanks and '+', CRLF
+        "not a pose line\n"
+        "0,0,0,0,0,0;1,2;3,4,5\n"             // incomplete point skipped
+        "5,5,5,5,5,5;");                      // no points, no final newline
+
+    DatFile data;
+    bool loaded = data.load(path);
+    CHECK(loaded);
+    CHECK(!data.isBinary());
+    CHECK(data.frameCount() == 4 && data.pointCount() == 5);
+    CHECK(data.skippedLines() == 1);
+
+    const DatFrame& first = data.frame(0);
+    CHECK(first.posX == 1.5f && first.posZ == -3.0f && first.rotZ == 180.0f);
+    CHECK(first.pointCount == 2);
+    CHECK(data.points(first)[1].x == 4.25f && data.points(first)[1].y == -0.5f);
+
+    const DatFrame& second = data.frame(1);
+    CHECK(second.pointCount == 2 && data.points(second)[1].x == 1.0f && data.points(second)[1].z == 3.0f);
+    CHECK(data.frame(2).pointCount == 1 && data.points(data.frame(2))[0].z == 5.0f);
+    CHECK(data.frame(3).pointCount == 0 && data.frame(3).posY == 5.0f);
+
+    std::remove(path.c_str());
+    std::cout << "  Text parsed in place, bad lines and points skipped: OK\n";
+}
+
+static void testBinaryRoundTrip() {
+    std::string path = tempPath("test_dat_loader_bin", ".dat");
+    std::string binaryPath = DatFile::binaryPathFor(path);
+    CHECK(binaryPath == tempPath("test_dat_loader_bin", ".bin"));
+    writeFile(path, "1,2,3,4,5,6;1,1,1;2,2,2\n7,8,9,10,11,12;3,3,3\n");
+
+    DatFile text;
+    bool loaded = text.load(path);
+    CHECK(loaded);
+    bool saved = text.saveBinary(binaryPath, path);
+    CHECK(saved);
+
+    // The binary copy is used as long as the .dat is unchanged
+    DatFile binary;
+    loaded = binary.loadPreferBinary(path);
+    CHECK(loaded);
+    CHECK(binary.isBinary());
+    CHECK(binary.frameCount() == 2 && binary.pointCount() == 3);
+    CHECK(binary.frame(1).rotZ == 12.0f && binary.points(binary.frame(1))[0].y == 3.0f);
+
+    // Changing the .dat makes it stale: the text is parsed instead
+    writeFile(path, "1,2,3,4,5,6;1,1,1\n");
+    DatFile reparsed;
+    loaded = reparsed.loadPreferBinary(path);
+    CHECK(loaded);
+    CHECK(!reparsed.isBinary() && reparsed.frameCount() == 1);
+
+    // A cut-off binary file is refused
+    writeFile(binaryPath, std::string("RVDATBN1") + std::string(20, '\0'));
+    DatFile truncated;
+    loaded = truncated.load(binaryPath);
+    CHECK(!loaded);
+
+    std::remove(path.c_str());
+    std::remove(binaryPath.c_str());
+    std::cout << "  Binary copy round-trips and is ignored once stale: OK\n";
+}
+
+int main() {
+    std::cout << "Testing rover data loader...\n\n";
+
+    testTextParsing();
+    testBinaryRoundTrip();
+
+    std::cout << "\n✅ All data loader tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,264 @@
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <random>
+#include <string>
+#include <cstdio>
+#include <unistd.h>
+#include <glm/glm.hpp>
+#include "height_map.h"
+#include "test_check.h"
+
+static bool near(float a, float b) {
+    return std::fabs(a - b) < 1e-4f;
+}
+
+static void testCellStatistics() {
+    HeightMap map;
+
+    // Three hits in one cell (Y up: ground is x/z)
+    std::vector<glm::vec3> points = {
+        glm::vec3(10.1f, 1.0f, -4.9f), glm::vec3(10.2f, 3.0f, -4.8f), glm::vec3(10.3f, 2.0f, -4.7f)
+    };
+    size_t inserted = map.insert(points);
+    CHECK(inserted == 3);
+
+    const HeightMap::Cell* cell = map.cellAt(10.2f, -4.8f);
+    CHECK(cell != nullptr && cell->hits == 3);
+    CHECK(near(cell->minHeight, 1.0f) && near(cell->maxHeight, 3.0f) && near(cell->meanHeight, 2.0f));
+    const HeightMap::Cell* emptyCell = map.cellAt(11.0f, -4.8f);
+    const HeightMap::Cell* untouched = map.cellAt(200.0f, 200.0f);
+    CHECK(emptyCell == nullptr);    // same tile, empty cell
+    CHECK(untouched == nullptr);    // untouched tile
+    std::cout << "  Per-cell min/max/mean/hits: OK\n";
+}
+
+static void testLazyTilesAndBounds() {
+    HeightMap::Config config;
+    config.extent = 1000.0f;
+    HeightMap map(config);
+
+    // 1000 units / 0.5 per cell / 64 cells per tile -> 32 tiles per side
+    CHECK(map.getTilesPerSide() == 32);
+    CHECK(map.getStats().tilesAllocated == 0);
+
+    std::vector<glm::vec3> points = {
+        glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 1.0f),     // one tile
+        glm::vec3(-400.0f, 0.0f, 300.0f),                               // another
+        glm::vec3(600.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -700.0f),  // outside
+        glm::vec3(NAN, 0.0f, 0.0f)
+    };
+    size_t inserted = map.insert(points);
+    CHECK(inserted == 3);
+    CHECK(map.getStats().tilesAllocated == 2);
+    CHECK(map.getStats().pointsOutOfBounds == 3);
+    size_t perTile = 64 * 64 * sizeof(HeightMap::Cell);
+    CHECK(map.getStats().memoryBytes >= 2 * perTile && map.getStats().memoryBytes < 3 * perTile);
+    std::cout << "  Tiles allocated lazily, out-of-area points rejected: OK\n";
+}
+
+static void testDirtyTracking() {
+    HeightMap map;
+    std::vector<uint32_t> dirty;
+
+    std::vector<glm::vec3> a = { glm::vec3(5.0f, 1.0f, 5.0f), glm::vec3(100.0f, 1.0f, 5.0f) };
+    map.insert(a);
+    map.insert(a);   // still listed once
+    map.takeDirtyTiles(dirty);
+    CHECK(dirty.size() == 2);
+    const HeightMap::Tile* tile = map.getTile(dirty[0]);
+    CHECK(tile != nullptr && !tile->dirty && tile->version == 1);
+    const HeightMap::Tile* byCoordinates = map.getTile(tile->tileX, tile->tileY);
+    CHECK(byCoordinates == tile);
+
+    // Tile origin contains the point that created it
+    glm::vec2 origin = map.tileOrigin(*tile);
+    CHECK(origin.x <= 5.0f && origin.x + 32.0f > 5.0f);
+
+    map.takeDirtyTiles(dirty);
+    CHECK(dirty.empty());
+
+    std::vector<glm::vec3> b = { glm::vec3(5.5f, 2.0f, 5.0f) };
+    map.insert(b);
+    map.takeDirtyTiles(dirty);
+    CHECK(dirty.size() == 1);
+    tile = map.getTile(dirty[0]);
+    CHECK(tile->version == 2);
+    std::cout << "  Dirty tiles collected once per change: OK\n";
+}
+
+static void testTemporalFusion() {
+    HeightMap map;
+    std::vector<uint32_t> dirty;
+    std::mt19937 rng(5);
+    std::normal_distribution<float> noise(0.0f, 0.5f);   // emulator noise
+
+    // Repeated noisy observations of ground at height 2
+    glm::vec3 p(20.2f, 0.0f, 20.2f);
+    auto observe = [&](float height, int times) {
+        for (int i = 0; i < times; ++i) {
+            p.y = height + noise(rng);
+            map.insert(&p, 1);
+        }
+    };
+
+    observe(2.0f, 1);
+    const HeightMap::Cell* cell = map.cellAt(p.x, p.z);
+    CHECK(map.cellConfidence(*cell) == 0.0f);
+    observe(2.0f, 15);
+    float early = map.cellConfidence(*cell);
+    observe(2.0f, 200);
+    CHECK(std::fabs(cell->meanHeight - 2.0f) < 0.15f);
+    CHECK(std::fabs(map.cellVariance(*cell) - 0.25f) < 0.1f);
+    CHECK(map.cellConfidence(*cell) > early && map.cellConfidence(*cell) > 0.8f);
+    CHECK(cell->hits == 216);
+
+    // Converged: further noise rarely moves the fused height past the threshold
+    map.takeDirtyTiles(dirty);
+    size_t changesBefore = map.getStats().cellChanges;
+    observe(2.0f, 100);
+    CHECK(map.getStats().cellChanges - changesBefore < 25);
+
+    // The ground is dug down: the moving average follows and dirties the tile
+    map.takeDirtyTiles(dirty);
+    observe(-1.0f, 300);
+    CHECK(std::fabs(cell->meanHeight + 1.0f) < 0.2f);
+    map.takeDirtyTiles(dirty);
+    CHECK(dirty.size() == 1);
+    std::cout << "  Noisy observations fuse, confidence grows, quiet cells stay clean: OK\n";
+}
+
+static void testZUp() {
+    HeightMap::Config config;
+    config.upAxis = HeightMap::UpAxis::Z;
+    HeightMap map(config);
+
+    std::vector<glm::vec3> points = { glm::vec3(3.0f, 4.0f, 7.5f) };
+    map.insert(points);
+    const HeightMap::Cell* cell = map.cellAt(3.0f, 4.0f);
+    CHECK(cell != nullptr && near(cell->meanHeight, 7.5f));
+    std::cout << "  Z-up configuration: OK\n";
+}
+
+static std::string storePath(const char* name) {
+    return std::string("/tmp/") + name + "_" + std::to_string(getpid()) + ".tiles";
+}
+
+// One point per cell over a 6x6 block of tiles, height from the cell position
+static std::vector<glm::vec3> gridPoints(float pass) {
+    std::vector<glm::vec3> points;
+    const float span = 6.0f * 64.0f * 0.5f;
+    for (float z = -span / 2; z < span / 2; z += 0.5f) {
+        for (float x = -span / 2; x < span / 2; x += 0.5f) {
+            points.push_back(glm::vec3(x + 0.25f, 0.01f * x - 0.02f * z + pass, z + 0.25f));
+        }
+    }
+    return points;
+}
+
+static void testTilePaging() {
+    std::string path = storePath("test_height_map_paging");
+    std::remove(path.c_str());
+
+    HeightMap::Config config;
+    config.residentBudgetMB = 1;   // A few tiles of 64x64 cells
+    config.changeSigmas = 0.0f;    // Any move past changeThreshold dirties
+    HeightMap map(config);
+    bool opened = map.openStore(path);
+    CHECK(opened && map.hasStore());
+
+    std::vector<glm::vec3> points = gridPoints(0.0f);
+    size_t inserted = map.insert(points);
+    CHECK(inserted == points.size());
+    const HeightMap::Stats& stats = map.getStats();
+    CHECK(stats.tilesAllocated == 36);
+    CHECK(stats.tilesResident < 36 && stats.tilesEvicted > 0);
+    CHECK(stats.memoryBytes < 2 * 1024 * 1024);
+
+    // Every dirty tile is listed once, evicted or not
+    std::vector<uint32_t> dirty;
+    map.takeDirtyTiles(dirty);
+    CHECK(dirty.size() == 36);
+
+    // Evicted tiles page back in with their data
+    size_t pagedIn = stats.tilesPagedIn;
+    for (const glm::vec3& p : points) {
+        const HeightMap::Cell* cell = map.cellAt(p.x, p.z);
+        CHECK(cell != nullptr && cell->hits == 1 && near(cell->meanHeight, p.y));
+    }
+    CHECK(stats.tilesPagedIn > pagedIn);
+    CHECK(stats.tilesResident <= 36);
+
+    // Dirty flags survive eviction: a second pass dirties each tile once
+    map.insert(gridPoints(1.0f));
+    map.takeDirtyTiles(dirty);
+    CHECK(dirty.size() == 36);
+    map.takeDirtyTiles(dirty);
+    CHECK(dirty.empty());
+
+    std::remove(path.c_str());
+    std::cout << "  Tiles over the budget page out to the store and back: OK\n";
+}
+
+static void testStoreResume() {
+    std::string path = storePath("test_height_map_resume");
+    std::remove(path.c_str());
+    std::vector<glm::vec3> points;
+
+    {
+        HeightMap::Config config;
+        config.residentBudgetMB = 1;
+        HeightMap map(config);
+        bool opened = map.openStore(path);
+        CHECK(opened);
+        points = gridPoints(0.0f);
+        map.insert(points);
+        map.insert(points);
+        std::vector<uint32_t> dirty;
+        map.takeDirtyTiles(dirty);   // Meshed in the first session
+    }   // Flushed on destruction
+
+    HeightMap::Config config;
+    HeightMap map(config);
+    bool opened = map.openStore(path);
+    CHECK(opened);
+    CHECK(map.getStats().tilesAllocated == 36 && map.getStats().tilesResident == 0);
+
+    // Resumed tiles all need meshing again
+    std::vector<uint32_t> dirty;
+    map.takeDirtyTiles(dirty);
+    CHECK(dirty.size() == 36);
+    for (uint32_t index : dirty) {
+        const HeightMap::Tile* tile = map.getTile(index);
+        CHECK(tile != nullptr && !tile->dirty);
+    }
+    for (const glm::vec3& p : points) {
+        const HeightMap::Cell* cell = map.cellAt(p.x, p.z);
+        CHECK(cell != nullptr && cell->hits == 2 && near(cell->meanHeight, p.y));
+    }
+
+    // A map with a different layout refuses the file
+    HeightMap::Config other;
+    other.cellSize = 0.25f;
+    HeightMap mismatched(other);
+    opened = mismatched.openStore(path);
+    CHECK(!opened && !mismatched.hasStore());
+
+    std::remove(path.c_str());
+    std::cout << "  Reopening the store resumes the map: OK\n";
+}
+
+int main() {
+    std::cout << "Testing tiled height map...\n\n";
+
+    testCellStatistics();
+    testLazyTilesAndBounds();
+    testDirtyTracking();
+    testTemporalFusion();
+    testZUp();
+    testTilePaging();
+    testStoreResume();
+
+    std::cout << "\n✅ All height map tests passed!\n";
+    return 0;
+}
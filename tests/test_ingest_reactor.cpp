@@ -0,0 +1,111 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <map>
+#include <sys/resource.h>
+#include "ingest_reactor.h"
+#include "packet_log.h"
+#include "udp_packet_structures.h"
+
+// Counts packets per rover
+class CountingHandler : public IngestHandler {
+public:
+    struct Counts {
+        size_t pose = 0;
+        size_t lidar = 0;
+        size_t telem = 0;
+    };
+
+    void onPose(uint32_t roverId, const PosePacket&, uint64_t) override { counts_[roverId].pose++; }
+    void onLidar(uint32_t roverId, const LidarPacket&, uint64_t) override { counts_[roverId].lidar++; }
+    void onTelemetry(uint32_t roverId, const VehicleTelem&, uint64_t) override { counts_[roverId].telem++; }
+
+    const std::map<uint32_t, Counts>& counts() const { return counts_; }
+
+private:
+    std::map<uint32_t, Counts> counts_;
+};
+
+static double processCpuSeconds() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+         + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "=== Ingest Reactor Test ===" << std::endl;
+    std::cout << "Make sure rover emulators are running:" << std::endl;
+    std::cout << "  make run-noiseless" << std::endl;
+    std::cout << "===========================\n" << std::endl;
+
+    IngestReactor reactor;
+    if (!reactor.isValid()) {
+        std::cerr << "Failed to create ingest reactor" << std::endl;
+        return 1;
+    }
+
+    LatencyRecorder latency;
+    reactor.setLatencyRecorder(&latency);
+
+    // Optional: record everything received for later replay
+    PacketRecorder recorder;
+    if (argc > 1) {
+        if (!recorder.open(argv[1])) {
+            return 1;
+        }
+        reactor.setPacketRecorder(&recorder);
+        std::cout << "Recording to " << argv[1] << std::endl;
+    }
+
+    CountingHandler handler;
+    for (const auto& ports : IngestReactor::portsFromProfiles()) {
+        if (!reactor.addRover(ports, handler)) {
+            std::cerr << "Failed to open sockets for rover " << ports.roverId << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Listening for " << reactor.getRoverCount() << " rovers on one thread..." << std::endl;
+    std::cout << "Press Ctrl+C to stop\n" << std::endl;
+
+    // Print a report every second from the reactor thread itself
+    auto lastReport = std::chrono::steady_clock::now();
+    double lastCpu = processCpuSeconds();
+
+    while (true) {
+        reactor.pollOnce(100);
+
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - lastReport).count();
+        if (elapsed < 1.0) continue;
+
+        double cpu = processCpuSeconds();
+        const IngestReactor::Stats& stats = reactor.getStats();
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "CPU: " << (100.0 * (cpu - lastCpu) / elapsed) << "%"
+                  << " | Wakeups: " << stats.wakeups
+                  << " | Datagrams: " << stats.datagrams
+                  << " | Malformed: " << stats.malformedPackets << std::endl;
+        for (const auto& [roverId, counts] : handler.counts()) {
+            std::cout << "  Rover " << roverId
+                      << ": pose " << counts.pose
+                      << ", lidar " << counts.lidar
+                      << ", telem " << counts.telem << std::endl;
+        }
+        latency.dump(std::cout);
+        if (recorder.isOpen()) {
+            PacketRecorder::Stats recorded = recorder.getStats();
+            std::cout << "  Recorded: " << recorded.records << " datagrams, "
+                      << recorded.bytes / (1024.0 * 1024.0) << " MB, "
+                      << recorded.droppedRecords << " dropped" << std::endl;
+        }
+
+        lastReport = now;
+        lastCpu = cpu;
+    }
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <iostream>
+#include <sstream>
+#include "latency_stats.h"
+#include "test_check.h"
+
+int main() {
+    std::cout << "Testing latency histograms...\n\n";
+    
+    // Empty histogram
+    LatencyHistogram empty;
+    CHECK(empty.count() == 0);
+    CHECK(empty.percentile(50.0) == 0);
+    
+    // Uniform 1..1000 us samples
+    LatencyHistogram hist;
+    for (uint64_t us = 1; us <= 1000; ++us) {
+        hist.record(us * 1000);
+    }
+    std::cout << "count=" << hist.count() 
+              << " p50=" << hist.percentile(50.0) 
+              << " p99=" << hist.percentile(99.0) 
+              << " max=" << hist.max() << " ns\n";
+    CHECK(hist.count() == 1000);
+    CHECK(hist.max() == 1000000);
+    
+    // Log-linear buckets are within 1/8 of the true value
+    uint64_t p50 = hist.percentile(50.0);
+    uint64_t p99 = hist.percentile(99.0);
+    CHECK(p50 >= 500000 && p50 <= 500000 + 500000 / 8);
+    CHECK(p99 >= 990000 && p99 <= 1000000);
+    CHECK(hist.percentile(100.0) == hist.max());
+    
+    // Small values land in exact buckets
+    LatencyHistogram small;
+    small.record(3);
+    CHECK(small.percentile(50.0) == 3);
+    
+    hist.reset();
+    CHECK(hist.count() == 0 && hist.max() == 0);
+    
+    // Recorder keeps rovers and stages apart, ignores out-of-range rovers
+    LatencyRecorder recorder(8);
+    recorder.record(1, LatencyStage::Receive, 1000);
+    recorder.record(1, LatencyStage::Assembly, 5000000);
+    recorder.record(2, LatencyStage::Receive, 2000);
+    recorder.record(99, LatencyStage::Receive, 2000);
+    CHECK(recorder.histogram(1, LatencyStage::Receive)->count() == 1);
+    CHECK(recorder.histogram(1, LatencyStage::Assembly)->max() == 5000000);
+    CHECK(recorder.histogram(2, LatencyStage::Assembly)->count() == 0);
+    CHECK(recorder.histogram(99, LatencyStage::Receive) == nullptr);
+    
+    std::ostringstream dump;
+    recorder.dump(dump);
+    std::cout << "\n" << dump.str();
+    CHECK(dump.str().find("assembly") != std::string::npos);
+    
+    std::cout << "\n✅ Latency histogram tests passed!\n";
+    return 0;
+}
@@ -11,6 +11,7 @@ void printStats(const LidarAssembler& assembler) {
     std::cout << "  [Chunks: " << assembler.getTotalChunksReceived() 
               << " | Complete scans: " << assembler.getTotalScansCompleted()
               << " | Partial: " << assembler.getPartialScanCount()
+              << " | Stale: " << assembler.getStaleScans()
               << " | Ready: " << assembler.getCompleteScanCount() << "]" << std::endl;
 }
 
@@ -31,6 +32,9 @@ int main() {
     // Set to non-blocking mode
     lidarReceiver.setNonBlocking(true);
     
+    // Kernel arrival timestamps for assembly latency
+    lidarReceiver.enableTimestamps(true);
+    
     // Create LiDAR assembler
     LidarAssembler assembler;
     
@@ -42,7 +46,6 @@ int main() {
     int scansCompleted = 0;
     auto startTime = std::chrono::steady_clock::now();
     auto lastReceiveTime = startTime;
-    auto lastCleanupTime = startTime;
     
     std::cout << "Listening for LiDAR packets on port 10001..." << std::endl;
     std::cout << "Press Ctrl+C to stop\n" << std::endl;
@@ -59,7 +62,7 @@ int main() {
                 packetsReceived++;
                 
                 // Add packet to assembler
-                bool scanComplete = assembler.addPacket(packet);
+                bool scanComplete = assembler.addPacket(packet, lidarReceiver.getLastArrivalNs());
                 
                 if (scanComplete) {
                     scansCompleted++;
@@ -71,7 +74,8 @@ int main() {
                         std::cout << "Full scan received: " 
                                   << scan.points.size() << " points"
                                   << " | Timestamp: " << scan.timestamp 
-                                  << " | Chunks: " << scan.totalChunks << std::endl;
+                                  << " | Chunks: " << scan.totalChunks 
+                                  << " | Assembly: " << scan.assemblyLatencyNs() / 1e6 << " ms" << std::endl;
                         
                         // Print sample of first and last points
                         if (scan.points.size() > 0) {
@@ -113,12 +117,8 @@ int main() {
                 lastReceiveTime = now;  // Reset to avoid repeated messages
             }
             
-            // Periodically clean up stale partial scans
-            auto timeSinceCleanup = std::chrono::duration_cast<std::chrono::seconds>(now - lastCleanupTime).count();
-            if (timeSinceCleanup > 5) {
-                assembler.cleanupStaleScans(2.0);
-                lastCleanupTime = now;
-            }
+            // Expire stale partial scans while the link is quiet
+            assembler.poll();
             
             // Small sleep to avoid busy waiting
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
@@ -134,6 +134,7 @@ int main() {
     std::cout << "Total chunks received: " << assembler.getTotalChunksReceived() << std::endl;
     std::cout << "Total scans completed: " << assembler.getTotalScansCompleted() << std::endl;
     std::cout << "Partial scans remaining: " << assembler.getPartialScanCount() << std::endl;
+    std::cout << "Stale scans discarded: " << assembler.getStaleScans() << std::endl;
     
     return 0;
 }
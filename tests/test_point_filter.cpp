@@ -0,0 +1,123 @@
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <random>
+#include "point_filter.h"
+#include "test_check.h"
+
+static bool near(float a, float b, float tolerance = 1e-4f) {
+    return std::fabs(a - b) < tolerance;
+}
+
+// Terrain the synthetic scans sample (Y up)
+static float surface(float x, float z) {
+    return 3.0f * std::sin(x * 0.1f) + 2.0f * std::cos(z * 0.13f);
+}
+
+static std::vector<LidarPoint> cleanScan(std::mt19937& rng, size_t count) {
+    std::uniform_real_distribution<float> ground(-30.0f, 30.0f);
+    std::vector<LidarPoint> points(count);
+    for (auto& p : points) {
+        float x = ground(rng), z = ground(rng);
+        p = { x, surface(x, z), z };
+    }
+    return points;
+}
+
+static void testCentroids() {
+    PointFilter::Config config;
+    config.voxelSize = 1.0f;
+    config.minNeighbors = 1;
+    PointFilter filter(config);
+
+    // Two points in voxel (0,0,0), one in (2,0,0)
+    std::vector<LidarPoint> points = {
+        {0.2f, 0.2f, 0.2f}, {0.4f, 0.6f, 0.8f}, {2.5f, 0.5f, 0.5f}
+    };
+    filter.filter(points);
+    CHECK(points.size() == 2);
+    CHECK(near(points[0].x, 0.3f) && near(points[0].y, 0.4f) && near(points[0].z, 0.5f));
+    CHECK(near(points[1].x, 2.5f));
+    CHECK(filter.getStats().pointsIn == 3 && filter.getStats().pointsOut == 2);
+    std::cout << "  Isolated voxels become their centroid, scan order kept: OK\n";
+}
+
+static void testOutliersAndInvalid() {
+    PointFilter filter;   // 0.5 voxels, 3 points in the neighbourhood
+
+    std::vector<LidarPoint> points;
+    for (int i = 0; i < 50; ++i) {
+        points.push_back({0.1f * static_cast<float>(i % 10), 0.0f, 0.1f * static_cast<float>(i / 10)});
+    }
+    points.push_back({40.0f, 12.0f, -7.0f});    // isolated
+    points.push_back({NAN, 0.0f, 0.0f});
+    points.push_back({1e30f, 0.0f, 0.0f});
+
+    size_t kept = filter.filter(points.data(), points.size());
+    for (size_t i = 0; i < kept; ++i) {
+        CHECK(points[i].x < 10.0f);
+    }
+    CHECK(filter.getStats().outliersRemoved == 1);
+    std::cout << "  Isolated and non-finite points rejected: OK\n";
+}
+
+static void testAdaptiveReduction() {
+    PointFilter::Config config;
+    config.voxelSize = 0.1f;
+    config.reductionFactor = 10.0f;
+    PointFilter filter(config);
+
+    std::mt19937 rng(1);
+    float ratio = 0.0f;
+    for (int scan = 0; scan < 10; ++scan) {
+        std::vector<LidarPoint> points = cleanScan(rng, 20000);
+        size_t in = points.size();
+        filter.filter(points);
+        ratio = static_cast<float>(in) / static_cast<float>(points.size());
+    }
+    CHECK(ratio > 7.0f && ratio < 14.0f);
+    CHECK(filter.getVoxelSize() > 0.1f);
+    std::cout << "  Voxel size converges on the reduction factor (" << ratio << "x): OK\n";
+}
+
+static void testNoiseReduction() {
+    // The emulator adds N(0, 0.5) to every axis unless --no-noise is given
+    std::mt19937 rng(2);
+    std::normal_distribution<float> noise(0.0f, 0.5f);
+    std::vector<LidarPoint> points = cleanScan(rng, 20000);
+    for (auto& p : points) {
+        p.x += noise(rng);
+        p.y += noise(rng);
+        p.z += noise(rng);
+    }
+
+    auto rmsError = [](const std::vector<LidarPoint>& pts) {
+        double sum = 0.0;
+        for (const auto& p : pts) {
+            double e = p.y - surface(p.x, p.z);
+            sum += e * e;
+        }
+        return std::sqrt(sum / static_cast<double>(pts.size()));
+    };
+
+    double before = rmsError(points);
+    PointFilter::Config config;
+    config.voxelSize = 1.5f;
+    PointFilter filter(config);
+    filter.filter(points);
+    double after = rmsError(points);
+    CHECK(after < 0.3 * before);
+    std::cout << "  Height error vs noise-free surface " << before << " -> " << after << ": OK\n";
+}
+
+int main() {
+    std::cout << "Testing point filter...\n\n";
+
+    testCentroids();
+    testOutliersAndInvalid();
+    testAdaptiveReduction();
+    testNoiseReduction();
+
+    std::cout << "\n✅ All point filter tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <iostream>
+#include <cmath>
+#include <glm/glm.hpp>
+#include "pose_history.h"
+#include "transform.h"
+#include "udp_packet_structures.h"
+#include "test_check.h"
+
+static PosePacket makePose(double timestamp, float x, float yawDeg) {
+    PosePacket pose = {};
+    pose.timestamp = timestamp;
+    pose.posX = x;
+    pose.posY = 2.0f * x;
+    pose.posZ = 1.0f;
+    pose.rotZdeg = yawDeg;
+    return pose;
+}
+
+static bool near(float a, float b, float eps = 1e-4f) {
+    return std::fabs(a - b) <= eps;
+}
+
+static bool sameMatrix(const glm::mat4& a, const glm::mat4& b) {
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r) {
+            if (!near(a[c][r], b[c][r])) return false;
+        }
+    }
+    return true;
+}
+
+static void testMatchesPoseToMatrix() {
+    PoseHistory history;
+    PosePacket pose = makePose(1.0, 3.0f, 40.0f);
+    pose.rotXdeg = 10.0f;
+    pose.rotYdeg = -20.0f;
+    history.addPose(pose);
+
+    glm::mat4 transform(1.0f);
+    PoseMatch match = history.lookup(1.0, transform);
+    CHECK(match == PoseMatch::Interpolated);
+    CHECK(sameMatrix(transform, Transform::poseToMatrix(pose)));
+    std::cout << "  Exact timestamp matches Transform::poseToMatrix: OK\n";
+}
+
+static void testInterpolation() {
+    PoseHistory history;
+    history.addPose(makePose(1.0, 0.0f, 0.0f));
+    history.addPose(makePose(2.0, 10.0f, 90.0f));
+    history.addPose(makePose(3.0, 20.0f, 90.0f));
+
+    glm::vec3 position;
+    glm::quat rotation;
+    PoseMatch match = history.lookup(1.25, position, rotation);
+    CHECK(match == PoseMatch::Interpolated);
+    CHECK(near(position.x, 2.5f) && near(position.y, 5.0f) && near(position.z, 1.0f));
+
+    // Slerp: a quarter of the way to 90 degrees yaw
+    glm::mat4 expected = Transform::poseToMatrix(makePose(1.25, 2.5f, 22.5f));
+    glm::mat4 transform(1.0f);
+    history.lookup(1.25, transform);
+    CHECK(sameMatrix(transform, expected));
+
+    // Newest-interval fast path and the search path agree
+    match = history.lookup(2.5, position, rotation);
+    CHECK(match == PoseMatch::Interpolated);
+    CHECK(near(position.x, 15.0f));
+    std::cout << "  Lerp position / slerp rotation: OK\n";
+}
+
+static void testOutsideRange() {
+    PoseHistory history;
+    glm::mat4 transform(1.0f);
+    PoseMatch match = history.lookup(1.0, transform);
+    CHECK(match == PoseMatch::None);
+
+    history.addPose(makePose(5.0, 1.0f, 0.0f));
+    history.addPose(makePose(6.0, 2.0f, 0.0f));
+
+    glm::vec3 position;
+    glm::quat rotation;
+    match = history.lookup(9.0, position, rotation);
+    CHECK(match == PoseMatch::HeldNewest && near(position.x, 2.0f));
+    match = history.lookup(4.0, position, rotation);
+    CHECK(match == PoseMatch::HeldOldest && near(position.x, 1.0f));
+    std::cout << "  Held poses outside the stored range: OK\n";
+}
+
+static void testRingAndReordering() {
+    PoseHistory history(4);
+    for (int i = 0; i < 10; ++i) {
+        history.addPose(makePose(i, static_cast<float>(i), 0.0f));
+    }
+    CHECK(history.size() == 4);
+    CHECK(history.getOldestTimestamp() == 6.0 && history.getNewestTimestamp() == 9.0);
+
+    // Late pose lands in order, pushing out the oldest
+    history.addPose(makePose(8.5, 8.5f, 0.0f));
+    CHECK(history.getOutOfOrderPoses() == 1);
+    CHECK(history.getOldestTimestamp() == 7.0);
+
+    glm::vec3 position;
+    glm::quat rotation;
+    history.lookup(8.25, position, rotation);
+    CHECK(near(position.x, 8.25f));
+
+    // Too old for a full ring, and a repeated timestamp replaces
+    history.addPose(makePose(1.0, 1.0f, 0.0f));
+    CHECK(history.getOldestTimestamp() == 7.0);
+    history.addPose(makePose(9.0, 90.0f, 0.0f));
+    history.lookup(9.0, position, rotation);
+    CHECK(near(position.x, 90.0f) && history.size() == 4);
+    std::cout << "  Ring overwrite and out-of-order poses: OK\n";
+}
+
+int main() {
+    std::cout << "Testing pose history interpolation...\n\n";
+
+    testMatchesPoseToMatrix();
+    testInterpolation();
+    testOutsideRange();
+    testRingAndReordering();
+
+    std::cout << "\n✅ All pose history tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,295 @@
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <chrono>
+#include "lidar_assembler.h"
+#include "udp_packet_structures.h"
+#include "test_check.h"
+
+// Count heap allocations to prove the steady-state path never allocates
+static size_t g_allocations = 0;
+
+void* operator new(size_t size) {
+    g_allocations++;
+    void* p = std::malloc(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// Build chunk `index` of a scan; point i of the scan has x == i
+static LidarPacket makeChunk(double timestamp, uint32_t index, uint32_t total, uint32_t points) {
+    LidarPacket packet;
+    memset(&packet, 0, sizeof(packet));
+    packet.header.timestamp = timestamp;
+    packet.header.chunkIndex = index;
+    packet.header.totalChunks = total;
+    packet.header.pointsInThisChunk = points;
+    for (uint32_t i = 0; i < points; ++i) {
+        float value = static_cast<float>(index * MAX_LIDAR_POINTS_PER_PACKET + i);
+        packet.points[i] = { value, -value, 1.0f };
+    }
+    return packet;
+}
+
+static void testOutOfOrderAssembly() {
+    LidarAssembler assembler;
+
+    // 3 full chunks + 1 short chunk, delivered out of order with a duplicate
+    bool early[4] = {
+        assembler.addPacket(makeChunk(1.0, 2, 4, 100), 300),
+        assembler.addPacket(makeChunk(1.0, 0, 4, 100), 100),
+        assembler.addPacket(makeChunk(1.0, 3, 4, 50), 400),
+        assembler.addPacket(makeChunk(1.0, 0, 4, 100), 450),
+    };
+    CHECK(!early[0] && !early[1] && !early[2] && !early[3]);
+    CHECK(assembler.getPartialScanCount() == 1);
+    bool completed = assembler.addPacket(makeChunk(1.0, 1, 4, 100), 500);
+    CHECK(completed);
+
+    ScanHandle scan;
+    bool taken = assembler.getCompleteScan(scan);
+    CHECK(taken);
+    CHECK(scan.pointCount() == 350);
+    CHECK(scan.chunksReceived() == 4 && scan.totalChunks() == 4);
+    CHECK(scan.firstChunkArrivalNs() == 300 && scan.lastChunkArrivalNs() == 500);
+    for (size_t i = 0; i < scan.pointCount(); ++i) {
+        CHECK(scan.points()[i].x == static_cast<float>(i));
+    }
+    std::cout << "  Out-of-order + duplicate chunks: OK\n";
+}
+
+static void testShortMiddleChunkIsCompacted() {
+    LidarAssembler assembler;
+
+    bool completed[3] = {
+        assembler.addPacket(makeChunk(2.0, 0, 3, 100)),
+        assembler.addPacket(makeChunk(2.0, 1, 3, 10)),
+        assembler.addPacket(makeChunk(2.0, 2, 3, 5)),
+    };
+    CHECK(!completed[0] && !completed[1] && completed[2]);
+
+    LidarAssembler::CompleteScan scan;
+    bool taken = assembler.getCompleteScan(scan);
+    CHECK(taken);
+    CHECK(scan.points.size() == 115);
+    CHECK(scan.points[99].x == 99.0f);
+    CHECK(scan.points[100].x == 100.0f);   // chunk 1, point 0
+    CHECK(scan.points[110].x == 200.0f);   // chunk 2, point 0
+    std::cout << "  Short middle chunk compacted: OK\n";
+}
+
+static void testInvalidChunksDropped() {
+    LidarAssembler::Config config;
+    config.maxChunksPerScan = 8;
+    LidarAssembler assembler(config);
+
+    bool completed[3] = {
+        assembler.addPacket(makeChunk(3.0, 0, 0, 10)),    // no chunks
+        assembler.addPacket(makeChunk(3.0, 9, 9, 10)),    // too many chunks
+        assembler.addPacket(makeChunk(3.0, 5, 4, 10)),    // index out of range
+    };
+    CHECK(!completed[0] && !completed[1] && !completed[2]);
+    CHECK(assembler.getDroppedChunks() == 3);
+    CHECK(assembler.getPartialScanCount() == 0);
+    std::cout << "  Invalid chunks dropped: OK\n";
+}
+
+static void testSlotsRecycledWithoutAllocation() {
+    LidarAssembler::Config config;
+    config.arenaSlots = 4;
+    LidarAssembler assembler(config);
+
+    LidarPacket chunks[3] = {
+        makeChunk(0.0, 0, 3, 100), makeChunk(0.0, 1, 3, 100), makeChunk(0.0, 2, 3, 42)
+    };
+
+    // Warm up once, then count allocations over many scans
+    ScanHandle scan;
+    size_t before = 0;
+    for (int s = 0; s < 1000; ++s) {
+        if (s == 1) before = g_allocations;
+        for (auto& chunk : chunks) {
+            chunk.header.timestamp = s * 0.1;
+            assembler.addPacket(chunk, 1);
+        }
+        bool taken = assembler.getCompleteScan(scan);
+        CHECK(taken);
+        CHECK(scan.pointCount() == 242);
+    }
+    CHECK(g_allocations == before);
+
+    // Copies share the slot; it is recycled once every handle is gone
+    size_t freeBefore = assembler.getArena().getFreeSlotCount();
+    ScanHandle copy = scan;
+    scan.reset();
+    CHECK(assembler.getArena().getFreeSlotCount() == freeBefore);
+    copy.reset();
+    CHECK(assembler.getArena().getFreeSlotCount() == freeBefore + 1);
+    std::cout << "  1000 scans, zero allocations, slots recycled: OK\n";
+}
+
+static void testArenaExhaustion() {
+    LidarAssembler::Config config;
+    config.arenaSlots = 2;
+    LidarAssembler assembler(config);
+
+    // Consumer holds both slots: the third scan has nowhere to go
+    ScanHandle held[2];
+    for (int s = 0; s < 2; ++s) {
+        bool completed = assembler.addPacket(makeChunk(s, 0, 1, 10));
+        bool taken = assembler.getCompleteScan(held[s]);
+        CHECK(completed && taken);
+    }
+    bool completed = assembler.addPacket(makeChunk(5.0, 0, 1, 10));
+    CHECK(!completed);
+    CHECK(assembler.getDroppedChunks() == 1);
+
+    held[0].reset();
+    completed = assembler.addPacket(makeChunk(6.0, 0, 1, 10));
+    CHECK(completed);
+    std::cout << "  Arena exhaustion drops chunks until released: OK\n";
+}
+
+static void testQueueDropsOldest() {
+    LidarAssembler::Config config;
+    config.arenaSlots = 6;
+    config.queueDepth = 2;
+    LidarAssembler assembler(config);
+
+    // Consumer asleep while five scans complete
+    for (int s = 0; s < 5; ++s) {
+        bool completed = assembler.addPacket(makeChunk(s, 0, 1, 10));
+        CHECK(completed);
+    }
+    CHECK(assembler.getCompleteScanCount() == 2);
+    CHECK(assembler.getDroppedScans() == 3);
+    CHECK(assembler.getQueueHighWaterMark() == 2);
+
+    // Only the newest scans survive, and dropped slots went back to the pool
+    ScanHandle scan;
+    bool taken = assembler.getCompleteScan(scan);
+    CHECK(taken && scan.timestamp() == 3.0);
+    taken = assembler.getCompleteScan(scan);
+    CHECK(taken && scan.timestamp() == 4.0);
+    taken = assembler.getCompleteScan(scan);
+    CHECK(!taken);
+    CHECK(assembler.getArena().getFreeSlotCount() == 5);
+    std::cout << "  Full queue drops oldest scans: OK\n";
+}
+
+static void testPartialScanDeadline() {
+    LidarAssembler::Config config;
+    config.emitPartialScans = true;
+    config.partialDeadlineMs = 1.0;
+    config.minCompleteness = 0.5f;
+    LidarAssembler assembler(config);
+
+    // Chunk 1 of 4 is lost
+    bool completed[3] = {
+        assembler.addPacket(makeChunk(1.0, 0, 4, 100)),
+        assembler.addPacket(makeChunk(1.0, 2, 4, 100)),
+        assembler.addPacket(makeChunk(1.0, 3, 4, 30)),
+    };
+    CHECK(!completed[0] && !completed[1] && !completed[2]);
+    bool emitted = assembler.poll();
+    CHECK(!emitted);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    emitted = assembler.poll();
+    CHECK(emitted);
+
+    ScanHandle scan;
+    bool taken = assembler.getCompleteScan(scan);
+    CHECK(taken);
+    CHECK(!scan.isComplete() && scan.completeness() == 0.75f);
+    CHECK(scan.hasChunk(0) && !scan.hasChunk(1) && scan.hasChunk(2) && scan.hasChunk(3));
+    CHECK(scan.chunkBitmap()[0] == 0xD);
+    CHECK(scan.pointCount() == 230);
+    CHECK(scan.points()[100].x == 200.0f);   // chunk 2 follows chunk 0 directly
+    CHECK(assembler.getPartialScansEmitted() == 1);
+    std::cout << "  Partial scan emitted after deadline: OK\n";
+}
+
+static void testPartialScanOnNewerTimestamp() {
+    LidarAssembler::Config config;
+    config.emitPartialScans = true;
+    config.partialDeadlineMs = 1000.0;
+    LidarAssembler assembler(config);
+
+    bool completed = assembler.addPacket(makeChunk(1.0, 0, 2, 100));
+    CHECK(!completed);
+    completed = assembler.addPacket(makeChunk(1.1, 0, 2, 100));   // newer scan flushes 1.0
+    CHECK(completed);
+
+    ScanHandle scan;
+    bool taken = assembler.getCompleteScan(scan);
+    CHECK(taken);
+    CHECK(scan.timestamp() == 1.0 && scan.completeness() == 0.5f);
+    CHECK(assembler.getPartialScanCount() == 1);
+    std::cout << "  Partial scan emitted when newer scan starts: OK\n";
+}
+
+static void testSparsePartialScanDiscarded() {
+    LidarAssembler::Config config;
+    config.emitPartialScans = true;
+    config.minCompleteness = 0.5f;
+    LidarAssembler assembler(config);
+
+    bool completed = assembler.addPacket(makeChunk(1.0, 0, 4, 100));
+    CHECK(!completed);
+    completed = assembler.addPacket(makeChunk(1.1, 0, 4, 100));   // 25% is not worth drawing
+    CHECK(!completed);
+    CHECK(!assembler.hasCompleteScan());
+    CHECK(assembler.getStaleScans() == 1);
+    std::cout << "  Sparse partial scan discarded: OK\n";
+}
+
+static void testStaleScanExpiry() {
+    LidarAssembler::Config config;
+    config.staleScanTimeoutMs = 1.0;
+    LidarAssembler assembler(config);
+    size_t freeSlots = assembler.getArena().getFreeSlotCount();
+
+    bool completed = assembler.addPacket(makeChunk(1.0, 0, 4, 100));
+    CHECK(!completed);
+    completed = assembler.addPacket(makeChunk(2.0, 0, 1, 100));   // completes, timer cancelled
+    CHECK(completed);
+    bool emitted = assembler.poll();
+    CHECK(!emitted);
+    CHECK(assembler.getPartialScanCount() == 1);
+
+    // Expiry happens on the next poll (or packet) after the timeout
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    emitted = assembler.poll();
+    CHECK(!emitted);
+    CHECK(assembler.getPartialScanCount() == 0);
+    CHECK(assembler.getStaleScans() == 1);
+    emitted = assembler.poll();
+    CHECK(!emitted);
+    CHECK(assembler.getStaleScans() == 1);
+    CHECK(assembler.getArena().getFreeSlotCount() == freeSlots - 1);   // one scan still queued
+    std::cout << "  Stale partial scan expired by timer: OK\n";
+}
+
+int main() {
+    std::cout << "Testing arena-based scan assembly...\n\n";
+
+    testOutOfOrderAssembly();
+    testShortMiddleChunkIsCompacted();
+    testInvalidChunksDropped();
+    testSlotsRecycledWithoutAllocation();
+    testArenaExhaustion();
+    testQueueDropsOldest();
+    testPartialScanDeadline();
+    testPartialScanOnNewerTimestamp();
+    testSparsePartialScanDiscarded();
+    testStaleScanExpiry();
+
+    std::cout << "\n✅ All scan assembly tests passed!\n";
+    return 0;
+}
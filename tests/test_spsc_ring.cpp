@@ -0,0 +1,104 @@
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include "spsc_ring.h"
+#include "test_check.h"
+
+static void testBasicOrder() {
+    SpscRing<uint32_t> ring(3);
+    uint32_t value = 0;
+
+    CHECK(ring.empty() && ring.capacity() == 3);
+    bool popped = ring.pop(value);
+    CHECK(!popped);
+    bool pushed[4] = { ring.push(1), ring.push(2), ring.push(3), ring.push(4) };
+    CHECK(pushed[0] && pushed[1] && pushed[2]);
+    CHECK(!pushed[3]);                          // full, plain push refuses
+    CHECK(ring.size() == 3);
+
+    popped = ring.pop(value);
+    CHECK(popped && value == 1);
+    pushed[0] = ring.push(4);
+    CHECK(pushed[0]);
+    for (uint32_t expected = 2; expected <= 4; ++expected) {
+        popped = ring.pop(value);
+        CHECK(popped && value == expected);
+    }
+    popped = ring.pop(value);
+    CHECK(!popped);
+    std::cout << "  FIFO order and capacity: OK\n";
+}
+
+static void testDropOldest() {
+    SpscRing<uint32_t> ring(2);
+    uint32_t dropped = 0;
+    uint32_t value = 0;
+
+    bool overwrote = ring.pushOverwrite(1, dropped);
+    CHECK(!overwrote);
+    overwrote = ring.pushOverwrite(2, dropped);
+    CHECK(!overwrote);
+    overwrote = ring.pushOverwrite(3, dropped);
+    CHECK(overwrote && dropped == 1);
+    overwrote = ring.pushOverwrite(4, dropped);
+    CHECK(overwrote && dropped == 2);
+    CHECK(ring.size() == 2);
+    bool popped = ring.pop(value);
+    CHECK(popped && value == 3);
+    popped = ring.pop(value);
+    CHECK(popped && value == 4);
+    std::cout << "  Drop-oldest when full: OK\n";
+}
+
+// Producer floods a small ring; every value is either consumed (in order)
+// or reported dropped exactly once
+static void testConcurrentDropOldest() {
+    const uint64_t total = 2000000;
+    SpscRing<uint64_t> ring(8);
+    std::atomic<bool> done(false);
+    uint64_t droppedCount = 0;
+    uint64_t consumedCount = 0;
+
+    std::thread consumer([&]() {
+        uint64_t value = 0;
+        uint64_t last = 0;
+        bool first = true;
+        while (true) {
+            if (ring.pop(value)) {
+                CHECK(first || value > last);
+                last = value;
+                first = false;
+                consumedCount++;
+            } else if (done.load(std::memory_order_acquire) && ring.empty()) {
+                break;
+            }
+        }
+    });
+
+    uint64_t dropped = 0;
+    uint64_t lastDropped = 0;
+    for (uint64_t i = 1; i <= total; ++i) {
+        if (ring.pushOverwrite(i, dropped)) {
+            CHECK(dropped > lastDropped);
+            lastDropped = dropped;
+            droppedCount++;
+        }
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    std::cout << "  Concurrent: consumed " << consumedCount << ", dropped " << droppedCount << "\n";
+    CHECK(consumedCount + droppedCount == total);
+}
+
+int main() {
+    std::cout << "Testing lock-free SPSC ring...\n\n";
+
+    testBasicOrder();
+    testDropOldest();
+    testConcurrentDropOldest();
+
+    std::cout << "\n✅ All SPSC ring tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include "telemetry_monitor.h"
+#include "test_check.h"
+
+// Records every event in order
+class RecordingListener : public TelemetryListener {
+public:
+    struct Change {
+        uint32_t roverId;
+        uint8_t previous;
+        uint8_t current;
+    };
+
+    std::vector<Change> changes;
+    std::vector<uint32_t> linksUp;
+    std::vector<uint32_t> linksLost;
+    uint64_t lastSilentNs = 0;
+
+    void onButtonsChanged(uint32_t roverId, uint8_t previous, uint8_t current, uint64_t) override {
+        changes.push_back({roverId, previous, current});
+    }
+    void onLinkUp(uint32_t roverId) override { linksUp.push_back(roverId); }
+    void onLinkLost(uint32_t roverId, uint64_t silentNs) override {
+        linksLost.push_back(roverId);
+        lastSilentNs = silentNs;
+    }
+};
+
+// Counts what the monitor forwards
+class CountingHandler : public IngestHandler {
+public:
+    size_t telemetry = 0;
+
+    void onTelemetry(uint32_t, const VehicleTelem&, uint64_t) override { telemetry++; }
+};
+
+static VehicleTelem telemetryWith(uint8_t buttons) {
+    VehicleTelem telem;
+    telem.timestamp = 0.0;
+    telem.buttonStates = buttons;
+    return telem;
+}
+
+static void sleepMs(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+static void testChangesOnly() {
+    CountingHandler downstream;
+    TelemetryMonitor monitor(&downstream);
+    RecordingListener listener;
+    monitor.addListener(listener);
+    bool added[2] = { monitor.addRover(2), monitor.addRover(2) };
+    CHECK(added[0] && !added[1]);
+
+    const uint8_t sequence[] = {0x0, 0x0, 0x1, 0x1, 0x1, 0x3, 0x3, 0x0};
+    for (uint8_t buttons : sequence) {
+        monitor.onTelemetry(2, telemetryWith(buttons), 0);
+    }
+    monitor.onTelemetry(5, telemetryWith(0x1), 0);   // Not tracked
+
+    CHECK(listener.linksUp.size() == 1 && listener.linksUp[0] == 2);
+    CHECK(listener.changes.size() == 3);
+    CHECK(listener.changes[0].previous == 0x0 && listener.changes[0].current == 0x1);
+    CHECK(listener.changes[1].previous == 0x1 && listener.changes[1].current == 0x3);
+    CHECK(listener.changes[2].previous == 0x3 && listener.changes[2].current == 0x0);
+    CHECK(monitor.getButtons(2) == 0x0 && monitor.getButtons(5) == 0x0);
+    CHECK(monitor.getStats().packets == 8 && monitor.getStats().buttonChanges == 3);
+    CHECK(monitor.getStats().unknownRoverPackets == 1);
+    CHECK(downstream.telemetry == 9);
+    std::cout << "  Events only when bits change: OK\n";
+}
+
+static void testStaleLink() {
+    TelemetryMonitor::Config config;
+    config.staleTimeoutMs = 20.0;
+    TelemetryMonitor monitor(nullptr, config);
+    RecordingListener listener;
+    monitor.addListener(listener);
+    bool added[2] = { monitor.addRover(1), monitor.addRover(3) };
+    CHECK(added[0] && added[1]);
+    CHECK(!monitor.isLinkUp(1) && monitor.getLinksUp() == 0);
+
+    // Rover 1 keeps reporting, rover 3 goes silent after one packet
+    monitor.onTelemetry(3, telemetryWith(0x4), 0);
+    for (int i = 0; i < 12; ++i) {
+        monitor.onTelemetry(1, telemetryWith(0x0), 0);
+        monitor.poll();
+        sleepMs(5);
+    }
+    monitor.poll();
+    CHECK(listener.linksLost.size() == 1 && listener.linksLost[0] == 3);
+    CHECK(listener.lastSilentNs >= 20000000);
+    CHECK(monitor.isLinkUp(1) && !monitor.isLinkUp(3) && monitor.getLinksUp() == 1);
+    CHECK(monitor.getButtons(3) == 0x4);   // Last known state is kept
+
+    // Reported once, then up again with the next packet
+    monitor.poll();
+    CHECK(listener.linksLost.size() == 1);
+    monitor.onTelemetry(3, telemetryWith(0x4), 0);
+    CHECK(monitor.isLinkUp(3) && monitor.getLinksUp() == 2);
+    CHECK(listener.linksUp.size() == 3 && listener.linksUp[2] == 3);
+    CHECK(listener.changes.size() == 1);   // 0x4 again is no change
+    CHECK(monitor.getStats().linksLost == 1 && monitor.getStats().linksRestored == 1);
+    std::cout << "  Silent links reported once, restored on the next packet: OK\n";
+}
+
+static void testManyRovers() {
+    TelemetryMonitor::Config config;
+    config.staleTimeoutMs = 20.0;
+    config.maxRovers = 500;
+    TelemetryMonitor monitor(nullptr, config);
+    RecordingListener listener;
+    monitor.addListener(listener);
+    for (uint32_t id = 1; id <= 500; ++id) {
+        bool added = monitor.addRover(id);
+        CHECK(added);
+    }
+    bool added = monitor.addRover(501);
+    CHECK(!added);   // maxRovers reached
+    CHECK(monitor.getRoverCount() == 500);
+
+    for (uint32_t id = 1; id <= 500; ++id) {
+        monitor.onTelemetry(id, telemetryWith(static_cast<uint8_t>(id & 0x1)), 0);
+    }
+    CHECK(monitor.getLinksUp() == 500 && listener.changes.size() == 250);
+
+    // Only the odd rovers keep talking
+    for (int i = 0; i < 8; ++i) {
+        sleepMs(5);
+        for (uint32_t id = 1; id <= 500; id += 2) {
+            monitor.onTelemetry(id, telemetryWith(0x1), 0);
+        }
+        monitor.poll();
+    }
+    CHECK(listener.linksLost.size() == 250 && monitor.getLinksUp() == 250);
+    for (uint32_t id : listener.linksLost) {
+        CHECK(id % 2 == 0);
+    }
+    CHECK(listener.changes.size() == 250);
+    std::cout << "  500 rovers, only silent ones reported: OK\n";
+}
+
+int main() {
+    std::cout << "=== Telemetry Monitor Tests ===\n";
+
+    testChangesOnly();
+    testStaleLink();
+    testManyRovers();
+
+    std::cout << "\n✅ All telemetry monitor tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,273 @@
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cstdio>
+#include <unistd.h>
+#include <glm/glm.hpp>
+#include "height_map.h"
+#include "terrain_mesher.h"
+#include "test_check.h"
+
+// n x n cell centres starting at ground (x0, y0), flat at height
+static void insertPatch(HeightMap& map, float x0, float y0, int n, float height) {
+    const float cell = map.getConfig().cellSize;
+    std::vector<glm::vec3> points;
+    for (int j = 0; j < n; ++j) {
+        for (int i = 0; i < n; ++i) {
+            float gx = x0 + (static_cast<float>(i) + 0.5f) * cell;
+            float gy = y0 + (static_cast<float>(j) + 0.5f) * cell;
+            points.push_back(map.getConfig().upAxis == HeightMap::UpAxis::Y
+                             ? glm::vec3(gx, height, gy) : glm::vec3(gx, gy, height));
+        }
+    }
+    map.insert(points);
+}
+
+// Every height change past changeThreshold counts (no noise allowance)
+static HeightMap::Config exactConfig() {
+    HeightMap::Config config;
+    config.changeSigmas = 0.0f;
+    return config;
+}
+
+static TerrainMesher::MeshFrame meshFrame(TerrainMesher& mesher) {
+    TerrainMesher::MeshFrame frame;
+    size_t started = mesher.beginFrame();
+    CHECK(started > 0);
+    mesher.waitIdle();
+    bool taken = mesher.takeFrame(frame);
+    CHECK(taken);
+    return frame;
+}
+
+static glm::vec3 vertexAt(const TerrainMesher::TileMesh& mesh, uint32_t index) {
+    const float* v = &mesh.vertices[index * TerrainMesher::FLOATS_PER_VERTEX];
+    return glm::vec3(v[0], v[1], v[2]);
+}
+
+static void testFlatPatch() {
+    HeightMap map;
+    TerrainMesher mesher(map);
+    mesher.start();
+
+    // 4x4 cells inside one tile: 3x3 quads
+    insertPatch(map, 4.0f, 4.0f, 4, 2.0f);
+    TerrainMesher::MeshFrame frame = meshFrame(mesher);
+    CHECK(frame.tiles.size() == 1 && frame.stats.tilesRebuilt == 1);
+    const TerrainMesher::TileMesh& mesh = frame.tiles[0];
+    CHECK(mesh.indices.size() == 18 * 3);
+    CHECK(mesh.vertices.size() == 16 * TerrainMesher::FLOATS_PER_VERTEX);
+    CHECK(frame.stats.triangles == 18 && frame.stats.vertices == 16);
+
+    for (size_t v = 0; v < mesh.vertices.size(); v += TerrainMesher::FLOATS_PER_VERTEX) {
+        CHECK(mesh.vertices[v + 1] == 2.0f);                     // height on Y
+        CHECK(std::fabs(mesh.vertices[v + 4] - 1.0f) < 1e-6f);   // normal up
+    }
+
+    // Counter-clockwise seen from above
+    for (size_t t = 0; t < mesh.indices.size(); t += 3) {
+        glm::vec3 a = vertexAt(mesh, mesh.indices[t]);
+        glm::vec3 b = vertexAt(mesh, mesh.indices[t + 1]);
+        glm::vec3 c = vertexAt(mesh, mesh.indices[t + 2]);
+        CHECK(glm::cross(b - a, c - a).y > 0.0f);
+    }
+    std::cout << "  Flat patch: indexed triangles, up normals, CCW winding: OK\n";
+}
+
+static void testOnlyDirtyTilesRebuilt() {
+    HeightMap map(exactConfig());
+    TerrainMesher mesher(map);
+    mesher.start();
+
+    insertPatch(map, 4.0f, 4.0f, 8, 0.0f);
+    insertPatch(map, 200.0f, 200.0f, 8, 0.0f);
+    TerrainMesher::MeshFrame frame = meshFrame(mesher);
+    CHECK(frame.stats.tilesRebuilt == 2);
+
+    // Nothing changed: no frame
+    size_t started = mesher.beginFrame();
+    CHECK(started == 0);
+
+    // Touch the far patch only
+    insertPatch(map, 200.0f, 200.0f, 2, 1.0f);
+    frame = meshFrame(mesher);
+    CHECK(frame.tiles.size() == 1);
+    const HeightMap::Tile* tile = map.getTile(frame.tiles[0].tileIndex);
+    CHECK(tile != nullptr && frame.tiles[0].version == tile->version);
+    CHECK(map.tileOrigin(*tile).x <= 200.0f && map.tileOrigin(*tile).x + 32.0f > 200.0f);
+    std::cout << "  Only changed tiles are re-meshed: OK\n";
+}
+
+static void testSeamAcrossTiles() {
+    HeightMap map(exactConfig());
+    TerrainMesher mesher(map);
+    mesher.start();
+
+    // Default map: tiles are 32 units, one boundary at x = 0. Two cells
+    // either side of it form 3 quads per row, all owned by the west tile.
+    insertPatch(map, -1.0f, 4.0f, 4, 0.0f);
+    TerrainMesher::MeshFrame frame = meshFrame(mesher);
+    CHECK(frame.tiles.size() == 2);
+    size_t triangles = 0;
+    for (const auto& mesh : frame.tiles) {
+        triangles += mesh.indices.size() / 3;
+    }
+    CHECK(triangles == 18);
+
+    // Changing only the east tile rebuilds the west one too (its seam quads)
+    insertPatch(map, 0.0f, 4.0f, 1, 5.0f);
+    frame = meshFrame(mesher);
+    CHECK(frame.tiles.size() == 2);
+    std::cout << "  Seams between tiles are meshed once and kept current: OK\n";
+}
+
+static void testDoubleBufferAndDeferral() {
+    HeightMap map;
+    TerrainMesher::Config config;
+    config.workerCount = 3;
+    config.maxTilesPerFrame = 2;
+    TerrainMesher mesher(map, config);
+    mesher.start();
+
+    // Five separate tiles, two per frame
+    for (int i = 0; i < 5; ++i) {
+        insertPatch(map, -400.0f + 100.0f * i, 0.0f, 3, 0.0f);
+    }
+    size_t started = mesher.beginFrame();
+    CHECK(started == 2);
+    mesher.waitIdle();
+
+    // Not collected yet: nothing new starts, nothing is lost
+    started = mesher.beginFrame();
+    CHECK(started == 0);
+    CHECK(mesher.getStats().framesSkipped == 1);
+
+    TerrainMesher::MeshFrame frame;
+    bool taken = mesher.takeFrame(frame);
+    CHECK(taken && frame.stats.tilesDeferred == 3);
+    taken = mesher.takeFrame(frame);
+    CHECK(!taken);
+
+    std::vector<uint32_t> seen;
+    for (const auto& mesh : frame.tiles) seen.push_back(mesh.tileIndex);
+    while (mesher.beginFrame() > 0) {
+        mesher.waitIdle();
+        taken = mesher.takeFrame(frame);
+        CHECK(taken);
+        for (const auto& mesh : frame.tiles) seen.push_back(mesh.tileIndex);
+    }
+    std::sort(seen.begin(), seen.end());
+    bool distinct = std::unique(seen.begin(), seen.end()) == seen.end();
+    CHECK(seen.size() == 5 && distinct);
+    CHECK(mesher.getStats().framesMeshed == 3 && mesher.getStats().tilesRebuilt == 5);
+    std::cout << "  Front/back buffers, per-frame tile limit carries over: OK\n";
+}
+
+static void testZUpWinding() {
+    HeightMap::Config mapConfig;
+    mapConfig.upAxis = HeightMap::UpAxis::Z;
+    HeightMap map(mapConfig);
+    TerrainMesher mesher(map);
+    mesher.start();
+
+    insertPatch(map, 4.0f, 4.0f, 3, 1.0f);
+    TerrainMesher::MeshFrame frame = meshFrame(mesher);
+    const TerrainMesher::TileMesh& mesh = frame.tiles[0];
+    for (size_t t = 0; t < mesh.indices.size(); t += 3) {
+        glm::vec3 a = vertexAt(mesh, mesh.indices[t]);
+        glm::vec3 b = vertexAt(mesh, mesh.indices[t + 1]);
+        glm::vec3 c = vertexAt(mesh, mesh.indices[t + 2]);
+        CHECK(glm::cross(b - a, c - a).z > 0.0f);
+        CHECK(a.z == 1.0f);
+    }
+    std::cout << "  Z-up meshes face +Z: OK\n";
+}
+
+static void testPagedMapMeshesLikeResident() {
+    // 256-cell tiles are over 1 MB each, so the budget is the 4-tile minimum
+    HeightMap::Config config = exactConfig();
+    config.tileCells = 256;
+    config.residentBudgetMB = 1;
+    std::string path = "/tmp/test_terrain_mesher_" + std::to_string(getpid()) + ".tiles";
+    std::remove(path.c_str());
+
+    HeightMap paged(config);
+    bool opened = paged.openStore(path);
+    CHECK(opened);
+    config.residentBudgetMB = 0;
+    HeightMap resident(config);
+
+    // A patch over the corner of four tiles plus scattered hits in others
+    for (HeightMap* map : {&paged, &resident}) {
+        insertPatch(*map, -8.0f, -8.0f, 32, 1.0f);
+        for (float x = -300.0f; x < 300.0f; x += 130.0f) {
+            insertPatch(*map, x, 0.5f * x, 3, 2.0f);
+        }
+    }
+    CHECK(paged.getStats().tilesResident == 4 && paged.getStats().tilesEvicted > 0);
+
+    size_t triangles[2] = {0, 0};
+    size_t tiles[2] = {0, 0};
+    int which = 0;
+    for (HeightMap* map : {&paged, &resident}) {
+        TerrainMesher mesher(*map);
+        mesher.start();
+        TerrainMesher::MeshFrame frame = meshFrame(mesher);
+        tiles[which] = frame.tiles.size();
+        for (const auto& mesh : frame.tiles) {
+            triangles[which] += mesh.indices.size() / 3;
+        }
+        which++;
+    }
+    CHECK(tiles[0] == tiles[1] && triangles[0] == triangles[1] && triangles[0] > 0);
+
+    std::remove(path.c_str());
+    std::cout << "  Paged map (4 resident tiles) meshes like a resident one: OK\n";
+}
+
+static void testLevelsOfDetail() {
+    HeightMap map(exactConfig());
+    TerrainMesher mesher(map);
+    mesher.start();
+
+    // 9x9 cells from cell 48 of tile 15: 8x8 quads, 4x4 of two cells, 2x2 of four
+    insertPatch(map, 4.0f, 4.0f, 9, 2.0f);
+    TerrainMesher::MeshFrame frame = meshFrame(mesher);
+    const TerrainMesher::TileMesh& flat = frame.tiles[0];
+    CHECK(flat.lodIndexCount[0] == 8 * 8 * 6);
+    CHECK(flat.lodIndexCount[1] == 4 * 4 * 6 && flat.lodIndexCount[2] == 2 * 2 * 6);
+    CHECK(flat.lodIndices.size() == flat.lodIndexCount[1] + flat.lodIndexCount[2]);
+    CHECK(flat.lodError[1] == 0.0f && flat.lodError[2] == 0.0f);
+    CHECK(flat.vertices.size() == 81 * TerrainMesher::FLOATS_PER_VERTEX);
+    CHECK(flat.boundsMin.y == 2.0f && flat.boundsMax.y == 2.0f);
+    CHECK(flat.boundsMin.x == 4.25f && flat.boundsMax.x == 8.25f);
+
+    // Raise a cell the first coarse level skips
+    glm::vec3 bump(4.75f, 5.0f, 4.75f);
+    map.insert(&bump, 1);
+    float raised = map.cellAt(4.75f, 4.75f)->meanHeight;
+    frame = meshFrame(mesher);
+    const TerrainMesher::TileMesh& bumpy = frame.tiles[0];
+    CHECK(std::fabs(bumpy.lodError[1] - (raised - 2.0f)) < 1e-5f);
+    CHECK(bumpy.lodError[2] >= bumpy.lodError[1]);
+    CHECK(bumpy.boundsMax.y == raised);
+
+    std::cout << "  Coarser levels share vertices and report their error: OK\n";
+}
+
+int main() {
+    std::cout << "Testing terrain mesher...\n\n";
+
+    testFlatPatch();
+    testOnlyDirtyTilesRebuilt();
+    testSeamAcrossTiles();
+    testDoubleBufferAndDeferral();
+    testZUpWinding();
+    testPagedMapMeshesLikeResident();
+    testLevelsOfDetail();
+
+    std::cout << "\n✅ All terrain mesher tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <iostream>
+#include <vector>
+#include "timer_wheel.h"
+#include "test_check.h"
+
+static const uint64_t MS = 1000000;
+
+static void testFiresInDeadlineOrder() {
+    TimerWheel wheel(8, 16, MS);
+    std::vector<uint32_t> fired;
+    auto collect = [&fired](uint32_t id) { fired.push_back(id); };
+
+    wheel.schedule(0, 5 * MS);
+    wheel.schedule(1, 2 * MS);
+    wheel.schedule(2, 9 * MS);
+    CHECK(wheel.size() == 3);
+
+    size_t expired = wheel.advance(1 * MS, collect);
+    CHECK(expired == 0);
+    expired = wheel.advance(5 * MS, collect);
+    CHECK(expired == 2);
+    CHECK(fired.size() == 2 && fired[0] == 1 && fired[1] == 0);
+    CHECK(!wheel.isScheduled(0) && wheel.isScheduled(2));
+    expired = wheel.advance(9 * MS, collect);
+    CHECK(expired == 1 && fired.back() == 2);
+    CHECK(wheel.size() == 0);
+    std::cout << "  Timers fire at their deadline: OK\n";
+}
+
+static void testRescheduleAndCancel() {
+    TimerWheel wheel(4, 16, MS);
+    size_t fired = 0;
+    auto count = [&fired](uint32_t) { fired++; };
+
+    wheel.schedule(0, 3 * MS);
+    wheel.schedule(1, 3 * MS);
+    wheel.schedule(0, 8 * MS);     // re-armed before expiry
+    wheel.cancel(1);
+    wheel.cancel(1);               // no-op
+    CHECK(wheel.size() == 1);
+
+    size_t expired = wheel.advance(6 * MS, count);
+    CHECK(expired == 0);
+    expired = wheel.advance(8 * MS, count);
+    CHECK(expired == 1 && fired == 1);
+    std::cout << "  Re-schedule and cancel: OK\n";
+}
+
+static void testDeadlinesBeyondOneRevolution() {
+    TimerWheel wheel(2, 8, MS);
+    size_t fired = 0;
+    auto count = [&fired](uint32_t) { fired++; };
+
+    // 8 ms per revolution: the 20 ms timer is passed over twice
+    wheel.schedule(0, 20 * MS);
+    for (uint64_t t = 0; t < 20; ++t) {
+        size_t expired = wheel.advance(t * MS, count);
+        CHECK(expired == 0);
+    }
+    size_t expired = wheel.advance(20 * MS, count);
+    CHECK(expired == 1);
+
+    // A long stall visits each bucket once and still fires everything due
+    wheel.schedule(0, 25 * MS);
+    wheel.schedule(1, 30 * MS);
+    expired = wheel.advance(1000 * MS, count);
+    CHECK(expired == 2 && fired == 3);
+    std::cout << "  Deadlines beyond one revolution: OK\n";
+}
+
+static void testPastDeadlineFiresNextAdvance() {
+    TimerWheel wheel(2, 8, MS);
+    size_t fired = 0;
+    auto count = [&fired](uint32_t) { fired++; };
+
+    size_t expired = wheel.advance(50 * MS, count);
+    CHECK(expired == 0);
+    wheel.schedule(0, 10 * MS);    // already overdue
+    expired = wheel.advance(51 * MS, count);
+    CHECK(expired == 1 && fired == 1);
+    std::cout << "  Overdue timer fires on next advance: OK\n";
+}
+
+static void testDeadlineInsideVisitedTick() {
+    TimerWheel wheel(4, 8, 10);
+    size_t fired = 0;
+    auto count = [&fired](uint32_t) { fired++; };
+
+    // The 105 ns timer's tick (100..109) is reached at 101, before it is due
+    wheel.schedule(1, 105);
+    size_t expired = wheel.advance(101, count);
+    CHECK(expired == 0);
+    expired = wheel.advance(120, count);
+    CHECK(expired == 1 && fired == 1);   // Not a revolution later
+    std::cout << "  Deadline inside an already visited tick: OK\n";
+}
+
+static void testCallbackMayReschedule() {
+    TimerWheel wheel(1, 8, MS);
+    size_t fired = 0;
+
+    wheel.schedule(0, 1 * MS);
+    for (uint64_t t = 1; t <= 10; ++t) {
+        wheel.advance(t * MS, [&](uint32_t id) {
+            fired++;
+            wheel.schedule(id, (t + 1) * MS);
+        });
+    }
+    CHECK(fired == 10 && wheel.isScheduled(0));
+    std::cout << "  Callback may re-arm its own timer: OK\n";
+}
+
+int main() {
+    std::cout << "Testing hashed timer wheel...\n\n";
+
+    testFiresInDeadlineOrder();
+    testRescheduleAndCancel();
+    testDeadlinesBeyondOneRevolution();
+    testPastDeadlineFiresNextAdvance();
+    testDeadlineInsideVisitedTick();
+    testCallbackMayReschedule();
+
+    std::cout << "\n✅ All timer wheel tests passed!\n";
+    return 0;
+}
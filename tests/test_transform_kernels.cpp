@@ -0,0 +1,86 @@
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include "transform_kernels.h"
+#include "udp_packet_structures.h"
+#include "test_check.h"
+
+// Rotation about Z by 30 degrees plus a translation
+static AffineTransform makeTransform() {
+    const float c = std::cos(0.5235988f), s = std::sin(0.5235988f);
+    AffineTransform t;
+    t.m[0][0] = c;    t.m[0][1] = -s;   t.m[0][2] = 0.0f; t.m[0][3] = 10.0f;
+    t.m[1][0] = s;    t.m[1][1] = c;    t.m[1][2] = 0.0f; t.m[1][3] = -5.0f;
+    t.m[2][0] = 0.0f; t.m[2][1] = 0.0f; t.m[2][2] = 1.0f; t.m[2][3] = 2.5f;
+    return t;
+}
+
+static std::vector<LidarPoint> makePoints(size_t count) {
+    std::vector<LidarPoint> points(count);
+    for (size_t i = 0; i < count; ++i) {
+        float f = static_cast<float>(i);
+        points[i] = { f * 0.5f, 100.0f - f, std::sin(f) * 3.0f };
+    }
+    return points;
+}
+
+static LidarPoint reference(const AffineTransform& t, const LidarPoint& p) {
+    LidarPoint w;
+    w.x = t.m[0][0] * p.x + t.m[0][1] * p.y + t.m[0][2] * p.z + t.m[0][3];
+    w.y = t.m[1][0] * p.x + t.m[1][1] * p.y + t.m[1][2] * p.z + t.m[1][3];
+    w.z = t.m[2][0] * p.x + t.m[2][1] * p.y + t.m[2][2] * p.z + t.m[2][3];
+    return w;
+}
+
+static bool near(float a, float b) {
+    return std::fabs(a - b) <= 1e-4f * std::fmax(1.0f, std::fabs(a));
+}
+
+static void testLevel(SimdLevel level) {
+    AffineTransform t = makeTransform();
+
+    // Sizes around the 4- and 8-point step boundaries
+    for (size_t count : {0u, 1u, 3u, 4u, 7u, 8u, 9u, 15u, 16u, 17u, 1000u, 1003u}) {
+        std::vector<LidarPoint> in = makePoints(count);
+        std::vector<LidarPoint> out(count);
+        std::vector<float> x(count), y(count), z(count);
+
+        transformPoints(t, in.data(), count, out.data(), level);
+        transformPointsSoA(t, in.data(), count, x.data(), y.data(), z.data(), level);
+
+        for (size_t i = 0; i < count; ++i) {
+            LidarPoint w = reference(t, in[i]);
+            CHECK(near(out[i].x, w.x) && near(out[i].y, w.y) && near(out[i].z, w.z));
+            CHECK(near(x[i], w.x) && near(y[i], w.y) && near(z[i], w.z));
+        }
+
+        // In place
+        transformPoints(t, in.data(), count, in.data(), level);
+        for (size_t i = 0; i < count; ++i) {
+            CHECK(in[i].x == out[i].x && in[i].y == out[i].y && in[i].z == out[i].z);
+        }
+    }
+    std::cout << "  " << simdLevelName(level) << " kernel matches reference: OK\n";
+}
+
+static void testIdentity() {
+    std::vector<LidarPoint> in = makePoints(37);
+    std::vector<LidarPoint> out(in.size());
+    transformPoints(AffineTransform(), in.data(), in.size(), out.data());
+    for (size_t i = 0; i < in.size(); ++i) {
+        CHECK(out[i].x == in[i].x && out[i].y == in[i].y && out[i].z == in[i].z);
+    }
+    std::cout << "  Identity (dispatched " << simdLevelName(detectSimdLevel()) << "): OK\n";
+}
+
+int main() {
+    std::cout << "Testing batch transform kernels...\n\n";
+
+    testLevel(SimdLevel::Scalar);
+    testLevel(SimdLevel::SSE);
+    testLevel(SimdLevel::AVX2);
+    testIdentity();
+
+    std::cout << "\n✅ All transform kernel tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <glm/glm.hpp>
+#include "voxel_map.h"
+#include "test_check.h"
+
+static bool near(float a, float b) {
+    return std::fabs(a - b) < 1e-4f;
+}
+
+// Log-odds as stored (quantised to 1/LOG_ODDS_SCALE)
+static float stored(float logOdds) {
+    return std::round(logOdds * VoxelMap::LOG_ODDS_SCALE) / VoxelMap::LOG_ODDS_SCALE;
+}
+
+static void testLogOddsAndClamp() {
+    VoxelMap map;
+    const VoxelMap::Config& config = map.getConfig();
+
+    glm::vec3 p(1.05f, -0.35f, -2.01f);   // negative coordinates floor correctly
+    size_t inserted = map.insert(&p, 1);
+    CHECK(inserted == 1);
+    CHECK(near(map.getLogOdds(p), stored(config.hitLogOdds)));
+    CHECK(map.isOccupied(p));
+    CHECK(map.getLogOdds(glm::vec3(1.05f, -0.15f, -2.01f)) == 0.0f);   // neighbour above
+    CHECK(!map.isOccupied(glm::vec3(-1.05f, -0.35f, -2.01f)));
+
+    for (int i = 0; i < 20; ++i) {
+        map.insert(&p, 1);
+    }
+    CHECK(near(map.getLogOdds(p), stored(config.maxLogOdds)));
+
+    for (int i = 0; i < 20; ++i) {
+        map.insertMisses(&p, 1);
+    }
+    CHECK(near(map.getLogOdds(p), stored(config.minLogOdds)));
+    CHECK(!map.isOccupied(p));
+    std::cout << "  Log-odds hits, misses and clamping: OK\n";
+}
+
+static void testLevelsOfDetail() {
+    VoxelMap map;
+    CHECK(map.getLevelCount() == 3);
+    CHECK(near(map.getVoxelSize(2), 0.8f));
+
+    // Two voxels sharing a level 1 parent: (0,0,0) and (1,0,0) at 0.2
+    glm::vec3 a(0.1f, 0.1f, 0.1f), b(0.3f, 0.1f, 0.1f);
+    map.insert(&a, 1);
+    map.insert(&b, 1);
+    map.insert(&b, 1);
+    const float hit = stored(map.getConfig().hitLogOdds);
+    CHECK(near(map.getLogOdds(a, 1), 2.0f * hit));   // max of children
+    CHECK(near(map.getLogOdds(a, 2), 2.0f * hit));
+    CHECK(map.isOccupied(glm::vec3(0.7f, 0.7f, 0.7f), 2));   // same 0.8 voxel
+
+    // Lowering the max child lowers the parents to the next child
+    for (int i = 0; i < 10; ++i) {
+        map.insertMisses(&b, 1);
+    }
+    CHECK(near(map.getLogOdds(a, 1), hit));
+    CHECK(near(map.getLogOdds(a, 2), hit));
+
+    // Clearing the last occupied child leaves the parent unoccupied
+    for (int i = 0; i < 10; ++i) {
+        map.insertMisses(&a, 1);
+    }
+    CHECK(!map.isOccupied(a, 1) && !map.isOccupied(a, 2));
+    std::cout << "  Coarse levels track the max of their children: OK\n";
+}
+
+static void testHashGrowth() {
+    VoxelMap::Config config;
+    config.initialBlocks = 4;
+    VoxelMap map(config);
+
+    // One point per block (1.6 units apart at 0.2 voxels) forces several rehashes
+    std::vector<glm::vec3> points;
+    for (int x = -10; x < 10; ++x) {
+        for (int z = -10; z < 10; ++z) {
+            points.push_back(glm::vec3(x * 1.6f + 0.1f, 0.1f, z * 1.6f + 0.1f));
+        }
+    }
+    size_t inserted = map.insert(points);
+    CHECK(inserted == points.size());
+    CHECK(map.getBlockCount(0) == points.size());
+    for (const glm::vec3& p : points) {
+        CHECK(map.isOccupied(p));
+    }
+
+    size_t occupied = 0;
+    map.forEachOccupied(0, [&](const glm::vec3& center, float size, float logOdds) {
+        CHECK(near(size, 0.2f) && logOdds > 0.0f);
+        CHECK(map.isOccupied(center));
+        occupied++;
+    });
+    CHECK(occupied == points.size());
+    std::cout << "  Hash table grows and keeps every block: OK\n";
+}
+
+static void testRejectsAndClear() {
+    VoxelMap map;
+    std::vector<glm::vec3> points = {
+        glm::vec3(NAN, 0.0f, 0.0f), glm::vec3(0.0f, 1e9f, 0.0f), glm::vec3(2.0f, 2.0f, 2.0f)
+    };
+    size_t inserted = map.insert(points);
+    CHECK(inserted == 1);
+    CHECK(map.getStats().pointsRejected == 2);
+    CHECK(map.getStats().memoryBytes > 0);
+
+    map.clear();
+    CHECK(map.getBlockCount(0) == 0 && map.getBlockCount(2) == 0);
+    CHECK(!map.isOccupied(points[2]));
+    map.insert(points);
+    CHECK(map.isOccupied(points[2]));
+    std::cout << "  Invalid points rejected, clear() resets: OK\n";
+}
+
+int main() {
+    std::cout << "Testing sparse voxel map...\n\n";
+
+    testLogOddsAndClamp();
+    testLevelsOfDetail();
+    testHashGrowth();
+    testRejectsAndClear();
+
+    std::cout << "\n✅ All voxel map tests passed!\n";
+    return 0;
+}